@@ -0,0 +1,104 @@
+#!/usr/bin/env bash
+#
+# Scan throughput benchmark for the NATS JetStream extension.
+#
+# Reloads the telemetry and telemetry_proto streams with a fixed volume of generated data,
+# then runs raw payload, JSON extraction and protobuf extraction scans and reports their
+# throughput from nats_scan_stats(). Each scan runs BENCH_RUNS times and the fastest run
+# is reported.
+#
+# Requires a running NATS server with the streams created (make setup-streams), the nats
+# CLI, duckdb and a release build of the extension.
+#
+# Settings (environment variables):
+#   BENCH_HOURS          Hours of JSON telemetry to generate (default 24)
+#   BENCH_INTERVAL       Seconds between readings of each device (default 5)
+#   BENCH_PROTO_ROUNDS   Protobuf messages per device (default 10000)
+#   BENCH_RUNS           Runs of each scan (default 3)
+#   BENCH_SKIP_DATA      Set to 1 to reuse the data of a previous run
+
+set -e
+
+SCRIPT_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+PROJECT_ROOT="$( cd "$SCRIPT_DIR/.." && pwd )"
+
+NATS_URL="nats://localhost:4222"
+EXTENSION="build/release/nats_js.duckdb_extension"
+
+BENCH_HOURS="${BENCH_HOURS:-24}"
+BENCH_INTERVAL="${BENCH_INTERVAL:-5}"
+BENCH_PROTO_ROUNDS="${BENCH_PROTO_ROUNDS:-10000}"
+BENCH_RUNS="${BENCH_RUNS:-3}"
+BENCH_SKIP_DATA="${BENCH_SKIP_DATA:-0}"
+
+cd "$PROJECT_ROOT"
+
+for tool in duckdb nats python3; do
+    command -v "$tool" >/dev/null 2>&1 || {
+        echo "Error: $tool is required but not installed"
+        exit 1
+    }
+done
+
+if [ ! -f "$EXTENSION" ]; then
+    echo "Error: $EXTENSION not found. Build it with: make release"
+    exit 1
+fi
+
+if [ "$BENCH_SKIP_DATA" != "1" ]; then
+    echo "Reloading benchmark data..."
+    nats stream purge telemetry --force --server="${NATS_URL}" > /dev/null
+    nats stream purge environmental --force --server="${NATS_URL}" > /dev/null
+    nats stream purge telemetry_proto --force --server="${NATS_URL}" > /dev/null
+
+    echo "  - JSON telemetry: ${BENCH_HOURS} hours at ${BENCH_INTERVAL} second intervals"
+    python3 scripts/generate-telemetry.py --hours "$BENCH_HOURS" --interval "$BENCH_INTERVAL" \
+        --historical-only > /dev/null
+    echo "  - Protobuf telemetry: ${BENCH_PROTO_ROUNDS} messages per device"
+    python3 test/proto/generate_protobuf_data.py --rounds "$BENCH_PROTO_ROUNDS" > /dev/null
+fi
+
+# Each scan aggregates its extracted columns so every message is fully decoded, and the
+# statement after it records the scan's counters
+RAW_SCAN="SELECT count(*), sum(octet_length(payload)) FROM nats_scan('telemetry');"
+JSON_SCAN="SELECT count(*), sum(kw), sum(voltage), count(DISTINCT device_id) FROM nats_scan('telemetry',
+    json_extract := {'device_id': 'VARCHAR', 'kw': 'DOUBLE', 'voltage': 'DOUBLE', 'meter.serial': 'BIGINT'});"
+PROTO_SCAN="SELECT count(*), sum(metrics_kw), count(DISTINCT device_id) FROM nats_scan('telemetry_proto',
+    proto_file := 'test/proto/telemetry.proto',
+    proto_message := 'Telemetry',
+    proto_extract := ['device_id', 'timestamp', 'metrics.kw', 'metrics.voltage']);"
+
+SQL="LOAD '${EXTENSION}';
+CREATE TABLE bench AS SELECT '' AS scan, * FROM nats_scan_stats() LIMIT 0;
+"
+for run in $(seq "$BENCH_RUNS"); do
+    for scan in raw json protobuf; do
+        case "$scan" in
+            raw) query="$RAW_SCAN" ;;
+            json) query="$JSON_SCAN" ;;
+            protobuf) query="$PROTO_SCAN" ;;
+        esac
+        SQL+="${query}
+INSERT INTO bench SELECT '${scan}', * FROM nats_scan_stats() ORDER BY scan_id DESC LIMIT 1;
+"
+    done
+done
+SQL+="
+.print Scan throughput (fastest of ${BENCH_RUNS} runs)
+SELECT scan, rows AS messages, round(bytes_received / 1e6, 1) AS mb,
+    round(rows / (elapsed_ms / 1e3)) AS msgs_per_sec,
+    round(bytes_received / 1e6 / (elapsed_ms / 1e3), 1) AS mb_per_sec,
+    round(elapsed_ms, 1) AS elapsed_ms, round(fetch_ms, 1) AS fetch_ms, round(decode_ms, 1) AS decode_ms,
+    round_trips
+FROM bench
+QUALIFY row_number() OVER (PARTITION BY scan ORDER BY elapsed_ms) = 1
+ORDER BY CASE scan WHEN 'raw' THEN 1 WHEN 'json' THEN 2 ELSE 3 END;
+"
+
+echo "Running scans..."
+echo "$SQL" | duckdb -unsigned :memory: > /tmp/nats_benchmark_scans.log 2>&1 || {
+    echo "Error: benchmark failed, see /tmp/nats_benchmark_scans.log"
+    tail -n 20 /tmp/nats_benchmark_scans.log
+    exit 1
+}
+sed -n '/^Scan throughput/,$p' /tmp/nats_benchmark_scans.log
@@ -6,7 +6,9 @@ This script generates realistic power monitoring and environmental sensor data
 that mimics real-world datacenter telemetry patterns.
 """
 
+import argparse
 import asyncio
+import gzip
 import json
 import random
 import sys
@@ -20,6 +22,13 @@ except ImportError:
     print("Error: nats-py library not found. Install with: pip install nats-py")
     sys.exit(1)
 
+try:
+    import lz4.frame
+    import zstandard
+except ImportError:
+    print("Error: compression libraries not found. Install with: pip install -r requirements.txt")
+    sys.exit(1)
+
 
 class TelemetryGenerator:
     """Generates synthetic telemetry data for testing."""
@@ -31,11 +40,11 @@ class TelemetryGenerator:
         
         # Device configurations
         self.power_meters = [
-            {"id": "pm5560-001", "zone": "zone-a", "capacity_kw": 100},
-            {"id": "pm5560-002", "zone": "zone-a", "capacity_kw": 100},
-            {"id": "pm5560-003", "zone": "zone-b", "capacity_kw": 150},
-            {"id": "pm5560-004", "zone": "zone-b", "capacity_kw": 150},
-            {"id": "pm5560-005", "zone": "zone-c", "capacity_kw": 200},
+            {"id": "pm5560-001", "zone": "zone-a", "capacity_kw": 100, "serial": 9007199254740993},
+            {"id": "pm5560-002", "zone": "zone-a", "capacity_kw": 100, "serial": 9007199254740994},
+            {"id": "pm5560-003", "zone": "zone-b", "capacity_kw": 150, "serial": 9007199254740995},
+            {"id": "pm5560-004", "zone": "zone-b", "capacity_kw": 150, "serial": 9007199254740996},
+            {"id": "pm5560-005", "zone": "zone-c", "capacity_kw": 200, "serial": 9007199254740997},
         ]
         
         self.temp_sensors = [
@@ -99,6 +108,11 @@ class TelemetryGenerator:
             "voltage": round(voltage, 1),
             "current": round(current, 1),
             "frequency": round(60.0 + random.uniform(-0.1, 0.1), 2),
+            # Nested object; serial numbers exceed 2^53 to exercise int64 precision
+            "meter": {
+                "serial": meter["serial"],
+                "capacity_kw": meter["capacity_kw"],
+            },
         }
     
     def generate_temp_reading(self, sensor: Dict[str, Any], timestamp: datetime) -> Dict[str, Any]:
@@ -179,6 +193,63 @@ class TelemetryGenerator:
         
         print(f"Complete! Published {message_count} total messages")
     
+    async def generate_sparse_data(self, devices: int = 20, rounds: int = 10):
+        """Generate a stream with deletion gaps for gap-skipping tests.
+
+        The sparse stream keeps one message per subject, so every republish deletes
+        the previous message of that device. Devices with an index divisible by 4
+        only report in the first round, leaving a few live messages at the start of
+        the stream followed by a long run of deleted sequences.
+        """
+        message_count = 0
+        for round_index in range(rounds):
+            for device in range(devices):
+                if device % 4 == 0 and round_index > 0:
+                    continue
+                reading = {"device": device, "round": round_index}
+                await self.js.publish(f"sparse.device.{device}", json.dumps(reading).encode())
+                message_count += 1
+
+        print(f"Complete! Published {message_count} sparse messages")
+
+    async def generate_header_data(self, count: int = 100):
+        """Generate audit events that carry their routing key and trace ID in headers."""
+        for index in range(count):
+            region = "eu" if index % 2 == 0 else "us"
+            headers = {
+                "Trace-Id": f"trace-{index:04d}",
+                "Routing-Key": f"audit.{region}",
+                "Nats-Msg-Id": f"audit-event-{index}",
+            }
+            event = {"event": index, "region": region}
+            await self.js.publish(f"events.audit.{region}", json.dumps(event).encode(), headers=headers)
+
+        print(f"Complete! Published {count} events with headers")
+
+    async def generate_compressed_data(self, count: int = 100):
+        """Generate JSON events compressed by the producer, cycling through the codecs.
+
+        zstd payloads name their codec in a Content-Encoding header; gzip and lz4 payloads
+        are only recognizable by their magic bytes; every fourth payload is uncompressed.
+        """
+        zstd = zstandard.ZstdCompressor()
+        codecs = ["zstd", "gzip", "lz4", "none"]
+        for index in range(count):
+            codec = codecs[index % len(codecs)]
+            event = {"event": index, "codec": codec, "text": "compressible " * 20}
+            payload = json.dumps(event).encode()
+            headers = None
+            if codec == "zstd":
+                payload = zstd.compress(payload)
+                headers = {"Content-Encoding": "zstd"}
+            elif codec == "gzip":
+                payload = gzip.compress(payload)
+            elif codec == "lz4":
+                payload = lz4.frame.compress(payload)
+            await self.js.publish(f"compressed.events.{codec}", payload, headers=headers)
+
+        print(f"Complete! Published {count} compressed events")
+
     async def generate_realtime_data(self, duration_seconds: int = 60, interval_seconds: int = 5):
         """Generate real-time data for testing live scenarios."""
         print(f"Generating real-time data for {duration_seconds} seconds...")
@@ -208,14 +279,34 @@ class TelemetryGenerator:
 
 async def main():
     """Main entry point."""
+    parser = argparse.ArgumentParser(description="Generate synthetic telemetry data")
+    parser.add_argument("--hours", type=int, default=1, help="Hours of historical data (default 1)")
+    parser.add_argument("--interval", type=int, default=60,
+                        help="Seconds between historical readings (default 60)")
+    parser.add_argument("--historical-only", action="store_true",
+                        help="Only generate historical telemetry and environmental data")
+    args = parser.parse_args()
+
     generator = TelemetryGenerator()
     
     try:
         await generator.connect()
         
-        # Generate 1 hour of historical data at 1-minute intervals for initial testing
+        # Generate 1 hour of historical data at 1-minute intervals by default for initial testing
         print("\n=== Generating Historical Data ===")
-        await generator.generate_historical_data(hours=1, interval_seconds=60)
+        await generator.generate_historical_data(hours=args.hours, interval_seconds=args.interval)
+
+        if args.historical_only:
+            return
+
+        print("\n=== Generating Sparse Data ===")
+        await generator.generate_sparse_data()
+
+        print("\n=== Generating Events with Headers ===")
+        await generator.generate_header_data()
+
+        print("\n=== Generating Compressed Events ===")
+        await generator.generate_compressed_data()
         
         print("\n=== Data Generation Complete ===")
         print("\nYou can now query the data using:")
@@ -74,6 +74,58 @@ nats stream add events \
 
 echo "Created stream: events"
 
+# Create sparse stream keeping only the latest message per subject (deletion gaps)
+nats stream add sparse \
+  --subjects "sparse.>" \
+  --storage file \
+  --retention limits \
+  --max-msgs=-1 \
+  --max-msgs-per-subject=1 \
+  --max-bytes=-1 \
+  --max-age=7d \
+  --max-msg-size=1048576 \
+  --discard old \
+  --dupe-window=2m \
+  --replicas=1 \
+  --server="${NATS_URL}" \
+  --defaults
+
+echo "Created stream: sparse"
+
+# Create compressed stream for payloads compressed by the producer
+nats stream add compressed \
+  --subjects "compressed.>" \
+  --storage file \
+  --retention limits \
+  --max-msgs=-1 \
+  --max-bytes=-1 \
+  --max-age=7d \
+  --max-msg-size=1048576 \
+  --discard old \
+  --dupe-window=2m \
+  --replicas=1 \
+  --server="${NATS_URL}" \
+  --defaults
+
+echo "Created stream: compressed"
+
+# Create published stream for COPY ... TO (FORMAT nats)
+nats stream add published \
+  --subjects "published.>" \
+  --storage file \
+  --retention limits \
+  --max-msgs=-1 \
+  --max-bytes=-1 \
+  --max-age=7d \
+  --max-msg-size=1048576 \
+  --discard old \
+  --dupe-window=2m \
+  --replicas=1 \
+  --server="${NATS_URL}" \
+  --defaults
+
+echo "Created stream: published"
+
 # Create test consumers
 echo "Creating test consumers..."
 
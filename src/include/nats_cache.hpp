@@ -0,0 +1,93 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "nats_fetch.hpp"
+
+namespace duckdb {
+
+// Name of the setting that enables the segment cache
+static constexpr const char *NATS_CACHE_DIRECTORY_SETTING = "nats_cache_directory";
+
+// A cached sequence range [start_seq, end_seq] of a stream. The segment file holds every
+// message of the range that matches the cache's subject filter; sequences without a
+// message in the file were deleted or did not match when the range was fetched.
+struct NatsCachedSegment {
+    uint64_t start_seq = 0;
+    uint64_t end_seq = 0;
+    string path;
+};
+
+// The cached segments of one stream for one subject filter. Segments are kept under
+// <cache directory>/<stream>-<creation time>/<subject filter>/, so a recreated stream
+// starts with an empty cache. Only sequences up to last_seq (the stream's last sequence
+// when the scan started) are ever cached, as later ones may not have been stored yet.
+// Stored history is assumed immutable: messages deleted after they were cached are still
+// returned from the cache. Shared by the threads of a scan.
+class NatsStreamCache {
+public:
+    NatsStreamCache(const string &cache_directory, const string &stream_name, int64_t created_ns,
+                    const string &subject_filter, uint64_t last_seq);
+
+    uint64_t LastSeq() const {
+        return last_seq;
+    }
+
+    // Find a segment covering seq. Returns false if seq is not cached.
+    bool FindSegment(uint64_t seq, NatsCachedSegment &segment);
+    // First cached sequence after seq, or UINT64_MAX if nothing after it is cached
+    uint64_t NextCachedSeq(uint64_t seq);
+
+    // Write the serialized messages of [start_seq, end_seq] as a new segment. Failures to
+    // write leave the range uncached rather than failing the scan.
+    void AddSegment(uint64_t start_seq, uint64_t end_seq, const string &records);
+    // Forget a segment whose file can no longer be read
+    void RemoveSegment(const NatsCachedSegment &segment);
+
+private:
+    mutex lock;
+    string directory;
+    uint64_t last_seq;
+    vector<NatsCachedSegment> segments;
+};
+
+// A fetcher's use of a stream cache: the segment it is reading from, loaded into memory
+// once, and the segment it is filling with messages fetched from the server. The filled
+// segment is written when the fetched range stops being contiguous, when it reaches
+// NATS_CACHE_SEGMENT_BYTES, and when the session ends.
+class NatsCacheSession {
+public:
+    explicit NatsCacheSession(NatsStreamCache &cache);
+    ~NatsCacheSession();
+
+    NatsCacheSession(const NatsCacheSession &) = delete;
+    NatsCacheSession &operator=(const NatsCacheSession &) = delete;
+
+    NatsStreamCache &cache;
+
+    // If next_seq is cached, append up to max_msgs cached messages with sequences in
+    // [next_seq, end_seq] to out and advance next_seq past them. Returns false, without
+    // reading anything, if next_seq is not cached.
+    bool Read(uint64_t &next_seq, uint64_t end_seq, idx_t max_msgs, vector<NatsFetchedMessage> &out);
+
+    // Record that the server returned messages for the range [start_seq, end_seq]
+    void Write(uint64_t start_seq, uint64_t end_seq, const NatsFetchedMessage *messages, idx_t count);
+
+private:
+    bool Load(const NatsCachedSegment &segment);
+    NatsFetchedMessage CreateMessage(idx_t offset) const;
+    void Flush();
+
+    // Segment being read: its file contents and the offset of each message by sequence
+    bool loaded = false;
+    NatsCachedSegment segment;
+    string data;
+    vector<std::pair<uint64_t, idx_t>> index;
+
+    // Segment being filled
+    bool filling = false;
+    uint64_t fill_start = 0;
+    uint64_t fill_end = 0;
+    string records;
+};
+
+} // namespace duckdb
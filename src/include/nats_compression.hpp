@@ -0,0 +1,87 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <nats/nats.h>
+
+struct ZSTD_DCtx_s;
+struct LZ4F_dctx_s;
+struct z_stream_s;
+
+namespace duckdb {
+
+// How payloads are compressed, as set by the compression parameter
+enum class NatsCompression : uint8_t {
+    NONE,    // Payloads are read as stored
+    AUTO,    // Detected per message from the Content-Encoding header or the payload's magic bytes
+    ZSTD,    // Zstandard frames
+    LZ4,     // LZ4 frames
+    GZIP,    // gzip members
+    SNAPPY   // Snappy framing format, or a raw Snappy block
+};
+
+// Header that names the codec of a compressed payload in auto mode (e.g. "Content-Encoding: zstd")
+static constexpr const char *NATS_CONTENT_ENCODING_HEADER = "Content-Encoding";
+
+// Decompressed payloads larger than this are rejected rather than buffered
+static constexpr idx_t NATS_MAX_DECOMPRESSED_BYTES = 256ULL * 1024 * 1024;
+
+// Parse the compression parameter ('none', 'auto', 'zstd', 'lz4', 'gzip' or 'snappy'). Throws
+// on other names.
+NatsCompression ParseNatsCompression(const string &name);
+
+const char *NatsCompressionName(NatsCompression compression);
+
+// The codec to decompress a message's payload with under the compression setting: the
+// setting itself for a named codec, and for AUTO the codec named by the Content-Encoding
+// header, or else the codec whose magic bytes the payload starts with. NONE means the
+// payload is read as stored.
+NatsCompression NatsDetectCompression(NatsCompression setting, natsMsg *msg, const char *data, idx_t len);
+
+// Per-thread payload decompressor. Payloads are decompressed into a reusable buffer, and the
+// codec contexts are kept across messages, so decompression does not allocate once the
+// buffer has grown to fit the largest payload seen.
+class NatsDecompressor {
+public:
+    NatsDecompressor() = default;
+    ~NatsDecompressor();
+
+    NatsDecompressor(const NatsDecompressor &) = delete;
+    NatsDecompressor &operator=(const NatsDecompressor &) = delete;
+
+    // Decompress a payload with codec (not NONE or AUTO). Returns false if it is corrupt,
+    // truncated or larger than NATS_MAX_DECOMPRESSED_BYTES, with the reason in Error().
+    // The decompressed payload stays valid until the next call.
+    bool Decompress(NatsCompression codec, const char *data, idx_t len);
+
+    const char *Data() const {
+        return reinterpret_cast<const char *>(buffer.get());
+    }
+    idx_t Size() const {
+        return size;
+    }
+    const string &Error() const {
+        return error;
+    }
+
+private:
+    bool DecompressZstd(const char *data, idx_t len);
+    bool DecompressLz4(const char *data, idx_t len);
+    bool DecompressGzip(const char *data, idx_t len);
+    bool DecompressSnappy(const char *data, idx_t len);
+    bool DecompressSnappyFrames(const char *data, idx_t len);
+
+    // Grow the buffer to hold at least capacity bytes, keeping the decompressed bytes so far
+    bool Reserve(idx_t capacity);
+    bool Fail(string message);
+
+    unsafe_unique_array<data_t> buffer;
+    idx_t buffer_size = 0;
+    idx_t size = 0;
+    string error;
+
+    ZSTD_DCtx_s *zstd_ctx = nullptr;
+    LZ4F_dctx_s *lz4_ctx = nullptr;
+    z_stream_s *zlib_stream = nullptr;
+};
+
+} // namespace duckdb
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include <nats/nats.h>
+#include <chrono>
+
+namespace duckdb {
+
+class ExtensionLoader;
+
+// Open a NATS connection and JetStream context for a URL. Throws on failure.
+void NatsConnect(const string &url, natsConnection **conn, jsCtx **js);
+
+// Counters reported by nats_pool_stats() for one pool key
+struct NatsPoolStats {
+    string url;
+    uint64_t hits = 0;       // Borrows served by an idle pooled connection
+    uint64_t misses = 0;     // Borrows that had to dial a new connection
+    uint64_t evictions = 0;  // Pooled connections closed as idle too long or unhealthy
+    uint64_t active = 0;     // Connections currently borrowed
+    uint64_t idle = 0;       // Connections waiting in the pool
+};
+
+// Connections shared by all scans of a DuckDB instance, keyed by server URL.
+// Lives in the instance's object cache, so it is closed with the database.
+// Idle connections are health checked before reuse (with a PING round trip once they have
+// been idle for a few seconds) and closed after NATS_POOL_IDLE_TIMEOUT of inactivity.
+class NatsConnectionPool : public ObjectCacheEntry {
+public:
+    ~NatsConnectionPool() override;
+
+    static shared_ptr<NatsConnectionPool> Get(ClientContext &context);
+
+    // Borrow a connection for url, dialing a new one when no healthy idle connection is available
+    void Acquire(const string &url, natsConnection *&conn, jsCtx *&js);
+    // Return a borrowed connection. Connections that are no longer connected are closed.
+    void Release(const string &url, natsConnection *conn, jsCtx *js);
+
+    vector<NatsPoolStats> GetStats();
+
+    static string ObjectType() {
+        return "nats_js_connection_pool";
+    }
+    string GetObjectType() override {
+        return ObjectType();
+    }
+
+private:
+    struct IdleConnection {
+        natsConnection *conn;
+        jsCtx *js;
+        std::chrono::steady_clock::time_point idle_since;
+    };
+    struct PoolEntry {
+        vector<IdleConnection> idle;  // Most recently returned last
+        NatsPoolStats stats;
+    };
+
+    // Remove connections that have been idle for too long, moving them to closed so the
+    // caller can close them once it has released the lock. Must hold lock.
+    void EvictIdle(std::chrono::steady_clock::time_point now, vector<IdleConnection> &closed);
+    // Close connections removed from the pool. Must not hold lock.
+    static void CloseConnections(vector<IdleConnection> &closed);
+
+    mutex lock;
+    map<string, PoolEntry> entries;
+};
+
+// A connection borrowed from the pool for the lifetime of the lease
+class NatsConnectionLease {
+public:
+    NatsConnectionLease(ClientContext &context, string url);
+    ~NatsConnectionLease();
+
+    NatsConnectionLease(const NatsConnectionLease &) = delete;
+    NatsConnectionLease &operator=(const NatsConnectionLease &) = delete;
+
+    natsConnection *conn = nullptr;
+    jsCtx *js = nullptr;
+
+private:
+    shared_ptr<NatsConnectionPool> pool;
+    string url;
+};
+
+class NatsPoolStatsFunction {
+public:
+    static void Register(ExtensionLoader &loader);
+};
+
+} // namespace duckdb
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/main/client_context_state.hpp"
+#include <nats/nats.h>
+
+namespace duckdb {
+
+// Position of a durable cursor on one stream: the last sequence returned to a committed
+// query, and the subject parameter the cursor was created with (filters joined by ',')
+struct NatsCursorPosition {
+    uint64_t seq = 0;
+    string subject;
+};
+
+// Check that a cursor name can be part of a KV key. Throws otherwise.
+void NatsValidateCursorName(const string &name);
+
+// Read the stored position of cursor `name` on `stream` from the cursor bucket.
+// Returns false if the cursor has no position on the stream yet.
+bool NatsReadCursor(jsCtx *js, const string &name, const string &stream, NatsCursorPosition &position);
+
+// Cursor positions reached by the scans of the current transaction. They are written to
+// the cursor bucket when the transaction commits and dropped when it rolls back, so a
+// cursor only moves past rows of queries that succeeded.
+class NatsCursorState : public ClientContextState {
+public:
+    static shared_ptr<NatsCursorState> Get(ClientContext &context);
+
+    // Record that cursor `name` has returned every message of `stream` up to seq
+    void Advance(const string &url, const string &name, const string &stream, const string &subject, uint64_t seq);
+
+    // Position recorded by an earlier scan of the current transaction, if any
+    bool GetPending(const string &url, const string &name, const string &stream, NatsCursorPosition &position);
+
+    void TransactionCommit(MetaTransaction &transaction, ClientContext &context) override;
+    void TransactionRollback(MetaTransaction &transaction, ClientContext &context) override;
+
+private:
+    struct PendingCursor {
+        string url;
+        string name;
+        string stream;
+        NatsCursorPosition position;
+    };
+
+    mutex lock;
+    // Keyed by URL and KV key
+    map<string, PendingCursor> pending;
+};
+
+} // namespace duckdb
@@ -0,0 +1,208 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <nats/nats.h>
+
+namespace duckdb {
+
+class NatsStreamCache;
+class NatsCacheSession;
+struct NatsScanStats;
+
+// A message returned by a direct get, with its stream metadata resolved.
+// The subject points into the message buffer and is valid until msg is destroyed.
+struct NatsFetchedMessage {
+    natsMsg *msg = nullptr;
+    const char *subject = nullptr;
+    uint64_t seq = 0;
+    int64_t time_ns = 0;
+};
+
+// Destroys the messages left in a vector when it goes out of scope, so messages appended by
+// a fetch that then throws are not leaked. Messages moved out of the vector are not touched.
+class NatsFetchedMessagesGuard {
+public:
+    explicit NatsFetchedMessagesGuard(vector<NatsFetchedMessage> &messages_p) : messages(messages_p) {
+    }
+    ~NatsFetchedMessagesGuard();
+
+    NatsFetchedMessagesGuard(const NatsFetchedMessagesGuard &) = delete;
+    NatsFetchedMessagesGuard &operator=(const NatsFetchedMessagesGuard &) = delete;
+
+private:
+    vector<NatsFetchedMessage> &messages;
+};
+
+// Fetches stream messages by sequence using JetStream direct get.
+// Prefers batched direct get requests (NATS server 2.11+), where a single request
+// streams back a whole batch of messages, and falls back to one js_DirectGetMsg
+// round trip per sequence on servers that do not support batching.
+// A non-empty subject_filter (which may contain * and > wildcards) is applied by the
+// server, so only matching messages are transferred.
+// Every request asks for the next live message at or after a sequence, so the cost of
+// a fetch scales with the number of live messages rather than the sequence span.
+// With a segment cache set, cached sequences are read from disk and only the ranges
+// between cached segments are fetched, and then added to the cache.
+class NatsDirectGetFetcher {
+public:
+    NatsDirectGetFetcher(natsConnection *conn, jsCtx *js, string stream_name, string subject_filter);
+    ~NatsDirectGetFetcher();
+
+    // Fetch up to max_msgs messages with sequences in [next_seq, end_seq], appending them
+    // to out in sequence order. next_seq is advanced past the fetched messages.
+    // Returns false once the range has been exhausted.
+    bool Fetch(uint64_t &next_seq, uint64_t end_seq, idx_t max_msgs, vector<NatsFetchedMessage> &out);
+
+    // Fetch the last message of every subject matching the filter as of end_seq, skipping
+    // subjects whose last message is before start_seq. Appends up to max_msgs messages to
+    // out per call, and returns false once every subject has been returned. Uses multi_last
+    // direct get batches (NATS server 2.11+) and one last-by-subject get per subject on
+    // older servers.
+    bool FetchLastPerSubject(uint64_t start_seq, uint64_t end_seq, idx_t max_msgs, vector<NatsFetchedMessage> &out);
+
+    // Point the fetcher at another stream of the same server
+    void SetStream(const string &stream_name);
+    // Read through the segment cache of the current stream and subject filter, or fetch
+    // everything from the server if cache is null. The cache must outlive the fetcher.
+    void SetCache(NatsStreamCache *cache);
+    // Count requests, received messages and fetch time in stats, which must outlive the fetcher
+    void SetStats(NatsScanStats *stats);
+
+    static void DestroyMessages(vector<NatsFetchedMessage> &messages);
+
+private:
+    // How a batched request ended: the status code of the end of batch reply ("204" end of
+    // batch, "404" nothing found, ...), or empty if the server answered with a single
+    // unbatched message
+    struct BatchReply {
+        string status;
+        string description;
+        bool past_end = false;  // Messages past end_seq were dropped
+    };
+
+    bool FetchRemote(uint64_t &next_seq, uint64_t end_seq, idx_t max_msgs, vector<NatsFetchedMessage> &out);
+    bool FetchBatch(uint64_t &next_seq, uint64_t end_seq, idx_t max_msgs, vector<NatsFetchedMessage> &out);
+    // Send a batched request and collect its messages up to end_seq, advancing next_seq past them
+    BatchReply RequestBatch(const string &request, uint64_t &next_seq, uint64_t end_seq,
+                            vector<NatsFetchedMessage> &out, bool detect_unbatched);
+    bool FetchSingle(uint64_t &next_seq, uint64_t end_seq, idx_t max_msgs, vector<NatsFetchedMessage> &out);
+    void EnsureReplySubscription();
+    bool FetchLastBatches(uint64_t start_seq, uint64_t end_seq, idx_t max_msgs, vector<NatsFetchedMessage> &out);
+    // Last message of a subject between start_seq and end_seq on servers without multi_last, or nullptr
+    natsMsg *FetchLastBySubjectWalk(const string &subject, uint64_t start_seq, uint64_t end_seq);
+    // Count a message received from the server
+    void CountMessage(natsMsg *msg);
+
+    natsConnection *conn;
+    jsCtx *js;
+    string stream_name;
+    string subject_filter;
+    string next_by_subject;  // subject_filter, or '>' to match every subject
+    string api_subject;
+
+    // Batch support is unknown until the server has answered one batched request
+    enum class BatchSupport : uint8_t { UNKNOWN, SUPPORTED, UNSUPPORTED };
+    BatchSupport batch_support = BatchSupport::UNKNOWN;
+
+    natsInbox *reply_inbox = nullptr;
+    natsSubscription *reply_sub = nullptr;
+
+    unique_ptr<NatsCacheSession> cache_session;
+    NatsScanStats *stats = nullptr;
+
+    // Last-per-subject progress: one multi_last request for the whole filter, multi_last
+    // requests for groups of listed subjects, or one get per listed subject
+    enum class LastMode : uint8_t { UNSTARTED, MULTI_LAST, SUBJECT_GROUPS, SINGLE };
+    LastMode last_mode = LastMode::UNSTARTED;
+    uint64_t last_next_seq = 0;
+    vector<string> subjects;
+    idx_t subject_offset = 0;
+
+    // List the subjects matching the filter, in subject order
+    void LoadSubjects();
+};
+
+// Streams a sequence range through an ephemeral pull consumer.
+// The consumer is created without acknowledgements starting at start_seq and is
+// deleted again when the fetcher is destroyed. Each Fetch issues pull requests of
+// up to batch_size messages and max_bytes bytes.
+class NatsConsumerFetcher {
+public:
+    NatsConsumerFetcher(jsCtx *js, string stream_name, const string &subject_filter, uint64_t start_seq,
+                        int batch_size, int64_t max_bytes);
+    ~NatsConsumerFetcher();
+
+    // Fetch up to max_msgs messages with sequences up to end_seq, appending them to out
+    // in sequence order. Returns false once the consumer has delivered the whole range.
+    bool Fetch(uint64_t end_seq, idx_t max_msgs, vector<NatsFetchedMessage> &out);
+
+    // Count pull requests, received messages and fetch time in stats, which must outlive the fetcher
+    void SetStats(NatsScanStats *stats_p) {
+        stats = stats_p;
+    }
+
+private:
+    jsCtx *js;
+    string stream_name;
+    string consumer_name;
+    natsSubscription *sub = nullptr;
+    NatsScanStats *stats = nullptr;
+    int batch_size;
+    int64_t max_bytes;
+    bool done = false;
+};
+
+// Follows a stream from start_seq through an ordered push consumer, so new messages are
+// delivered as soon as the server stores them. The consumer is ephemeral, flow controlled
+// and recreated by the client library if it falls behind, and it is deleted again when the
+// fetcher is destroyed.
+class NatsFollowFetcher {
+public:
+    NatsFollowFetcher(jsCtx *js, string stream_name, const string &subject_filter, uint64_t start_seq);
+    ~NatsFollowFetcher();
+
+    // Wait up to wait_ms for the next message, then append it and every message that has
+    // already been delivered, up to max_msgs, to out in sequence order. Returns false if no
+    // message arrived within wait_ms.
+    bool Fetch(int64_t wait_ms, idx_t max_msgs, vector<NatsFetchedMessage> &out);
+
+private:
+    // Append one delivered message to out
+    void Append(natsMsg *msg, vector<NatsFetchedMessage> &out);
+
+    string stream_name;
+    natsSubscription *sub = nullptr;
+};
+
+// List the names of every stream on the server, in name order. Throws on failure.
+vector<string> NatsListStreamNames(jsCtx *js);
+
+// Fetch the info of a stream. A non-empty subjects_filter also requests the message count
+// of every subject matching it (State.Subjects). Throws on failure.
+jsStreamInfo *NatsGetStreamInfo(jsCtx *js, const string &stream_name, const string &subjects_filter = string());
+
+// Check that a subject filter is a valid NATS subject: non-empty tokens separated by '.',
+// where '*' matches exactly one token and '>' (only as the last token) matches one or more
+bool NatsSubjectFilterIsValid(const string &filter);
+
+// Whether a header is one the server adds to direct get responses (Nats-Stream,
+// Nats-Subject, Nats-Sequence, ...) rather than one the message was published with
+bool NatsIsDirectGetHeader(const char *key);
+
+// Parse an RFC 3339 timestamp as sent in the Nats-Time-Stamp header into nanoseconds since epoch
+bool ParseNatsTimestamp(const char *str, int64_t &time_ns);
+
+// Format nanoseconds since epoch as an RFC 3339 UTC timestamp with nanosecond precision
+string FormatNatsTimestamp(int64_t time_ns);
+
+enum class NatsTimeSeekResult : uint8_t {
+    FOUND,       // seq is the first message at or after the time
+    NOT_FOUND,   // No message at or after the time
+    UNSUPPORTED  // The server cannot seek by time (before NATS server 2.11)
+};
+
+// Find the first message at or after time_ns with a single direct get by start_time
+NatsTimeSeekResult NatsDirectGetSeekTime(natsConnection *conn, const string &stream_name, int64_t time_ns,
+                                         uint64_t &seq);
+
+} // namespace duckdb
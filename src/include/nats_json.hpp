@@ -0,0 +1,70 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "yyjson.hpp"
+
+namespace duckdb {
+
+// A field extracted from JSON payloads by json_extract.
+// The path is either dotted ('device.id', where numeric tokens index arrays) or a
+// JSON pointer ('/device/id'), and is compiled into its tokens once at bind time.
+struct NatsJsonField {
+    string path;
+    string column_name;
+    LogicalType type;
+    vector<string> tokens;
+    // json_auto fields whose keys were sampled with several spellings ("Temp" and "temp"),
+    // which are merged into one column: object keys of the field are matched ignoring case
+    bool case_insensitive_keys = false;
+};
+
+// Parse the json_extract parameter. A LIST of paths extracts every field as VARCHAR,
+// a STRUCT or MAP of path -> type name (e.g. {'temp': 'DOUBLE'}) extracts typed fields.
+vector<NatsJsonField> ParseJsonExtractFields(ClientContext &context, const Value &param);
+
+// Default number of messages json_auto samples to infer its columns
+static constexpr idx_t NATS_JSON_AUTO_DEFAULT_SAMPLE_SIZE = 1000;
+
+// Infers the columns of json_auto from sampled payloads: one column per top-level key, in
+// the order the keys were first seen. Numbers become BIGINT, UBIGINT or DOUBLE, strings
+// that all parse as timestamps TIMESTAMP, objects STRUCT and arrays LIST of their merged
+// element type. Keys whose sampled values disagree in kind (or that were only ever null)
+// become VARCHAR, into which objects and arrays are written as JSON text. Keys that differ
+// only in case are one column, named after the first spelling seen, and decode every spelling.
+class NatsJsonSchemaInference {
+public:
+    NatsJsonSchemaInference();
+    ~NatsJsonSchemaInference();
+
+    // Add a sampled payload. Payloads that are not JSON objects are ignored.
+    void AddSample(const char *data, idx_t len);
+
+    vector<NatsJsonField> GetFields() const;
+
+    struct Node;
+
+private:
+    unique_ptr<Node> root;
+};
+
+// Per-thread JSON decoder. Documents are parsed into a reusable buffer through a yyjson
+// pool allocator, so decoding does not allocate once the buffer has grown to fit the
+// largest payload seen.
+class NatsJsonDecoder {
+public:
+    // Parse a payload. Returns false if it is not valid JSON. The parsed document
+    // stays valid until the next call.
+    bool Parse(const char *data, idx_t len);
+
+    // Resolve a field in the current document and write it into row `row` of `result`.
+    // Missing fields, JSON nulls and values that do not convert to the field type are NULL.
+    // STRUCT and LIST fields are filled from objects and arrays in the same pass.
+    void WriteField(const NatsJsonField &field, Vector &result, idx_t row) const;
+
+private:
+    unsafe_unique_array<data_t> buffer;
+    idx_t buffer_size = 0;
+    duckdb_yyjson::yyjson_doc *doc = nullptr;
+};
+
+} // namespace duckdb
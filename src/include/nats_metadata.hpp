@@ -0,0 +1,17 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+class ExtensionLoader;
+
+// Table functions answered from stream metadata, without fetching any messages:
+// nats_stream_info(stream) returns the stream state, and
+// nats_subject_counts(stream[, filter]) the message count of every matching subject.
+class NatsMetadataFunctions {
+public:
+    static void Register(ExtensionLoader &loader);
+};
+
+} // namespace duckdb
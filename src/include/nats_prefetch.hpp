@@ -0,0 +1,82 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "nats_fetch.hpp"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <thread>
+
+namespace duckdb {
+
+// Default limit on the payload bytes a prefetcher keeps queued ahead of its scan thread
+static constexpr int64_t NATS_PREFETCH_DEFAULT_BYTES = 16 * 1024 * 1024;
+
+// A sequence range [start_seq, end_seq] of one of the scanned streams, claimed by
+// exactly one thread and emitted under one batch index
+struct NatsMorsel {
+    idx_t stream_index = 0;
+    uint64_t start_seq = 0;
+    uint64_t end_seq = 0;
+    idx_t batch_index = 0;
+    NatsStreamCache *cache = nullptr;  // Segment cache of the stream, if caching is enabled
+};
+
+// A batch of fetched messages from one morsel
+struct NatsPrefetchBatch {
+    vector<NatsFetchedMessage> messages;
+    idx_t stream_index = 0;
+    idx_t batch_index = 0;
+    bool end_of_morsel = false;  // Last batch of its morsel
+    idx_t bytes = 0;             // Payload bytes of the messages
+};
+
+// Claims the next morsel of a scan. Returns false once every stream has been exhausted.
+// Called from the prefetch thread.
+using NatsClaimMorselFunction = std::function<bool(NatsMorsel &morsel)>;
+
+// Fetches morsels on a background thread, so network round trips overlap with the
+// scan thread's decoding. Fetched batches wait in a bounded queue that holds at most
+// max_bytes of payload (always at least one batch) and NATS_PREFETCH_MAX_BATCHES batches.
+// The fetcher is used exclusively by the prefetch thread, and is pointed at the stream of
+// each morsel (stream_names[morsel.stream_index], which must outlive the prefetcher) and
+// its segment cache.
+class NatsPrefetcher {
+public:
+    NatsPrefetcher(unique_ptr<NatsDirectGetFetcher> fetcher, const vector<string> &stream_names,
+                   NatsClaimMorselFunction claim_morsel, idx_t max_bytes);
+    ~NatsPrefetcher();
+
+    NatsPrefetcher(const NatsPrefetcher &) = delete;
+    NatsPrefetcher &operator=(const NatsPrefetcher &) = delete;
+
+    // Wait for the next batch, in morsel order. Returns false once every morsel has been
+    // fetched. Rethrows errors raised on the prefetch thread.
+    bool Next(NatsPrefetchBatch &batch);
+
+private:
+    void Run();
+    void FetchMorsels();
+    // Queue a batch, waiting for room. Returns false if the prefetcher is shutting down.
+    bool Push(NatsPrefetchBatch &batch);
+
+    unique_ptr<NatsDirectGetFetcher> fetcher;
+    const vector<string> &stream_names;
+    NatsClaimMorselFunction claim_morsel;
+    idx_t max_bytes;
+
+    mutex lock;
+    std::condition_variable batch_ready;
+    std::condition_variable space_ready;
+    std::deque<NatsPrefetchBatch> queue;
+    idx_t queued_bytes = 0;
+    bool finished = false;  // Set by the prefetch thread once the range is exhausted or on error
+    bool stopped = false;   // Set on destruction to make the prefetch thread exit
+    std::exception_ptr error;
+
+    // Started last, once every member it uses has been initialized
+    std::thread thread;
+};
+
+} // namespace duckdb
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <google/protobuf/compiler/importer.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/dynamic_message.h>
+
+namespace duckdb {
+
+// Error collector for protobuf schema parsing
+class ProtobufErrorCollector : public google::protobuf::compiler::MultiFileErrorCollector {
+public:
+    // Protobuf 3.21.x and earlier use AddError with std::string
+    // Protobuf 3.22.x and later use RecordError with absl::string_view
+#if GOOGLE_PROTOBUF_VERSION >= 3022000
+    void RecordError(absl::string_view filename, int line, int column, absl::string_view message) override {
+        errors.push_back(string(filename) + ":" + std::to_string(line) + ":" + std::to_string(column) + ": " + string(message));
+    }
+#else
+    void AddError(const std::string& filename, int line, int column, const std::string& message) override {
+        errors.push_back(filename + ":" + std::to_string(line) + ":" + std::to_string(column) + ": " + message);
+    }
+#endif
+
+    string GetErrors() const {
+        string result;
+        for (const auto &err : errors) {
+            result += err + "\n";
+        }
+        return result;
+    }
+
+    bool HasErrors() const {
+        return !errors.empty();
+    }
+
+private:
+    vector<string> errors;
+};
+
+// A parsed protobuf schema: the descriptor pool and a message factory for it.
+// Schemas are immutable once loaded, so one instance is shared by every query
+// and thread that reads the same schema file.
+class NatsProtoSchema {
+public:
+    // Load a schema from a .proto file, or from a serialized FileDescriptorSet
+    // (protoc --include_imports --descriptor_set_out=...) for any other extension
+    static shared_ptr<NatsProtoSchema> Load(const string &path);
+
+    // Find a message type by name, either relative to the loaded files or fully qualified
+    const google::protobuf::Descriptor *FindMessageType(const string &name) const;
+
+    // Default instance of a message type, used to create per-thread messages (thread-safe)
+    const google::protobuf::Message *GetPrototype(const google::protobuf::Descriptor *descriptor);
+
+private:
+    // .proto sources (the importer owns the descriptor pool)
+    unique_ptr<google::protobuf::compiler::DiskSourceTree> source_tree;
+    unique_ptr<ProtobufErrorCollector> error_collector;
+    unique_ptr<google::protobuf::compiler::Importer> importer;
+
+    // Descriptor sets are built into a pool of their own
+    unique_ptr<google::protobuf::DescriptorPool> descriptor_pool;
+
+    const google::protobuf::DescriptorPool *pool = nullptr;
+    vector<const google::protobuf::FileDescriptor *> files;
+
+    // Declared last so the prototypes are destroyed before the descriptors they use
+    unique_ptr<google::protobuf::DynamicMessageFactory> message_factory;
+};
+
+// Process-wide schema cache keyed by absolute path. An entry is reloaded when the
+// file's modification time or size changes; imports of a .proto file are not tracked.
+shared_ptr<NatsProtoSchema> GetCachedProtoSchema(const string &path);
+
+} // namespace duckdb
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+class ExtensionLoader;
+
+// COPY ... TO 'nats://host:port' (FORMAT nats, ...): publishes one JetStream message per row.
+// Each sink borrows a pooled connection and publishes asynchronously on its own JetStream
+// context, with up to MAX_PENDING messages waiting for their acks. A sink waits for all of
+// its acks when it finishes, so the COPY only succeeds once every row has been stored.
+class NatsPublishFunction {
+public:
+    static void Register(ExtensionLoader &loader);
+};
+
+} // namespace duckdb
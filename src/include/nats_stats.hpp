@@ -0,0 +1,86 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include <atomic>
+#include <chrono>
+#include <deque>
+
+namespace duckdb {
+
+class ExtensionLoader;
+
+// Finished scans kept for nats_scan_stats(), oldest dropped first
+static constexpr idx_t NATS_SCAN_STATS_HISTORY = 64;
+
+// Nanoseconds on the steady clock, for timing fetches and decoding
+inline uint64_t NatsNowNanos() {
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch())
+                        .count());
+}
+
+// Counters of one running scan. The scan threads, their prefetch threads and the fetchers
+// they own add to them concurrently.
+struct NatsScanStats {
+    std::atomic<uint64_t> rows {0};               // Rows returned
+    std::atomic<uint64_t> round_trips {0};        // Requests answered by the server (direct gets, pulls, probes)
+    std::atomic<uint64_t> messages_received {0};  // Messages received from the server
+    std::atomic<uint64_t> bytes_received {0};     // Payload bytes of the received messages
+    std::atomic<uint64_t> cached_messages {0};    // Messages read from the segment cache instead
+    std::atomic<uint64_t> skipped_filter {0};     // Received messages dropped by subject lists or header filters
+    std::atomic<uint64_t> skipped_gap {0};        // Sequences passed over by direct gets: deleted, or not matching the subject filter
+    std::atomic<uint64_t> resolve_probes {0};     // Direct gets spent resolving start_time/end_time to sequences
+    std::atomic<uint64_t> fetch_ns {0};           // Time waiting for the server, summed over threads
+    std::atomic<uint64_t> decode_ns {0};          // Time writing rows (decompression, JSON/protobuf decoding), summed over threads
+};
+
+// Counters of a finished scan, as reported by nats_scan_stats()
+struct NatsScanStatsRecord {
+    uint64_t scan_id = 0;
+    string streams;  // Scanned streams, joined by ','
+    string mode;
+    uint64_t rows = 0;
+    uint64_t round_trips = 0;
+    uint64_t messages_received = 0;
+    uint64_t bytes_received = 0;
+    uint64_t cached_messages = 0;
+    uint64_t skipped_filter = 0;
+    uint64_t skipped_gap = 0;
+    uint64_t resolve_probes = 0;
+    double fetch_ms = 0;
+    double decode_ms = 0;
+    double elapsed_ms = 0;  // From the start of the scan until it finished
+
+    NatsScanStatsRecord() = default;
+    NatsScanStatsRecord(const NatsScanStats &stats, string streams, string mode, double elapsed_ms);
+};
+
+// The last NATS_SCAN_STATS_HISTORY finished scans of a DuckDB instance. Lives in the
+// instance's object cache like the connection pool.
+class NatsScanStatsHistory : public ObjectCacheEntry {
+public:
+    static shared_ptr<NatsScanStatsHistory> Get(ClientContext &context);
+
+    void Add(NatsScanStatsRecord record);
+    vector<NatsScanStatsRecord> GetRecords();
+
+    static string ObjectType() {
+        return "nats_js_scan_stats";
+    }
+    string GetObjectType() override {
+        return ObjectType();
+    }
+
+private:
+    mutex lock;
+    uint64_t next_scan_id = 1;
+    std::deque<NatsScanStatsRecord> records;  // Oldest first
+};
+
+class NatsScanStatsFunction {
+public:
+    static void Register(ExtensionLoader &loader);
+};
+
+} // namespace duckdb
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+// Matches subjects against a set of NATS subject filters ('*' matches one token, '>' the
+// rest). The filters are compiled into a token trie once, so a subject is matched by walking
+// its tokens a single time, without allocating.
+class NatsSubjectMatcher {
+public:
+    // The filters must be valid (see NatsSubjectFilterIsValid)
+    explicit NatsSubjectMatcher(const vector<string> &filters);
+
+    bool Matches(const char *subject, idx_t length) const;
+
+    bool Matches(const char *subject) const {
+        return Matches(subject, strlen(subject));
+    }
+
+    // The narrowest single filter matching every subject that one of the filters matches,
+    // e.g. 'telemetry.*.power' for 'telemetry.dc1.power' and 'telemetry.dc2.power'. Empty
+    // when only '>' covers them all.
+    static string CoveringFilter(const vector<string> &filters);
+
+private:
+    struct Node {
+        // Children by literal token, sorted by token
+        vector<std::pair<string, idx_t>> literals;
+        // Child for a '*' token
+        idx_t wildcard = DConstants::INVALID_INDEX;
+        // A filter ends with '>' here: matches one or more remaining tokens
+        bool match_rest = false;
+        // A filter ends here: matches when the subject has no tokens left
+        bool terminal = false;
+    };
+
+    idx_t FindLiteral(const Node &node, const char *token, idx_t length) const;
+    bool MatchFrom(idx_t node_index, const char *subject, idx_t length, idx_t pos) const;
+
+    vector<Node> nodes;
+};
+
+} // namespace duckdb
@@ -0,0 +1,355 @@
+#include "nats_cache.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace duckdb {
+
+// Filled segments are written once they hold this many bytes of records
+static constexpr idx_t NATS_CACHE_SEGMENT_BYTES = 32 * 1024 * 1024;
+
+// First bytes of every segment file, followed by the message records
+static constexpr const char NATS_CACHE_MAGIC[] = "NATSSEG1";
+static constexpr idx_t NATS_CACHE_MAGIC_SIZE = sizeof(NATS_CACHE_MAGIC) - 1;
+
+static constexpr const char *NATS_CACHE_SEGMENT_EXTENSION = ".seg";
+
+// Directory name for a stream or subject filter: characters other than letters, digits,
+// '-', '_' and '.' are written as '=' followed by their hex code
+static string CacheDirectoryName(const string &name) {
+    static constexpr const char *HEX = "0123456789abcdef";
+    string result;
+    for (auto c : name) {
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_' ||
+            c == '.') {
+            result += c;
+        } else {
+            result += '=';
+            result += HEX[(uint8_t(c) >> 4) & 0xF];
+            result += HEX[uint8_t(c) & 0xF];
+        }
+    }
+    return result;
+}
+
+// Segment files are named <start_seq>-<end_seq>.seg
+static bool ParseSegmentFileName(const string &name, uint64_t &start_seq, uint64_t &end_seq) {
+    char *end = nullptr;
+    start_seq = std::strtoull(name.c_str(), &end, 10);
+    if (end == name.c_str() || *end != '-') {
+        return false;
+    }
+    const char *end_str = end + 1;
+    end_seq = std::strtoull(end_str, &end, 10);
+    return end != end_str && strcmp(end, NATS_CACHE_SEGMENT_EXTENSION) == 0 && start_seq > 0 &&
+           start_seq <= end_seq;
+}
+
+// Records are written in native byte order: the cache only lives on the machine that wrote it
+template <class T>
+static void AppendValue(string &records, T value) {
+    records.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <class T>
+static bool ReadValue(const string &data, idx_t &offset, T &value) {
+    if (data.size() - offset < sizeof(T)) {
+        return false;
+    }
+    memcpy(&value, data.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+static void AppendBytes(string &records, const char *bytes, idx_t len) {
+    AppendValue<uint32_t>(records, static_cast<uint32_t>(len));
+    if (len > 0) {
+        records.append(bytes, len);
+    }
+}
+
+// Appends the headers of a message as (key, value) pairs, one pair per value
+static void AppendHeaders(string &records, natsMsg *msg) {
+    string headers;
+    const char **keys = nullptr;
+    int key_count = 0;
+    if (natsMsgHeader_Keys(msg, &keys, &key_count) == NATS_OK) {
+        for (int k = 0; k < key_count; k++) {
+            const char **values = nullptr;
+            int value_count = 0;
+            if (natsMsgHeader_Values(msg, keys[k], &values, &value_count) != NATS_OK) {
+                continue;
+            }
+            for (int v = 0; v < value_count; v++) {
+                AppendBytes(headers, keys[k], strlen(keys[k]));
+                AppendBytes(headers, values[v], strlen(values[v]));
+            }
+            free(values);
+        }
+        free(keys);
+    }
+    AppendBytes(records, headers.data(), headers.size());
+}
+
+// A message record: seq, time_ns, then subject, headers and payload, each prefixed by its length
+struct NatsCacheRecord {
+    uint64_t seq = 0;
+    int64_t time_ns = 0;
+    idx_t subject_offset = 0;
+    uint32_t subject_len = 0;
+    idx_t headers_offset = 0;
+    uint32_t headers_len = 0;
+    idx_t payload_offset = 0;
+    uint32_t payload_len = 0;
+};
+
+static bool ReadBytes(const string &data, idx_t &offset, idx_t &bytes_offset, uint32_t &len) {
+    if (!ReadValue(data, offset, len) || data.size() - offset < len) {
+        return false;
+    }
+    bytes_offset = offset;
+    offset += len;
+    return true;
+}
+
+static bool ReadRecord(const string &data, idx_t &offset, NatsCacheRecord &record) {
+    return ReadValue(data, offset, record.seq) && ReadValue(data, offset, record.time_ns) &&
+           ReadBytes(data, offset, record.subject_offset, record.subject_len) &&
+           ReadBytes(data, offset, record.headers_offset, record.headers_len) &&
+           ReadBytes(data, offset, record.payload_offset, record.payload_len);
+}
+
+NatsStreamCache::NatsStreamCache(const string &cache_directory, const string &stream_name, int64_t created_ns,
+                                 const string &subject_filter, uint64_t last_seq_p)
+    : last_seq(last_seq_p) {
+    auto path = std::filesystem::path(cache_directory) /
+                (CacheDirectoryName(stream_name) + "-" + std::to_string(created_ns)) /
+                (subject_filter.empty() ? string("_all") : CacheDirectoryName(subject_filter));
+    directory = path.string();
+
+    // A missing or unreadable directory leaves the cache empty
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(path, ec), end; !ec && it != end; it.increment(ec)) {
+        NatsCachedSegment cached;
+        if (!ParseSegmentFileName(it->path().filename().string(), cached.start_seq, cached.end_seq)) {
+            continue;
+        }
+        cached.path = it->path().string();
+        segments.push_back(std::move(cached));
+    }
+}
+
+bool NatsStreamCache::FindSegment(uint64_t seq, NatsCachedSegment &segment) {
+    lock_guard<mutex> guard(lock);
+    // Segments of concurrent scans may overlap; prefer the one reaching furthest
+    bool found = false;
+    for (auto &cached : segments) {
+        if (cached.start_seq <= seq && seq <= cached.end_seq && (!found || cached.end_seq > segment.end_seq)) {
+            segment = cached;
+            found = true;
+        }
+    }
+    return found;
+}
+
+uint64_t NatsStreamCache::NextCachedSeq(uint64_t seq) {
+    lock_guard<mutex> guard(lock);
+    uint64_t next = UINT64_MAX;
+    for (auto &cached : segments) {
+        if (cached.start_seq > seq) {
+            next = MinValue<uint64_t>(next, cached.start_seq);
+        }
+    }
+    return next;
+}
+
+void NatsStreamCache::AddSegment(uint64_t start_seq, uint64_t end_seq, const string &records) {
+    static std::atomic<uint64_t> write_counter {0};
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec) {
+        return;
+    }
+    auto name = std::to_string(start_seq) + "-" + std::to_string(end_seq) + NATS_CACHE_SEGMENT_EXTENSION;
+    auto path = (std::filesystem::path(directory) / name).string();
+
+    // Write to a temporary file first, so readers never see a partial segment
+    auto temp_path = path + ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) +
+                     "-" + std::to_string(++write_counter);
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        file.write(NATS_CACHE_MAGIC, NATS_CACHE_MAGIC_SIZE);
+        file.write(records.data(), static_cast<std::streamsize>(records.size()));
+        file.close();
+        if (!file) {
+            std::filesystem::remove(temp_path, ec);
+            return;
+        }
+    }
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        return;
+    }
+
+    lock_guard<mutex> guard(lock);
+    segments.push_back(NatsCachedSegment {start_seq, end_seq, path});
+}
+
+void NatsStreamCache::RemoveSegment(const NatsCachedSegment &segment) {
+    lock_guard<mutex> guard(lock);
+    segments.erase(std::remove_if(segments.begin(), segments.end(),
+                                  [&](const NatsCachedSegment &cached) { return cached.path == segment.path; }),
+                   segments.end());
+}
+
+NatsCacheSession::NatsCacheSession(NatsStreamCache &cache_p) : cache(cache_p) {
+}
+
+NatsCacheSession::~NatsCacheSession() {
+    try {
+        Flush();
+    } catch (...) {
+        // The range stays uncached
+    }
+}
+
+bool NatsCacheSession::Load(const NatsCachedSegment &segment_p) {
+    loaded = false;
+    index.clear();
+
+    std::ifstream file(segment_p.path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+    auto size = file.tellg();
+    if (size < static_cast<std::streamoff>(NATS_CACHE_MAGIC_SIZE)) {
+        return false;
+    }
+    data.resize(static_cast<idx_t>(size));
+    file.seekg(0);
+    if (!file.read(&data[0], size) || memcmp(data.data(), NATS_CACHE_MAGIC, NATS_CACHE_MAGIC_SIZE) != 0) {
+        return false;
+    }
+
+    // Records are in sequence order and within the segment's range
+    idx_t offset = NATS_CACHE_MAGIC_SIZE;
+    uint64_t previous_seq = 0;
+    while (offset < data.size()) {
+        idx_t record_offset = offset;
+        NatsCacheRecord record;
+        if (!ReadRecord(data, offset, record) || record.seq <= previous_seq || record.seq < segment_p.start_seq ||
+            record.seq > segment_p.end_seq) {
+            index.clear();
+            return false;
+        }
+        index.emplace_back(record.seq, record_offset);
+        previous_seq = record.seq;
+    }
+    segment = segment_p;
+    loaded = true;
+    return true;
+}
+
+NatsFetchedMessage NatsCacheSession::CreateMessage(idx_t offset) const {
+    NatsCacheRecord record;
+    ReadRecord(data, offset, record);
+
+    string subject(data.data() + record.subject_offset, record.subject_len);
+    natsMsg *msg = nullptr;
+    natsStatus s = natsMsg_Create(&msg, subject.c_str(), nullptr, data.data() + record.payload_offset,
+                                  static_cast<int>(record.payload_len));
+    if (s != NATS_OK) {
+        throw std::runtime_error(std::string("Failed to create cached message: ") + natsStatus_GetText(s));
+    }
+
+    // Restore the headers, e.g. the Nats-* headers of the original direct get response
+    idx_t header_offset = record.headers_offset;
+    idx_t headers_end = record.headers_offset + record.headers_len;
+    while (header_offset < headers_end) {
+        idx_t key_offset, value_offset;
+        uint32_t key_len, value_len;
+        if (!ReadBytes(data, header_offset, key_offset, key_len) ||
+            !ReadBytes(data, header_offset, value_offset, value_len)) {
+            break;
+        }
+        string key(data.data() + key_offset, key_len);
+        string value(data.data() + value_offset, value_len);
+        s = natsMsgHeader_Add(msg, key.c_str(), value.c_str());
+        if (s != NATS_OK) {
+            natsMsg_Destroy(msg);
+            throw std::runtime_error(std::string("Failed to restore cached message headers: ") +
+                                     natsStatus_GetText(s));
+        }
+    }
+    return NatsFetchedMessage {msg, natsMsg_GetSubject(msg), record.seq, record.time_ns};
+}
+
+bool NatsCacheSession::Read(uint64_t &next_seq, uint64_t end_seq, idx_t max_msgs, vector<NatsFetchedMessage> &out) {
+    if (!loaded || next_seq < segment.start_seq || next_seq > segment.end_seq) {
+        NatsCachedSegment found;
+        if (!cache.FindSegment(next_seq, found)) {
+            return false;
+        }
+        if (!Load(found)) {
+            cache.RemoveSegment(found);
+            return false;
+        }
+    }
+
+    uint64_t last_seq = MinValue<uint64_t>(end_seq, segment.end_seq);
+    auto entry = std::lower_bound(index.begin(), index.end(), next_seq,
+                                  [](const std::pair<uint64_t, idx_t> &e, uint64_t seq) { return e.first < seq; });
+    for (idx_t count = 0; entry != index.end() && entry->first <= last_seq && count < max_msgs; ++entry, count++) {
+        out.push_back(CreateMessage(entry->second));
+    }
+    // Continue at the next cached message, or after the segment (or range) once it is read
+    next_seq = entry != index.end() && entry->first <= last_seq ? entry->first : last_seq + 1;
+    return true;
+}
+
+void NatsCacheSession::Write(uint64_t start_seq, uint64_t end_seq, const NatsFetchedMessage *messages, idx_t count) {
+    end_seq = MinValue<uint64_t>(end_seq, cache.LastSeq());
+    if (end_seq < start_seq) {
+        return;
+    }
+    if (filling && fill_end + 1 != start_seq) {
+        Flush();
+    }
+    if (!filling) {
+        filling = true;
+        fill_start = start_seq;
+        records.clear();
+    }
+    for (idx_t i = 0; i < count; i++) {
+        auto &message = messages[i];
+        if (message.seq > end_seq) {
+            break;
+        }
+        AppendValue<uint64_t>(records, message.seq);
+        AppendValue<int64_t>(records, message.time_ns);
+        AppendBytes(records, message.subject, strlen(message.subject));
+        AppendHeaders(records, message.msg);
+        AppendBytes(records, natsMsg_GetData(message.msg), static_cast<idx_t>(natsMsg_GetDataLength(message.msg)));
+    }
+    fill_end = end_seq;
+    if (records.size() >= NATS_CACHE_SEGMENT_BYTES) {
+        Flush();
+    }
+}
+
+void NatsCacheSession::Flush() {
+    if (!filling) {
+        return;
+    }
+    filling = false;
+    cache.AddSegment(fill_start, fill_end, records);
+    records.clear();
+}
+
+} // namespace duckdb
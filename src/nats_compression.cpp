@@ -0,0 +1,350 @@
+#include "nats_compression.hpp"
+#include "duckdb/common/string_util.hpp"
+#include <zstd.h>
+#include <lz4frame.h>
+#include <zlib.h>
+#include <snappy.h>
+#include <cstring>
+
+namespace duckdb {
+
+// Magic bytes that start a compressed payload
+static const uint8_t NATS_ZSTD_MAGIC[] = {0x28, 0xB5, 0x2F, 0xFD};
+static const uint8_t NATS_LZ4_MAGIC[] = {0x04, 0x22, 0x4D, 0x18};
+static const uint8_t NATS_GZIP_MAGIC[] = {0x1F, 0x8B};
+// Stream identifier chunk of the Snappy framing format
+static const uint8_t NATS_SNAPPY_MAGIC[] = {0xFF, 0x06, 0x00, 0x00, 's', 'N', 'a', 'P', 'p', 'Y'};
+
+template <idx_t N>
+static bool StartsWith(const char *data, idx_t len, const uint8_t (&magic)[N]) {
+    return len >= N && memcmp(data, magic, N) == 0;
+}
+
+NatsCompression ParseNatsCompression(const string &name) {
+    auto lower = StringUtil::Lower(name);
+    if (lower == "none") {
+        return NatsCompression::NONE;
+    } else if (lower == "auto") {
+        return NatsCompression::AUTO;
+    } else if (lower == "zstd") {
+        return NatsCompression::ZSTD;
+    } else if (lower == "lz4") {
+        return NatsCompression::LZ4;
+    } else if (lower == "gzip") {
+        return NatsCompression::GZIP;
+    } else if (lower == "snappy") {
+        return NatsCompression::SNAPPY;
+    }
+    throw std::runtime_error("Invalid compression '" + name +
+                             "': expected 'none', 'auto', 'zstd', 'lz4', 'gzip' or 'snappy'");
+}
+
+const char *NatsCompressionName(NatsCompression compression) {
+    switch (compression) {
+    case NatsCompression::AUTO:
+        return "auto";
+    case NatsCompression::ZSTD:
+        return "zstd";
+    case NatsCompression::LZ4:
+        return "lz4";
+    case NatsCompression::GZIP:
+        return "gzip";
+    case NatsCompression::SNAPPY:
+        return "snappy";
+    default:
+        return "none";
+    }
+}
+
+NatsCompression NatsDetectCompression(NatsCompression setting, natsMsg *msg, const char *data, idx_t len) {
+    if (setting != NatsCompression::AUTO) {
+        return setting;
+    }
+
+    // A Content-Encoding header names the codec; "identity" and unknown codecs mean the
+    // payload is read as stored
+    const char *encoding = nullptr;
+    if (natsMsgHeader_Get(msg, NATS_CONTENT_ENCODING_HEADER, &encoding) == NATS_OK) {
+        if (StringUtil::CIEquals(encoding, "zstd")) {
+            return NatsCompression::ZSTD;
+        } else if (StringUtil::CIEquals(encoding, "lz4")) {
+            return NatsCompression::LZ4;
+        } else if (StringUtil::CIEquals(encoding, "gzip") || StringUtil::CIEquals(encoding, "x-gzip")) {
+            return NatsCompression::GZIP;
+        } else if (StringUtil::CIEquals(encoding, "snappy")) {
+            return NatsCompression::SNAPPY;
+        }
+        return NatsCompression::NONE;
+    }
+
+    // Otherwise the framed formats are recognized by their magic bytes. Raw Snappy blocks
+    // have none and need the header or compression := 'snappy'.
+    if (StartsWith(data, len, NATS_ZSTD_MAGIC)) {
+        return NatsCompression::ZSTD;
+    } else if (StartsWith(data, len, NATS_LZ4_MAGIC)) {
+        return NatsCompression::LZ4;
+    } else if (StartsWith(data, len, NATS_GZIP_MAGIC)) {
+        return NatsCompression::GZIP;
+    } else if (StartsWith(data, len, NATS_SNAPPY_MAGIC)) {
+        return NatsCompression::SNAPPY;
+    }
+    return NatsCompression::NONE;
+}
+
+NatsDecompressor::~NatsDecompressor() {
+    if (zstd_ctx) {
+        ZSTD_freeDCtx(zstd_ctx);
+    }
+    if (lz4_ctx) {
+        LZ4F_freeDecompressionContext(lz4_ctx);
+    }
+    if (zlib_stream) {
+        inflateEnd(zlib_stream);
+        delete zlib_stream;
+    }
+}
+
+bool NatsDecompressor::Fail(string message) {
+    error = std::move(message);
+    return false;
+}
+
+bool NatsDecompressor::Reserve(idx_t capacity) {
+    if (capacity <= buffer_size) {
+        return true;
+    }
+    if (capacity > NATS_MAX_DECOMPRESSED_BYTES) {
+        return Fail("decompressed payload exceeds " + std::to_string(NATS_MAX_DECOMPRESSED_BYTES) + " bytes");
+    }
+    auto new_size = MinValue<idx_t>(NextPowerOfTwo(capacity), NATS_MAX_DECOMPRESSED_BYTES);
+    auto new_buffer = make_unsafe_uniq_array_uninitialized<data_t>(new_size);
+    if (size > 0) {
+        memcpy(new_buffer.get(), buffer.get(), size);
+    }
+    buffer = std::move(new_buffer);
+    buffer_size = new_size;
+    return true;
+}
+
+bool NatsDecompressor::Decompress(NatsCompression codec, const char *data, idx_t len) {
+    size = 0;
+    error.clear();
+    switch (codec) {
+    case NatsCompression::ZSTD:
+        return DecompressZstd(data, len);
+    case NatsCompression::LZ4:
+        return DecompressLz4(data, len);
+    case NatsCompression::GZIP:
+        return DecompressGzip(data, len);
+    case NatsCompression::SNAPPY:
+        return DecompressSnappy(data, len);
+    default:
+        return Fail("no codec to decompress with");
+    }
+}
+
+bool NatsDecompressor::DecompressZstd(const char *data, idx_t len) {
+    if (!zstd_ctx) {
+        zstd_ctx = ZSTD_createDCtx();
+        if (!zstd_ctx) {
+            return Fail("failed to create zstd context");
+        }
+    }
+    ZSTD_DCtx_reset(zstd_ctx, ZSTD_reset_session_only);
+
+    // Start with the size recorded in the frame header when the producer wrote it
+    auto content_size = ZSTD_getFrameContentSize(data, len);
+    idx_t initial = content_size != ZSTD_CONTENTSIZE_UNKNOWN && content_size != ZSTD_CONTENTSIZE_ERROR
+                        ? idx_t(content_size)
+                        : len * 4;
+    if (!Reserve(MaxValue<idx_t>(initial, 1))) {
+        return false;
+    }
+
+    // Stream through every frame of the payload
+    ZSTD_inBuffer input = {data, len, 0};
+    size_t ret = 0;
+    while (input.pos < input.size || ret != 0) {
+        if (size == buffer_size && !Reserve(buffer_size * 2)) {
+            return false;
+        }
+        ZSTD_outBuffer output = {buffer.get(), buffer_size, size};
+        auto last_pos = input.pos;
+        ret = ZSTD_decompressStream(zstd_ctx, &output, &input);
+        if (ZSTD_isError(ret)) {
+            return Fail(ZSTD_getErrorName(ret));
+        }
+        bool progress = output.pos > size || input.pos > last_pos;
+        size = output.pos;
+        if (ret != 0 && input.pos == input.size && !progress) {
+            return Fail("truncated zstd frame");
+        }
+    }
+    return true;
+}
+
+bool NatsDecompressor::DecompressLz4(const char *data, idx_t len) {
+    if (!lz4_ctx) {
+        if (LZ4F_isError(LZ4F_createDecompressionContext(&lz4_ctx, LZ4F_VERSION))) {
+            lz4_ctx = nullptr;
+            return Fail("failed to create lz4 context");
+        }
+    }
+    LZ4F_resetDecompressionContext(lz4_ctx);
+    if (!Reserve(MaxValue<idx_t>(len * 4, 1))) {
+        return false;
+    }
+
+    // Decompress every frame of the payload; a return of 0 ends a frame
+    idx_t offset = 0;
+    size_t ret = 0;
+    while (offset < len) {
+        if (size == buffer_size && !Reserve(buffer_size * 2)) {
+            return false;
+        }
+        size_t dst_size = buffer_size - size;
+        size_t src_size = len - offset;
+        ret = LZ4F_decompress(lz4_ctx, buffer.get() + size, &dst_size, data + offset, &src_size, nullptr);
+        if (LZ4F_isError(ret)) {
+            return Fail(LZ4F_getErrorName(ret));
+        }
+        size += dst_size;
+        offset += src_size;
+        if (src_size == 0 && dst_size == 0 && size < buffer_size) {
+            return Fail("lz4 frame made no progress");
+        }
+    }
+    // Flush output the context still holds
+    while (ret != 0) {
+        if (size == buffer_size && !Reserve(buffer_size * 2)) {
+            return false;
+        }
+        size_t dst_size = buffer_size - size;
+        size_t src_size = 0;
+        ret = LZ4F_decompress(lz4_ctx, buffer.get() + size, &dst_size, nullptr, &src_size, nullptr);
+        if (LZ4F_isError(ret)) {
+            return Fail(LZ4F_getErrorName(ret));
+        }
+        if (dst_size == 0) {
+            return Fail("truncated lz4 frame");
+        }
+        size += dst_size;
+    }
+    return true;
+}
+
+bool NatsDecompressor::DecompressGzip(const char *data, idx_t len) {
+    if (!zlib_stream) {
+        zlib_stream = new z_stream();
+        // 16 + MAX_WBITS accepts gzip members only
+        if (inflateInit2(zlib_stream, 16 + MAX_WBITS) != Z_OK) {
+            delete zlib_stream;
+            zlib_stream = nullptr;
+            return Fail("failed to create zlib stream");
+        }
+    } else {
+        inflateReset(zlib_stream);
+    }
+    if (!Reserve(MaxValue<idx_t>(len * 4, 1))) {
+        return false;
+    }
+
+    zlib_stream->next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+    zlib_stream->avail_in = uInt(len);
+    while (true) {
+        if (size == buffer_size && !Reserve(buffer_size * 2)) {
+            return false;
+        }
+        zlib_stream->next_out = buffer.get() + size;
+        zlib_stream->avail_out = uInt(buffer_size - size);
+        int ret = inflate(zlib_stream, Z_NO_FLUSH);
+        size = buffer_size - zlib_stream->avail_out;
+        if (ret == Z_STREAM_END) {
+            // Concatenated members decompress to the concatenation of their contents
+            if (zlib_stream->avail_in == 0) {
+                return true;
+            }
+            inflateReset(zlib_stream);
+            continue;
+        }
+        if (ret == Z_BUF_ERROR && zlib_stream->avail_in == 0) {
+            return Fail("truncated gzip member");
+        }
+        if (ret != Z_OK && ret != Z_BUF_ERROR) {
+            return Fail(zlib_stream->msg ? zlib_stream->msg : "invalid gzip data");
+        }
+    }
+}
+
+bool NatsDecompressor::DecompressSnappy(const char *data, idx_t len) {
+    if (StartsWith(data, len, NATS_SNAPPY_MAGIC)) {
+        return DecompressSnappyFrames(data, len);
+    }
+
+    // A raw block, prefixed with its uncompressed length
+    size_t uncompressed = 0;
+    if (!snappy::GetUncompressedLength(data, len, &uncompressed)) {
+        return Fail("invalid snappy block");
+    }
+    if (!Reserve(MaxValue<idx_t>(uncompressed, 1))) {
+        return false;
+    }
+    if (!snappy::RawUncompress(data, len, reinterpret_cast<char *>(buffer.get()))) {
+        return Fail("invalid snappy block");
+    }
+    size = uncompressed;
+    return true;
+}
+
+// Snappy framing format: chunks of a type byte and a 3-byte little endian length. Data
+// chunks start with a masked CRC-32C of their uncompressed contents, which is not verified;
+// the message was already checked by the server when it was stored.
+bool NatsDecompressor::DecompressSnappyFrames(const char *data, idx_t len) {
+    idx_t offset = 0;
+    while (offset < len) {
+        if (len - offset < 4) {
+            return Fail("truncated snappy chunk header");
+        }
+        auto type = uint8_t(data[offset]);
+        idx_t chunk_len = idx_t(uint8_t(data[offset + 1])) | idx_t(uint8_t(data[offset + 2])) << 8 |
+                          idx_t(uint8_t(data[offset + 3])) << 16;
+        offset += 4;
+        if (len - offset < chunk_len) {
+            return Fail("truncated snappy chunk");
+        }
+        const char *chunk = data + offset;
+        offset += chunk_len;
+
+        if (type == 0x00 || type == 0x01) {
+            if (chunk_len < 4) {
+                return Fail("truncated snappy chunk");
+            }
+            chunk += 4;
+            chunk_len -= 4;
+            if (type == 0x01) {
+                // Uncompressed data
+                if (!Reserve(size + chunk_len)) {
+                    return false;
+                }
+                memcpy(buffer.get() + size, chunk, chunk_len);
+                size += chunk_len;
+                continue;
+            }
+            size_t uncompressed = 0;
+            if (!snappy::GetUncompressedLength(chunk, chunk_len, &uncompressed) ||
+                !Reserve(size + uncompressed)) {
+                return error.empty() ? Fail("invalid snappy chunk") : false;
+            }
+            if (!snappy::RawUncompress(chunk, chunk_len, reinterpret_cast<char *>(buffer.get() + size))) {
+                return Fail("invalid snappy chunk");
+            }
+            size += uncompressed;
+        } else if (type >= 0x02 && type <= 0x7F) {
+            return Fail("unsupported snappy chunk type " + std::to_string(type));
+        }
+        // Stream identifiers (0xFF), padding (0xFE) and skippable chunks (0x80-0xFD) carry no data
+    }
+    return true;
+}
+
+} // namespace duckdb
@@ -0,0 +1,254 @@
+#include "nats_connection_pool.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+
+namespace duckdb {
+
+// Connect timeout for newly dialed connections
+static constexpr int64_t NATS_CONNECT_TIMEOUT_MS = 5000;
+
+// Idle pooled connections are closed after this long without being borrowed
+static constexpr std::chrono::seconds NATS_POOL_IDLE_TIMEOUT(60);
+
+// At most this many idle connections are kept per URL; extra returns are closed
+static constexpr idx_t NATS_POOL_MAX_IDLE_PER_URL = 64;
+
+// Idle connections older than this are pinged before they are handed out, since a half-open
+// TCP connection keeps reporting CONNECTED until the client's own ping-outs fire
+static constexpr std::chrono::seconds NATS_POOL_PING_AFTER_IDLE(5);
+
+// How long a pooled connection may take to answer that PING
+static constexpr int64_t NATS_POOL_PING_TIMEOUT_MS = 1000;
+
+static constexpr const char *NATS_POOL_CACHE_KEY = "nats_js_connection_pool";
+
+void NatsConnect(const string &url, natsConnection **conn, jsCtx **js) {
+    natsOptions *opts = nullptr;
+    natsStatus s = natsOptions_Create(&opts);
+    if (s != NATS_OK) {
+        throw std::runtime_error(std::string("Failed to create NATS options: ") + natsStatus_GetText(s));
+    }
+
+    // Set connection timeout to 5 seconds
+    s = natsOptions_SetTimeout(opts, NATS_CONNECT_TIMEOUT_MS);
+    if (s != NATS_OK) {
+        natsOptions_Destroy(opts);
+        throw std::runtime_error(std::string("Failed to set NATS timeout: ") + natsStatus_GetText(s));
+    }
+
+    s = natsOptions_SetURL(opts, url.c_str());
+    if (s != NATS_OK) {
+        natsOptions_Destroy(opts);
+        throw std::runtime_error(std::string("Failed to set NATS URL: ") + natsStatus_GetText(s));
+    }
+
+    s = natsConnection_Connect(conn, opts);
+    natsOptions_Destroy(opts);
+
+    if (s != NATS_OK) {
+        throw std::runtime_error(std::string("Failed to connect to NATS: ") + natsStatus_GetText(s));
+    }
+
+    s = natsConnection_JetStream(js, *conn, nullptr);
+    if (s != NATS_OK) {
+        natsConnection_Destroy(*conn);
+        *conn = nullptr;
+        throw std::runtime_error(std::string("Failed to create JetStream context: ") + natsStatus_GetText(s));
+    }
+}
+
+static void NatsDisconnect(natsConnection *conn, jsCtx *js) {
+    if (js != nullptr) {
+        jsCtx_Destroy(js);
+    }
+    if (conn != nullptr) {
+        natsConnection_Destroy(conn);
+    }
+}
+
+static bool NatsConnectionIsHealthy(natsConnection *conn) {
+    return natsConnection_Status(conn) == NATS_CONN_STATUS_CONNECTED;
+}
+
+// Round trip a PING to the server, so that connections whose server has gone away are
+// detected before a scan waits on them
+static bool NatsConnectionAnswersPing(natsConnection *conn) {
+    return natsConnection_FlushTimeout(conn, NATS_POOL_PING_TIMEOUT_MS) == NATS_OK;
+}
+
+NatsConnectionPool::~NatsConnectionPool() {
+    for (auto &entry : entries) {
+        for (auto &idle : entry.second.idle) {
+            NatsDisconnect(idle.conn, idle.js);
+        }
+    }
+}
+
+shared_ptr<NatsConnectionPool> NatsConnectionPool::Get(ClientContext &context) {
+    return ObjectCache::GetObjectCache(context).GetOrCreate<NatsConnectionPool>(NATS_POOL_CACHE_KEY);
+}
+
+void NatsConnectionPool::EvictIdle(std::chrono::steady_clock::time_point now, vector<IdleConnection> &closed) {
+    for (auto &entry : entries) {
+        auto &idle = entry.second.idle;
+        // Oldest connections are at the front
+        idx_t expired = 0;
+        while (expired < idle.size() && now - idle[expired].idle_since > NATS_POOL_IDLE_TIMEOUT) {
+            closed.push_back(idle[expired]);
+            expired++;
+        }
+        if (expired > 0) {
+            idle.erase(idle.begin(), idle.begin() + expired);
+            entry.second.stats.evictions += expired;
+        }
+    }
+}
+
+void NatsConnectionPool::CloseConnections(vector<IdleConnection> &closed) {
+    for (auto &idle : closed) {
+        NatsDisconnect(idle.conn, idle.js);
+    }
+    closed.clear();
+}
+
+void NatsConnectionPool::Acquire(const string &url, natsConnection *&conn, jsCtx *&js) {
+    vector<IdleConnection> closed;
+    unique_lock<mutex> guard(lock);
+    auto now = std::chrono::steady_clock::now();
+    EvictIdle(now, closed);
+
+    // Entries are never erased, so the reference stays valid while the lock is released
+    auto &entry = entries[url];
+    // Prefer the most recently used connection; drop any that lost their server
+    while (!entry.idle.empty()) {
+        auto idle = entry.idle.back();
+        entry.idle.pop_back();
+        bool healthy = NatsConnectionIsHealthy(idle.conn);
+        if (healthy && now - idle.idle_since > NATS_POOL_PING_AFTER_IDLE) {
+            // Ping and close outside the lock so an unresponsive server does not block other scans
+            guard.unlock();
+            CloseConnections(closed);
+            healthy = NatsConnectionAnswersPing(idle.conn);
+            guard.lock();
+        }
+        if (healthy) {
+            conn = idle.conn;
+            js = idle.js;
+            entry.stats.hits++;
+            entry.stats.active++;
+            guard.unlock();
+            CloseConnections(closed);
+            return;
+        }
+        closed.push_back(idle);
+        entry.stats.evictions++;
+    }
+    entry.stats.misses++;
+    guard.unlock();
+    CloseConnections(closed);
+
+    // Dial outside the lock so a slow server does not block other scans
+    NatsConnect(url, &conn, &js);
+
+    guard.lock();
+    entry.stats.active++;
+}
+
+void NatsConnectionPool::Release(const string &url, natsConnection *conn, jsCtx *js) {
+    vector<IdleConnection> closed;
+    {
+        lock_guard<mutex> guard(lock);
+        auto now = std::chrono::steady_clock::now();
+        EvictIdle(now, closed);
+
+        auto &entry = entries[url];
+        entry.stats.active--;
+        if (!NatsConnectionIsHealthy(conn) || entry.idle.size() >= NATS_POOL_MAX_IDLE_PER_URL) {
+            closed.push_back(IdleConnection {conn, js, now});
+            entry.stats.evictions++;
+        } else {
+            entry.idle.push_back(IdleConnection {conn, js, now});
+        }
+    }
+    // Close outside the lock so a slow close does not block other scans
+    CloseConnections(closed);
+}
+
+vector<NatsPoolStats> NatsConnectionPool::GetStats() {
+    vector<IdleConnection> closed;
+    vector<NatsPoolStats> result;
+    {
+        lock_guard<mutex> guard(lock);
+        EvictIdle(std::chrono::steady_clock::now(), closed);
+
+        for (auto &entry : entries) {
+            NatsPoolStats stats = entry.second.stats;
+            stats.url = entry.first;
+            stats.idle = entry.second.idle.size();
+            result.push_back(std::move(stats));
+        }
+    }
+    CloseConnections(closed);
+    return result;
+}
+
+NatsConnectionLease::NatsConnectionLease(ClientContext &context, string url_p)
+    : pool(NatsConnectionPool::Get(context)), url(std::move(url_p)) {
+    pool->Acquire(url, conn, js);
+}
+
+NatsConnectionLease::~NatsConnectionLease() {
+    pool->Release(url, conn, js);
+}
+
+// nats_pool_stats(): one row per pooled URL
+struct NatsPoolStatsState : public GlobalTableFunctionState {
+    vector<NatsPoolStats> stats;
+    idx_t offset = 0;
+};
+
+static unique_ptr<FunctionData> NatsPoolStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                  vector<LogicalType> &return_types, vector<string> &names) {
+    names.emplace_back("url");
+    return_types.emplace_back(LogicalType(LogicalTypeId::VARCHAR));
+    names.emplace_back("hits");
+    return_types.emplace_back(LogicalType(LogicalTypeId::UBIGINT));
+    names.emplace_back("misses");
+    return_types.emplace_back(LogicalType(LogicalTypeId::UBIGINT));
+    names.emplace_back("evictions");
+    return_types.emplace_back(LogicalType(LogicalTypeId::UBIGINT));
+    names.emplace_back("active");
+    return_types.emplace_back(LogicalType(LogicalTypeId::UBIGINT));
+    names.emplace_back("idle");
+    return_types.emplace_back(LogicalType(LogicalTypeId::UBIGINT));
+    return nullptr;
+}
+
+static unique_ptr<GlobalTableFunctionState> NatsPoolStatsInit(ClientContext &context, TableFunctionInitInput &input) {
+    auto state = make_uniq<NatsPoolStatsState>();
+    state->stats = NatsConnectionPool::Get(context)->GetStats();
+    return state;
+}
+
+static void NatsPoolStatsExecute(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+    auto &state = data_p.global_state->Cast<NatsPoolStatsState>();
+    idx_t count = 0;
+    while (state.offset < state.stats.size() && count < STANDARD_VECTOR_SIZE) {
+        auto &stats = state.stats[state.offset++];
+        output.SetValue(0, count, Value(stats.url));
+        output.SetValue(1, count, Value::UBIGINT(stats.hits));
+        output.SetValue(2, count, Value::UBIGINT(stats.misses));
+        output.SetValue(3, count, Value::UBIGINT(stats.evictions));
+        output.SetValue(4, count, Value::UBIGINT(stats.active));
+        output.SetValue(5, count, Value::UBIGINT(stats.idle));
+        count++;
+    }
+    output.SetCardinality(count);
+}
+
+void NatsPoolStatsFunction::Register(ExtensionLoader &loader) {
+    TableFunction nats_pool_stats("nats_pool_stats", {}, NatsPoolStatsExecute, NatsPoolStatsBind, NatsPoolStatsInit);
+    loader.RegisterFunction(nats_pool_stats);
+}
+
+} // namespace duckdb
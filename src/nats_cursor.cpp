@@ -0,0 +1,198 @@
+#include "nats_cursor.hpp"
+#include "nats_connection_pool.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "yyjson.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+using namespace duckdb_yyjson;
+
+namespace duckdb {
+
+// KV bucket holding the positions of all durable cursors
+static constexpr const char *NATS_CURSOR_BUCKET = "duckdb_nats_cursors";
+
+static constexpr const char *NATS_CURSOR_STATE_KEY = "nats_js_cursors";
+
+static bool IsCursorKeyChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_';
+}
+
+void NatsValidateCursorName(const string &name) {
+    if (name.empty() || !std::all_of(name.begin(), name.end(), IsCursorKeyChar)) {
+        throw std::runtime_error("Invalid cursor name '" + name +
+                                 "': cursor names may only contain letters, digits, '-' and '_'");
+    }
+}
+
+// KV key of a cursor on a stream. Stream names may contain characters that KV keys do not
+// allow, so those are written as '=' followed by their hex code.
+static string CursorKey(const string &name, const string &stream) {
+    static constexpr const char *HEX = "0123456789abcdef";
+    string key = name + ".";
+    for (auto c : stream) {
+        if (IsCursorKeyChar(c)) {
+            key += c;
+        } else {
+            key += '=';
+            key += HEX[(uint8_t(c) >> 4) & 0xF];
+            key += HEX[uint8_t(c) & 0xF];
+        }
+    }
+    return key;
+}
+
+static string FormatCursorValue(const NatsCursorPosition &position) {
+    yyjson_mut_doc *doc = yyjson_mut_doc_new(nullptr);
+    if (doc == nullptr) {
+        throw std::runtime_error("Failed to allocate cursor position");
+    }
+    yyjson_mut_val *root = yyjson_mut_obj(doc);
+    yyjson_mut_doc_set_root(doc, root);
+    yyjson_mut_obj_add_uint(doc, root, "seq", position.seq);
+    yyjson_mut_obj_add_strncpy(doc, root, "subject", position.subject.c_str(), position.subject.size());
+    size_t len = 0;
+    char *json = yyjson_mut_write(doc, 0, &len);
+    yyjson_mut_doc_free(doc);
+    if (json == nullptr) {
+        throw std::runtime_error("Failed to write cursor position");
+    }
+    string value(json, len);
+    free(json);
+    return value;
+}
+
+static bool ParseCursorValue(const char *data, idx_t len, NatsCursorPosition &position) {
+    yyjson_doc *doc = yyjson_read(data, len, 0);
+    if (doc == nullptr) {
+        return false;
+    }
+    yyjson_val *root = yyjson_doc_get_root(doc);
+    yyjson_val *seq = yyjson_obj_get(root, "seq");
+    yyjson_val *subject = yyjson_obj_get(root, "subject");
+    bool valid = yyjson_is_uint(seq) && yyjson_is_str(subject);
+    if (valid) {
+        position.seq = yyjson_get_uint(seq);
+        position.subject = string(yyjson_get_str(subject), yyjson_get_len(subject));
+    }
+    yyjson_doc_free(doc);
+    return valid;
+}
+
+// Open the cursor bucket. Returns nullptr if it does not exist and create is false.
+static kvStore *OpenCursorBucket(jsCtx *js, bool create) {
+    kvStore *kv = nullptr;
+    natsStatus s = js_KeyValue(&kv, js, NATS_CURSOR_BUCKET);
+    if (s == NATS_NOT_FOUND && create) {
+        kvConfig cfg;
+        kvConfig_Init(&cfg);
+        cfg.Bucket = NATS_CURSOR_BUCKET;
+        cfg.History = 1;
+        s = js_CreateKeyValue(&kv, js, &cfg);
+    }
+    if (s == NATS_NOT_FOUND) {
+        return nullptr;
+    }
+    if (s != NATS_OK) {
+        throw std::runtime_error(std::string("Failed to open cursor bucket ") + NATS_CURSOR_BUCKET + ": " +
+                                 natsStatus_GetText(s));
+    }
+    return kv;
+}
+
+bool NatsReadCursor(jsCtx *js, const string &name, const string &stream, NatsCursorPosition &position) {
+    kvStore *kv = OpenCursorBucket(js, false);
+    if (kv == nullptr) {
+        return false;
+    }
+    kvEntry *entry = nullptr;
+    auto key = CursorKey(name, stream);
+    natsStatus s = kvStore_Get(&entry, kv, key.c_str());
+    kvStore_Destroy(kv);
+    if (s == NATS_NOT_FOUND) {
+        return false;
+    }
+    if (s != NATS_OK) {
+        throw std::runtime_error("Failed to read cursor '" + name + "': " + natsStatus_GetText(s));
+    }
+    bool valid = ParseCursorValue(static_cast<const char *>(kvEntry_Value(entry)), idx_t(kvEntry_ValueLen(entry)),
+                                  position);
+    kvEntry_Destroy(entry);
+    if (!valid) {
+        throw std::runtime_error("Invalid position stored for cursor '" + name + "' on stream " + stream);
+    }
+    return true;
+}
+
+shared_ptr<NatsCursorState> NatsCursorState::Get(ClientContext &context) {
+    return context.registered_state->GetOrCreate<NatsCursorState>(NATS_CURSOR_STATE_KEY);
+}
+
+void NatsCursorState::Advance(const string &url, const string &name, const string &stream, const string &subject,
+                              uint64_t seq) {
+    lock_guard<mutex> guard(lock);
+    auto &entry = pending[url + " " + CursorKey(name, stream)];
+    entry.url = url;
+    entry.name = name;
+    entry.stream = stream;
+    entry.position.subject = subject;
+    entry.position.seq = MaxValue<uint64_t>(entry.position.seq, seq);
+}
+
+bool NatsCursorState::GetPending(const string &url, const string &name, const string &stream,
+                                 NatsCursorPosition &position) {
+    lock_guard<mutex> guard(lock);
+    auto entry = pending.find(url + " " + CursorKey(name, stream));
+    if (entry == pending.end()) {
+        return false;
+    }
+    position = entry->second.position;
+    return true;
+}
+
+void NatsCursorState::TransactionCommit(MetaTransaction &transaction, ClientContext &context) {
+    map<string, PendingCursor> committed;
+    {
+        lock_guard<mutex> guard(lock);
+        std::swap(committed, pending);
+    }
+    // Entries are ordered by URL, so each server's bucket is opened once
+    unique_ptr<NatsConnectionLease> connection;
+    kvStore *kv = nullptr;
+    string kv_url;
+    try {
+        for (auto &entry : committed) {
+            auto &cursor = entry.second;
+            if (!kv || kv_url != cursor.url) {
+                if (kv) {
+                    kvStore_Destroy(kv);
+                    kv = nullptr;
+                }
+                connection = make_uniq<NatsConnectionLease>(context, cursor.url);
+                kv = OpenCursorBucket(connection->js, true);
+                kv_url = cursor.url;
+            }
+            auto key = CursorKey(cursor.name, cursor.stream);
+            auto value = FormatCursorValue(cursor.position);
+            natsStatus s = kvStore_PutString(nullptr, kv, key.c_str(), value.c_str());
+            if (s != NATS_OK) {
+                throw std::runtime_error("Failed to store cursor '" + cursor.name + "': " + natsStatus_GetText(s));
+            }
+        }
+    } catch (...) {
+        if (kv) {
+            kvStore_Destroy(kv);
+        }
+        throw;
+    }
+    if (kv) {
+        kvStore_Destroy(kv);
+    }
+}
+
+void NatsCursorState::TransactionRollback(MetaTransaction &transaction, ClientContext &context) {
+    lock_guard<mutex> guard(lock);
+    pending.clear();
+}
+
+} // namespace duckdb
@@ -0,0 +1,879 @@
+#include "nats_fetch.hpp"
+#include "nats_cache.hpp"
+#include "nats_stats.hpp"
+#include "duckdb/common/types/date.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+
+namespace duckdb {
+
+// How long to wait for each reply of a direct get request
+static constexpr int64_t NATS_DIRECT_GET_TIMEOUT_MS = 5000;
+
+// How long a pull request waits for messages before the range is considered drained
+static constexpr int64_t NATS_CONSUMER_FETCH_EXPIRES_MS = 5000;
+
+// Ephemeral scan consumers are removed by the server if the scan dies without deleting them
+static constexpr int64_t NATS_CONSUMER_INACTIVE_THRESHOLD_MS = 30000;
+
+// Literal subjects per multi_last request when the filter matches too many subjects
+// (the server answers at most 1024 subjects per request)
+static constexpr idx_t NATS_MULTI_LAST_MAX_SUBJECTS = 1024;
+
+// Headers set by the server on direct get responses
+static constexpr const char *NATS_HDR_STATUS = "Status";
+static constexpr const char *NATS_HDR_DESCRIPTION = "Description";
+static constexpr const char *NATS_HDR_SUBJECT = "Nats-Subject";
+static constexpr const char *NATS_HDR_SEQUENCE = "Nats-Sequence";
+static constexpr const char *NATS_HDR_TIMESTAMP = "Nats-Time-Stamp";
+static constexpr const char *NATS_HDR_NUM_PENDING = "Nats-Num-Pending";
+static constexpr const char *NATS_HDR_STREAM = "Nats-Stream";
+static constexpr const char *NATS_HDR_LAST_SEQUENCE = "Nats-Last-Sequence";
+static constexpr const char *NATS_HDR_UP_TO_SEQUENCE = "Nats-UpTo-Sequence";
+
+bool NatsIsDirectGetHeader(const char *key) {
+    for (auto header : {NATS_HDR_STREAM, NATS_HDR_SUBJECT, NATS_HDR_SEQUENCE, NATS_HDR_TIMESTAMP,
+                        NATS_HDR_NUM_PENDING, NATS_HDR_LAST_SEQUENCE, NATS_HDR_UP_TO_SEQUENCE}) {
+        if (strcmp(key, header) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool ParseDigits(const char *&p, int count, int &result) {
+    result = 0;
+    for (int i = 0; i < count; i++) {
+        if (*p < '0' || *p > '9') {
+            return false;
+        }
+        result = result * 10 + (*p - '0');
+        p++;
+    }
+    return true;
+}
+
+bool ParseNatsTimestamp(const char *str, int64_t &time_ns) {
+    // Format: YYYY-MM-DDTHH:MM:SS[.fraction](Z|+HH:MM|-HH:MM)
+    const char *p = str;
+    int year, month, day, hour, minute, second;
+    if (!ParseDigits(p, 4, year) || *p++ != '-' || !ParseDigits(p, 2, month) || *p++ != '-' ||
+        !ParseDigits(p, 2, day)) {
+        return false;
+    }
+    if (*p != 'T' && *p != 't' && *p != ' ') {
+        return false;
+    }
+    p++;
+    if (!ParseDigits(p, 2, hour) || *p++ != ':' || !ParseDigits(p, 2, minute) || *p++ != ':' ||
+        !ParseDigits(p, 2, second)) {
+        return false;
+    }
+
+    int64_t fraction_ns = 0;
+    if (*p == '.') {
+        p++;
+        int64_t scale = 100000000;
+        while (*p >= '0' && *p <= '9') {
+            fraction_ns += (*p - '0') * scale;
+            scale /= 10;
+            p++;
+        }
+    }
+
+    int64_t offset_seconds = 0;
+    if (*p == '+' || *p == '-') {
+        int sign = *p == '-' ? -1 : 1;
+        int offset_hour, offset_minute;
+        p++;
+        if (!ParseDigits(p, 2, offset_hour) || *p++ != ':' || !ParseDigits(p, 2, offset_minute)) {
+            return false;
+        }
+        offset_seconds = sign * (offset_hour * 3600 + offset_minute * 60);
+    } else if (*p != 'Z' && *p != 'z') {
+        return false;
+    }
+
+    if (!Date::IsValid(year, month, day)) {
+        return false;
+    }
+    int64_t epoch_seconds = Date::Epoch(Date::FromDate(year, month, day)) + hour * 3600 + minute * 60 + second -
+                            offset_seconds;
+    time_ns = epoch_seconds * 1000000000LL + fraction_ns;
+    return true;
+}
+
+string FormatNatsTimestamp(int64_t time_ns) {
+    // Split into whole seconds and nanoseconds, rounding towards negative infinity
+    int64_t seconds = time_ns / 1000000000LL;
+    int64_t nanos = time_ns % 1000000000LL;
+    if (nanos < 0) {
+        nanos += 1000000000LL;
+        seconds--;
+    }
+    int64_t days = seconds / 86400;
+    int64_t seconds_of_day = seconds % 86400;
+    if (seconds_of_day < 0) {
+        seconds_of_day += 86400;
+        days--;
+    }
+
+    int32_t year, month, day;
+    Date::Convert(Date::EpochDaysToDate(static_cast<int32_t>(days)), year, month, day);
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%04d-%02d-%02dT%02d:%02d:%02d.%09lldZ", year, month, day,
+             static_cast<int>(seconds_of_day / 3600), static_cast<int>(seconds_of_day / 60 % 60),
+             static_cast<int>(seconds_of_day % 60), static_cast<long long>(nanos));
+    return buffer;
+}
+
+NatsTimeSeekResult NatsDirectGetSeekTime(natsConnection *conn, const string &stream_name, int64_t time_ns,
+                                         uint64_t &seq) {
+    string api_subject = "$JS.API.DIRECT.GET." + stream_name;
+    string request = "{\"start_time\":\"" + FormatNatsTimestamp(time_ns) + "\"}";
+
+    natsMsg *reply = nullptr;
+    natsStatus s = natsConnection_Request(&reply, conn, api_subject.c_str(), request.data(),
+                                          static_cast<int>(request.size()), NATS_DIRECT_GET_TIMEOUT_MS);
+    if (s != NATS_OK) {
+        throw std::runtime_error(std::string("Failed to send direct get request for stream ") + stream_name + ": " +
+                                 natsStatus_GetText(s));
+    }
+
+    // 404 means no message at or after the time. Servers before 2.11 ignore start_time and
+    // reject the request as empty (408).
+    const char *status = nullptr;
+    if (natsMsg_GetDataLength(reply) == 0 && natsMsgHeader_Get(reply, NATS_HDR_STATUS, &status) == NATS_OK) {
+        bool not_found = string(status) == "404";
+        natsMsg_Destroy(reply);
+        return not_found ? NatsTimeSeekResult::NOT_FOUND : NatsTimeSeekResult::UNSUPPORTED;
+    }
+
+    const char *seq_str = nullptr;
+    bool has_seq = natsMsgHeader_Get(reply, NATS_HDR_SEQUENCE, &seq_str) == NATS_OK;
+    if (has_seq) {
+        seq = std::strtoull(seq_str, nullptr, 10);
+    }
+    natsMsg_Destroy(reply);
+    return has_seq ? NatsTimeSeekResult::FOUND : NatsTimeSeekResult::UNSUPPORTED;
+}
+
+NatsFollowFetcher::NatsFollowFetcher(jsCtx *js, string stream_name_p, const string &subject_filter, uint64_t start_seq)
+    : stream_name(std::move(stream_name_p)) {
+    jsSubOptions sub_opts;
+    jsSubOptions_Init(&sub_opts);
+    sub_opts.Stream = stream_name.c_str();
+    sub_opts.Ordered = true;
+    sub_opts.Config.DeliverPolicy = js_DeliverByStartSequence;
+    sub_opts.Config.OptStartSeq = start_seq;
+
+    jsErrCode jerr = static_cast<jsErrCode>(0);
+    auto subject = subject_filter.empty() ? ">" : subject_filter.c_str();
+    natsStatus s = js_SubscribeSync(&sub, js, subject, nullptr, &sub_opts, &jerr);
+    if (s != NATS_OK) {
+        throw std::runtime_error(std::string("Failed to follow stream ") + stream_name + ": " + natsStatus_GetText(s));
+    }
+}
+
+NatsFollowFetcher::~NatsFollowFetcher() {
+    if (sub != nullptr) {
+        // Unsubscribing deletes the ephemeral ordered consumer
+        natsSubscription_Unsubscribe(sub);
+        natsSubscription_Destroy(sub);
+        sub = nullptr;
+    }
+}
+
+void NatsFollowFetcher::Append(natsMsg *msg, vector<NatsFetchedMessage> &out) {
+    jsMsgMetaData *meta = nullptr;
+    natsStatus s = natsMsg_GetMetaData(&meta, msg);
+    if (s != NATS_OK) {
+        natsMsg_Destroy(msg);
+        throw std::runtime_error(std::string("Failed to read followed message metadata: ") + natsStatus_GetText(s));
+    }
+    out.push_back(NatsFetchedMessage {msg, natsMsg_GetSubject(msg), meta->Sequence.Stream, meta->Timestamp});
+    jsMsgMetaData_Destroy(meta);
+}
+
+bool NatsFollowFetcher::Fetch(int64_t wait_ms, idx_t max_msgs, vector<NatsFetchedMessage> &out) {
+    natsMsg *msg = nullptr;
+    natsStatus s = natsSubscription_NextMsg(&msg, sub, MaxValue<int64_t>(1, wait_ms));
+    if (s == NATS_TIMEOUT) {
+        return false;
+    }
+    if (s != NATS_OK) {
+        throw std::runtime_error(std::string("Failed to follow stream ") + stream_name + ": " + natsStatus_GetText(s));
+    }
+    Append(msg, out);
+
+    // Take what has already been delivered without waiting for more
+    idx_t fetched = 1;
+    while (fetched < max_msgs) {
+        int pending_msgs = 0;
+        int pending_bytes = 0;
+        s = natsSubscription_GetPending(sub, &pending_msgs, &pending_bytes);
+        if (s != NATS_OK || pending_msgs <= 0) {
+            break;
+        }
+        s = natsSubscription_NextMsg(&msg, sub, 1);
+        if (s != NATS_OK) {
+            break;
+        }
+        Append(msg, out);
+        fetched++;
+    }
+    return true;
+}
+
+vector<string> NatsListStreamNames(jsCtx *js) {
+    jsStreamNamesList *list = nullptr;
+    natsStatus s = js_StreamNames(&list, js, nullptr, nullptr);
+    if (s == NATS_NOT_FOUND) {
+        // No streams at all
+        return vector<string>();
+    }
+    if (s != NATS_OK) {
+        throw std::runtime_error(std::string("Failed to list streams: ") + natsStatus_GetText(s));
+    }
+    vector<string> names;
+    names.reserve(list->Count);
+    for (int i = 0; i < list->Count; i++) {
+        names.emplace_back(list->List[i]);
+    }
+    jsStreamNamesList_Destroy(list);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+jsStreamInfo *NatsGetStreamInfo(jsCtx *js, const string &stream_name, const string &subjects_filter) {
+    jsOptions opts;
+    jsOptions_Init(&opts);
+    if (!subjects_filter.empty()) {
+        opts.Stream.Info.SubjectsFilter = subjects_filter.c_str();
+    }
+
+    jsStreamInfo *info = nullptr;
+    natsStatus s = js_GetStreamInfo(&info, js, stream_name.c_str(), &opts, nullptr);
+    if (s != NATS_OK) {
+        throw std::runtime_error(std::string("Failed to get stream info: ") + natsStatus_GetText(s));
+    }
+    return info;
+}
+
+bool NatsSubjectFilterIsValid(const string &filter) {
+    if (filter.empty()) {
+        return false;
+    }
+    idx_t token_start = 0;
+    while (true) {
+        idx_t token_end = filter.find('.', token_start);
+        bool last = token_end == string::npos;
+        if (last) {
+            token_end = filter.size();
+        }
+        idx_t token_len = token_end - token_start;
+        if (token_len == 0) {
+            return false;
+        }
+        for (idx_t i = token_start; i < token_end; i++) {
+            char c = filter[i];
+            if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+                return false;
+            }
+            // Wildcards must make up a whole token, and '>' must be the last token
+            if ((c == '*' || c == '>') && token_len != 1) {
+                return false;
+            }
+            if (c == '>' && !last) {
+                return false;
+            }
+        }
+        if (last) {
+            return true;
+        }
+        token_start = token_end + 1;
+    }
+}
+
+NatsDirectGetFetcher::NatsDirectGetFetcher(natsConnection *conn_p, jsCtx *js_p, string stream_name_p,
+                                           string subject_filter_p)
+    : conn(conn_p), js(js_p), stream_name(std::move(stream_name_p)), subject_filter(std::move(subject_filter_p)),
+      api_subject("$JS.API.DIRECT.GET." + stream_name) {
+    // Every get asks for the next (matching) message at or after a sequence, so deleted
+    // sequences are skipped by the server instead of costing a round trip each
+    next_by_subject = subject_filter.empty() ? ">" : subject_filter;
+}
+
+NatsDirectGetFetcher::~NatsDirectGetFetcher() {
+    cache_session.reset();
+    if (reply_sub != nullptr) {
+        natsSubscription_Destroy(reply_sub);
+        reply_sub = nullptr;
+    }
+    if (reply_inbox != nullptr) {
+        natsInbox_Destroy(reply_inbox);
+        reply_inbox = nullptr;
+    }
+}
+
+void NatsDirectGetFetcher::SetStream(const string &stream_name_p) {
+    if (stream_name_p == stream_name) {
+        return;
+    }
+    stream_name = stream_name_p;
+    api_subject = "$JS.API.DIRECT.GET." + stream_name;
+    // Batch support is a property of the server and carries over
+    last_mode = LastMode::UNSTARTED;
+    subjects.clear();
+    subject_offset = 0;
+}
+
+void NatsDirectGetFetcher::SetCache(NatsStreamCache *cache) {
+    if (cache_session && &cache_session->cache == cache) {
+        return;
+    }
+    // Ending the session writes the segment it was filling
+    cache_session.reset();
+    if (cache != nullptr) {
+        cache_session = make_uniq<NatsCacheSession>(*cache);
+    }
+}
+
+void NatsDirectGetFetcher::SetStats(NatsScanStats *stats_p) {
+    stats = stats_p;
+}
+
+void NatsDirectGetFetcher::CountMessage(natsMsg *msg) {
+    if (stats != nullptr) {
+        stats->messages_received++;
+        stats->bytes_received += natsMsg_GetDataLength(msg);
+    }
+}
+
+void NatsDirectGetFetcher::DestroyMessages(vector<NatsFetchedMessage> &messages) {
+    for (auto &message : messages) {
+        natsMsg_Destroy(message.msg);
+    }
+    messages.clear();
+}
+
+NatsFetchedMessagesGuard::~NatsFetchedMessagesGuard() {
+    NatsDirectGetFetcher::DestroyMessages(messages);
+}
+
+void NatsDirectGetFetcher::EnsureReplySubscription() {
+    if (reply_sub != nullptr) {
+        return;
+    }
+    natsStatus s = natsInbox_Create(&reply_inbox);
+    if (s != NATS_OK) {
+        throw std::runtime_error(std::string("Failed to create reply inbox: ") + natsStatus_GetText(s));
+    }
+    // Every request gets its own reply subject below the inbox, so replies to an
+    // earlier request can never be mistaken for replies to the current one
+    string wildcard = string(reply_inbox) + ".*";
+    s = natsConnection_SubscribeSync(&reply_sub, conn, wildcard.c_str());
+    if (s != NATS_OK) {
+        throw std::runtime_error(std::string("Failed to subscribe to reply inbox: ") + natsStatus_GetText(s));
+    }
+}
+
+bool NatsDirectGetFetcher::Fetch(uint64_t &next_seq, uint64_t end_seq, idx_t max_msgs,
+                                 vector<NatsFetchedMessage> &out) {
+    if (!cache_session || next_seq > end_seq || max_msgs == 0 || next_seq > cache_session->cache.LastSeq()) {
+        return FetchRemote(next_seq, end_seq, max_msgs, out);
+    }
+    idx_t cached_before = out.size();
+    if (cache_session->Read(next_seq, end_seq, max_msgs, out)) {
+        if (stats != nullptr) {
+            stats->cached_messages += out.size() - cached_before;
+        }
+        return next_seq <= end_seq;
+    }
+
+    // Fetch up to the next cached segment, and cache what the server returned
+    uint64_t start_seq = next_seq;
+    uint64_t fetch_end = MinValue<uint64_t>(end_seq, cache_session->cache.NextCachedSeq(next_seq) - 1);
+    idx_t first = out.size();
+    bool more = FetchRemote(next_seq, fetch_end, max_msgs, out);
+    cache_session->Write(start_seq, more ? next_seq - 1 : fetch_end, out.data() + first, out.size() - first);
+    if (!more && fetch_end < end_seq) {
+        next_seq = fetch_end + 1;
+        return true;
+    }
+    return more;
+}
+
+bool NatsDirectGetFetcher::FetchRemote(uint64_t &next_seq, uint64_t end_seq, idx_t max_msgs,
+                                       vector<NatsFetchedMessage> &out) {
+    if (next_seq > end_seq || max_msgs == 0) {
+        return next_seq <= end_seq;
+    }
+    uint64_t start_ns = NatsNowNanos();
+    bool more = batch_support != BatchSupport::UNSUPPORTED ? FetchBatch(next_seq, end_seq, max_msgs, out)
+                                                           : FetchSingle(next_seq, end_seq, max_msgs, out);
+    if (stats != nullptr) {
+        stats->fetch_ns += NatsNowNanos() - start_ns;
+    }
+    return more;
+}
+
+bool NatsDirectGetFetcher::FetchBatch(uint64_t &next_seq, uint64_t end_seq, idx_t max_msgs,
+                                      vector<NatsFetchedMessage> &out) {
+    // Never ask for more messages than there are sequences left in the range
+    uint64_t batch = max_msgs;
+    if (end_seq - next_seq < batch) {
+        batch = end_seq - next_seq + 1;
+    }
+
+    // Subjects cannot contain quotes or backslashes, so no JSON escaping is needed
+    string request = "{\"seq\":" + std::to_string(next_seq) + ",\"batch\":" + std::to_string(batch) +
+                     ",\"next_by_subj\":\"" + next_by_subject + "\"}";
+
+    uint64_t first_seq = next_seq;
+    idx_t fetched_before = out.size();
+    auto reply = RequestBatch(request, next_seq, end_seq, out, batch_support == BatchSupport::UNKNOWN);
+    if (stats != nullptr) {
+        // Sequences the server passed over between the messages it returned, and the rest
+        // of the range once nothing further matches
+        stats->skipped_gap += (next_seq - first_seq) - (out.size() - fetched_before);
+        if (reply.status == "404") {
+            stats->skipped_gap += end_seq - next_seq + 1;
+        }
+    }
+    if (reply.status.empty()) {
+        // The reply answered a plain next-by-subject get for next_seq
+        batch_support = BatchSupport::UNSUPPORTED;
+        return !reply.past_end && next_seq <= end_seq;
+    }
+    if (reply.status == "204") {
+        // End of batch
+        batch_support = BatchSupport::SUPPORTED;
+        return !reply.past_end && next_seq <= end_seq;
+    }
+    if (reply.status == "404") {
+        // No (matching) message at or after next_seq
+        return false;
+    }
+    throw std::runtime_error("Direct get failed for stream " + stream_name + " at sequence " +
+                             std::to_string(next_seq) + ": " + reply.description);
+}
+
+NatsDirectGetFetcher::BatchReply NatsDirectGetFetcher::RequestBatch(const string &request, uint64_t &next_seq,
+                                                                    uint64_t end_seq,
+                                                                    vector<NatsFetchedMessage> &out,
+                                                                    bool detect_unbatched) {
+    EnsureReplySubscription();
+
+    static std::atomic<uint64_t> request_counter {0};
+    string reply_subject = string(reply_inbox) + "." + std::to_string(++request_counter);
+
+    natsStatus s = natsConnection_PublishRequest(conn, api_subject.c_str(), reply_subject.c_str(), request.data(),
+                                                 static_cast<int>(request.size()));
+    if (s != NATS_OK) {
+        throw std::runtime_error(std::string("Failed to send direct get request for stream ") + stream_name + ": " +
+                                 natsStatus_GetText(s));
+    }
+    if (stats != nullptr) {
+        stats->round_trips++;
+    }
+
+    BatchReply reply;
+    while (true) {
+        natsMsg *msg = nullptr;
+        s = natsSubscription_NextMsg(&msg, reply_sub, NATS_DIRECT_GET_TIMEOUT_MS);
+        if (s == NATS_TIMEOUT) {
+            throw std::runtime_error("Timed out waiting for direct get response from stream " + stream_name);
+        }
+        if (s != NATS_OK) {
+            throw std::runtime_error(std::string("Failed to receive direct get response: ") + natsStatus_GetText(s));
+        }
+
+        // Drop late replies to earlier requests
+        if (reply_subject != natsMsg_GetSubject(msg)) {
+            natsMsg_Destroy(msg);
+            continue;
+        }
+
+        const char *status = nullptr;
+        if (natsMsg_GetDataLength(msg) == 0 && natsMsgHeader_Get(msg, NATS_HDR_STATUS, &status) == NATS_OK) {
+            reply.status = status;
+            const char *description = nullptr;
+            reply.description = natsMsgHeader_Get(msg, NATS_HDR_DESCRIPTION, &description) == NATS_OK
+                                    ? string(description) : reply.status;
+            natsMsg_Destroy(msg);
+            return reply;
+        }
+
+        const char *subject = nullptr;
+        const char *seq_str = nullptr;
+        const char *ts_str = nullptr;
+        int64_t time_ns = 0;
+        if (natsMsgHeader_Get(msg, NATS_HDR_SUBJECT, &subject) != NATS_OK ||
+            natsMsgHeader_Get(msg, NATS_HDR_SEQUENCE, &seq_str) != NATS_OK ||
+            natsMsgHeader_Get(msg, NATS_HDR_TIMESTAMP, &ts_str) != NATS_OK || !ParseNatsTimestamp(ts_str, time_ns)) {
+            natsMsg_Destroy(msg);
+            throw std::runtime_error("Malformed direct get response from stream " + stream_name);
+        }
+        uint64_t seq = std::strtoull(seq_str, nullptr, 10);
+
+        // Batched responses carry the number of pending messages; a plain single-message
+        // reply means the server ignored the batch request
+        const char *pending = nullptr;
+        bool batched = natsMsgHeader_Get(msg, NATS_HDR_NUM_PENDING, &pending) == NATS_OK;
+
+        if (seq > end_seq) {
+            // The batch ran past the end of the range; keep draining until end of batch
+            natsMsg_Destroy(msg);
+            reply.past_end = true;
+        } else {
+            CountMessage(msg);
+            out.push_back(NatsFetchedMessage {msg, subject, seq, time_ns});
+            next_seq = seq + 1;
+        }
+
+        if (!batched && detect_unbatched) {
+            return reply;
+        }
+    }
+}
+
+bool NatsDirectGetFetcher::FetchSingle(uint64_t &next_seq, uint64_t end_seq, idx_t max_msgs,
+                                       vector<NatsFetchedMessage> &out) {
+    idx_t fetched = 0;
+    while (fetched < max_msgs && next_seq <= end_seq) {
+        natsMsg *msg = nullptr;
+
+        // Use direct get to fetch the next (matching) message at or after the sequence
+        jsDirectGetMsgOptions opts;
+        memset(&opts, 0, sizeof(opts));
+        opts.Sequence = next_seq;
+        opts.NextBySubject = next_by_subject.c_str();
+
+        natsStatus s = js_DirectGetMsg(&msg, js, stream_name.c_str(), nullptr, &opts);
+        if (stats != nullptr) {
+            stats->round_trips++;
+        }
+
+        if (s == NATS_NOT_FOUND) {
+            // No (matching) message left in the stream
+            if (stats != nullptr) {
+                stats->skipped_gap += end_seq - next_seq + 1;
+            }
+            return false;
+        }
+
+        if (s != NATS_OK) {
+            throw std::runtime_error(std::string("Failed to fetch message at sequence ") +
+                                     std::to_string(next_seq) + ": " + natsStatus_GetText(s));
+        }
+
+        uint64_t seq = natsMsg_GetSequence(msg);
+        if (seq > end_seq) {
+            if (stats != nullptr) {
+                stats->skipped_gap += end_seq - next_seq + 1;
+            }
+            natsMsg_Destroy(msg);
+            return false;
+        }
+        if (stats != nullptr) {
+            stats->skipped_gap += seq - next_seq;
+        }
+        CountMessage(msg);
+        out.push_back(NatsFetchedMessage {msg, natsMsg_GetSubject(msg), seq, natsMsg_GetTime(msg)});
+        fetched++;
+        next_seq = seq + 1;
+    }
+    return next_seq <= end_seq;
+}
+
+void NatsDirectGetFetcher::LoadSubjects() {
+    jsStreamInfo *info = NatsGetStreamInfo(js, stream_name, next_by_subject);
+    auto stream_subjects = info->State.Subjects;
+    if (stream_subjects != nullptr) {
+        subjects.reserve(stream_subjects->Count);
+        for (int i = 0; i < stream_subjects->Count; i++) {
+            subjects.emplace_back(stream_subjects->List[i].Subject);
+        }
+    }
+    jsStreamInfo_Destroy(info);
+    std::sort(subjects.begin(), subjects.end());
+    subject_offset = 0;
+}
+
+bool NatsDirectGetFetcher::FetchLastPerSubject(uint64_t start_seq, uint64_t end_seq, idx_t max_msgs,
+                                               vector<NatsFetchedMessage> &out) {
+    if (start_seq > end_seq || max_msgs == 0) {
+        return start_seq <= end_seq;
+    }
+    uint64_t start_ns = NatsNowNanos();
+    bool more = FetchLastBatches(start_seq, end_seq, max_msgs, out);
+    if (stats != nullptr) {
+        stats->fetch_ns += NatsNowNanos() - start_ns;
+    }
+    return more;
+}
+
+bool NatsDirectGetFetcher::FetchLastBatches(uint64_t start_seq, uint64_t end_seq, idx_t max_msgs,
+                                            vector<NatsFetchedMessage> &out) {
+    if (last_mode == LastMode::UNSTARTED) {
+        last_mode = LastMode::MULTI_LAST;
+        last_next_seq = start_seq;
+    }
+
+    idx_t fetched_before = out.size();
+    if (last_mode == LastMode::MULTI_LAST) {
+        // One request covers every subject matching the filter, as of end_seq
+        string request = "{\"multi_last\":[\"" + next_by_subject + "\"],\"up_to_seq\":" + std::to_string(end_seq) +
+                         ",\"seq\":" + std::to_string(last_next_seq) + ",\"batch\":" + std::to_string(max_msgs) + "}";
+        auto reply = RequestBatch(request, last_next_seq, end_seq, out, false);
+        if (reply.status == "204") {
+            // A full batch may be followed by more subjects
+            return out.size() - fetched_before == max_msgs;
+        }
+        if (reply.status == "404") {
+            return false;
+        }
+        if (reply.status == "413") {
+            // More matching subjects than the server answers at once: list them and ask for
+            // the last message of a group of subjects at a time
+            last_mode = LastMode::SUBJECT_GROUPS;
+        } else if (reply.status == "408") {
+            // Servers before 2.11 do not know multi_last and reject the request as empty
+            last_mode = LastMode::SINGLE;
+        } else {
+            throw std::runtime_error("Direct get failed for stream " + stream_name + ": " + reply.description);
+        }
+        LoadSubjects();
+        last_next_seq = start_seq;
+    }
+
+    if (last_mode == LastMode::SUBJECT_GROUPS) {
+        while (subject_offset < subjects.size() && out.size() - fetched_before < max_msgs) {
+            idx_t group_end = MinValue<idx_t>(subject_offset + NATS_MULTI_LAST_MAX_SUBJECTS, subjects.size());
+            string request = "{\"multi_last\":[";
+            for (idx_t i = subject_offset; i < group_end; i++) {
+                request += (i > subject_offset ? ",\"" : "\"") + subjects[i] + "\"";
+            }
+            idx_t remaining = max_msgs - (out.size() - fetched_before);
+            request += "],\"up_to_seq\":" + std::to_string(end_seq) + ",\"seq\":" + std::to_string(last_next_seq) +
+                       ",\"batch\":" + std::to_string(remaining) + "}";
+
+            idx_t group_before = out.size();
+            auto reply = RequestBatch(request, last_next_seq, end_seq, out, false);
+            if (reply.status != "204" && reply.status != "404") {
+                throw std::runtime_error("Direct get failed for stream " + stream_name + ": " + reply.description);
+            }
+            if (reply.status == "404" || out.size() - group_before < remaining) {
+                // Group done, the next one starts over at start_seq
+                subject_offset = group_end;
+                last_next_seq = start_seq;
+            }
+        }
+        return subject_offset < subjects.size();
+    }
+
+    // One last-by-subject get per subject. Older servers cannot look up the last message as
+    // of a sequence, so a subject whose last message is past end_seq is walked instead.
+    while (subject_offset < subjects.size() && out.size() - fetched_before < max_msgs) {
+        auto &subject = subjects[subject_offset++];
+        jsDirectGetMsgOptions opts;
+        memset(&opts, 0, sizeof(opts));
+        opts.LastBySubject = subject.c_str();
+
+        natsMsg *msg = nullptr;
+        natsStatus s = js_DirectGetMsg(&msg, js, stream_name.c_str(), nullptr, &opts);
+        if (stats != nullptr) {
+            stats->round_trips++;
+        }
+        if (s == NATS_NOT_FOUND) {
+            continue;
+        }
+        if (s != NATS_OK) {
+            throw std::runtime_error("Failed to fetch last message on subject " + subject + ": " +
+                                     natsStatus_GetText(s));
+        }
+        uint64_t seq = natsMsg_GetSequence(msg);
+        CountMessage(msg);
+        if (seq > end_seq) {
+            natsMsg_Destroy(msg);
+            msg = FetchLastBySubjectWalk(subject, start_seq, end_seq);
+            if (msg == nullptr) {
+                continue;
+            }
+            seq = natsMsg_GetSequence(msg);
+        }
+        if (seq < start_seq) {
+            natsMsg_Destroy(msg);
+            continue;
+        }
+        out.push_back(NatsFetchedMessage {msg, natsMsg_GetSubject(msg), seq, natsMsg_GetTime(msg)});
+    }
+    return subject_offset < subjects.size();
+}
+
+natsMsg *NatsDirectGetFetcher::FetchLastBySubjectWalk(const string &subject, uint64_t start_seq, uint64_t end_seq) {
+    // Step through the subject's messages from start_seq, keeping the latest one at or
+    // before end_seq. Costs a round trip per message of the subject in the range.
+    natsMsg *last = nullptr;
+    uint64_t next_seq = start_seq;
+    while (next_seq <= end_seq) {
+        jsDirectGetMsgOptions opts;
+        memset(&opts, 0, sizeof(opts));
+        opts.Sequence = next_seq;
+        opts.NextBySubject = subject.c_str();
+
+        natsMsg *msg = nullptr;
+        natsStatus s = js_DirectGetMsg(&msg, js, stream_name.c_str(), nullptr, &opts);
+        if (stats != nullptr) {
+            stats->round_trips++;
+        }
+        if (s == NATS_NOT_FOUND) {
+            break;
+        }
+        if (s != NATS_OK) {
+            if (last != nullptr) {
+                natsMsg_Destroy(last);
+            }
+            throw std::runtime_error("Failed to fetch message on subject " + subject + ": " + natsStatus_GetText(s));
+        }
+        uint64_t seq = natsMsg_GetSequence(msg);
+        CountMessage(msg);
+        if (seq > end_seq) {
+            natsMsg_Destroy(msg);
+            break;
+        }
+        if (last != nullptr) {
+            natsMsg_Destroy(last);
+        }
+        last = msg;
+        next_seq = seq + 1;
+    }
+    return last;
+}
+
+NatsConsumerFetcher::NatsConsumerFetcher(jsCtx *js_p, string stream_name_p, const string &subject_filter,
+                                         uint64_t start_seq, int batch_size_p, int64_t max_bytes_p)
+    : js(js_p), stream_name(std::move(stream_name_p)), batch_size(batch_size_p), max_bytes(max_bytes_p) {
+    jsConsumerConfig cfg;
+    jsConsumerConfig_Init(&cfg);
+    if (!subject_filter.empty()) {
+        cfg.FilterSubject = subject_filter.c_str();
+    }
+    cfg.DeliverPolicy = js_DeliverByStartSequence;
+    cfg.OptStartSeq = start_seq;
+    cfg.AckPolicy = js_AckNone;
+    cfg.ReplayPolicy = js_ReplayInstant;
+    cfg.MemoryStorage = true;
+    cfg.Replicas = 1;
+    cfg.InactiveThreshold = NATS_CONSUMER_INACTIVE_THRESHOLD_MS * 1000000LL;
+
+    jsConsumerInfo *info = nullptr;
+    jsErrCode jerr = static_cast<jsErrCode>(0);
+    natsStatus s = js_AddConsumer(&info, js, stream_name.c_str(), &cfg, nullptr, &jerr);
+    if (s != NATS_OK) {
+        throw std::runtime_error(std::string("Failed to create consumer on stream ") + stream_name + ": " +
+                                 natsStatus_GetText(s));
+    }
+    consumer_name = info->Name;
+    // With no matching message at or after start_seq, a pull request would only return once
+    // it expires, so the range is drained before the first fetch
+    done = info->NumPending == 0;
+    jsConsumerInfo_Destroy(info);
+
+    // Bind a pull subscription to the consumer we just created
+    jsSubOptions sub_opts;
+    jsSubOptions_Init(&sub_opts);
+    sub_opts.Stream = stream_name.c_str();
+    sub_opts.Consumer = consumer_name.c_str();
+
+    s = js_PullSubscribe(&sub, js, nullptr, nullptr, nullptr, &sub_opts, &jerr);
+    if (s != NATS_OK) {
+        js_DeleteConsumer(js, stream_name.c_str(), consumer_name.c_str(), nullptr, nullptr);
+        throw std::runtime_error(std::string("Failed to subscribe to consumer on stream ") + stream_name + ": " +
+                                 natsStatus_GetText(s));
+    }
+}
+
+NatsConsumerFetcher::~NatsConsumerFetcher() {
+    if (sub != nullptr) {
+        natsSubscription_Destroy(sub);
+        sub = nullptr;
+    }
+    // The subscription is bound to an existing consumer, so it has to be deleted explicitly
+    if (!consumer_name.empty()) {
+        js_DeleteConsumer(js, stream_name.c_str(), consumer_name.c_str(), nullptr, nullptr);
+    }
+}
+
+bool NatsConsumerFetcher::Fetch(uint64_t end_seq, idx_t max_msgs, vector<NatsFetchedMessage> &out) {
+    uint64_t start_ns = NatsNowNanos();
+    idx_t fetched = 0;
+    while (!done && fetched < max_msgs) {
+        jsFetchRequest request;
+        jsFetchRequest_Init(&request);
+        request.Batch = static_cast<int>(MinValue<idx_t>(idx_t(batch_size), max_msgs - fetched));
+        request.MaxBytes = max_bytes;
+        request.Expires = NATS_CONSUMER_FETCH_EXPIRES_MS * 1000000LL;
+
+        natsMsgList list = {nullptr, 0};
+        natsStatus s = jsSub_FetchRequest(&list, sub, &request);
+        if (stats != nullptr) {
+            stats->round_trips++;
+        }
+        if (s == NATS_TIMEOUT) {
+            // Nothing was delivered before the request expired: the range is drained
+            done = true;
+            break;
+        }
+        if (s != NATS_OK) {
+            throw std::runtime_error(std::string("Failed to fetch from consumer on stream ") + stream_name + ": " +
+                                     natsStatus_GetText(s));
+        }
+
+        for (int i = 0; i < list.Count; i++) {
+            natsMsg *msg = list.Msgs[i];
+            list.Msgs[i] = nullptr;
+
+            jsMsgMetaData *meta = nullptr;
+            s = natsMsg_GetMetaData(&meta, msg);
+            if (s != NATS_OK) {
+                natsMsg_Destroy(msg);
+                natsMsgList_Destroy(&list);
+                throw std::runtime_error(std::string("Failed to read consumer message metadata: ") +
+                                         natsStatus_GetText(s));
+            }
+            uint64_t seq = meta->Sequence.Stream;
+            int64_t time_ns = meta->Timestamp;
+            uint64_t pending = meta->NumPending;
+            jsMsgMetaData_Destroy(meta);
+            if (stats != nullptr) {
+                stats->messages_received++;
+                stats->bytes_received += natsMsg_GetDataLength(msg);
+            }
+
+            if (done || seq > end_seq) {
+                natsMsg_Destroy(msg);
+                done = true;
+                continue;
+            }
+            out.push_back(NatsFetchedMessage {msg, natsMsg_GetSubject(msg), seq, time_ns});
+            fetched++;
+
+            // Nothing left in the stream, or the end of the range was reached
+            if (pending == 0 || seq == end_seq) {
+                done = true;
+            }
+        }
+        natsMsgList_Destroy(&list);
+    }
+    if (stats != nullptr) {
+        stats->fetch_ns += NatsNowNanos() - start_ns;
+    }
+    return !done;
+}
+
+} // namespace duckdb
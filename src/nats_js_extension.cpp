@@ -1,5 +1,12 @@
 #include "nats_js_extension.hpp"
 #include "nats_scan.hpp"
+#include "nats_connection_pool.hpp"
+#include "nats_metadata.hpp"
+#include "nats_cache.hpp"
+#include "nats_publish.hpp"
+#include "nats_stats.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
 #include <nats/nats.h>
 
 namespace duckdb {
@@ -7,6 +14,18 @@ namespace duckdb {
 void NatsJsExtension::Load(ExtensionLoader &loader) {
     // Register table functions
     NatsScanFunction::Register(loader);
+    NatsPoolStatsFunction::Register(loader);
+    NatsMetadataFunctions::Register(loader);
+    NatsScanStatsFunction::Register(loader);
+
+    // Register the COPY TO nats format
+    NatsPublishFunction::Register(loader);
+
+    // Settings
+    auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
+    config.AddExtensionOption(NATS_CACHE_DIRECTORY_SETTING,
+                              "Directory where nats_scan caches fetched stream segments; empty disables the cache",
+                              LogicalType::VARCHAR, Value(""));
 }
 
 std::string NatsJsExtension::Name() {
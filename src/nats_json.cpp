@@ -0,0 +1,597 @@
+#include "nats_json.hpp"
+#include "duckdb/common/case_insensitive_map.hpp"
+#include "duckdb/common/limits.hpp"
+#include "duckdb/common/operator/cast_operators.hpp"
+#include "duckdb/common/operator/string_cast.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/types/vector.hpp"
+#include <cstdlib>
+
+using namespace duckdb_yyjson;
+
+namespace duckdb {
+
+// Split a json_extract path into the keys (or array indexes) to follow from the root
+static vector<string> CompileJsonPath(const string &path) {
+    if (path.empty()) {
+        throw std::runtime_error("json_extract paths must not be empty");
+    }
+
+    vector<string> tokens;
+    if (path[0] == '/') {
+        // JSON pointer (RFC 6901): '/'-separated tokens where "~1" means '/' and "~0" means '~'
+        size_t start = 1;
+        while (true) {
+            size_t end = path.find('/', start);
+            string raw = path.substr(start, end == string::npos ? string::npos : end - start);
+            string token;
+            for (size_t i = 0; i < raw.size(); i++) {
+                if (raw[i] == '~' && i + 1 < raw.size() && (raw[i + 1] == '0' || raw[i + 1] == '1')) {
+                    token += raw[i + 1] == '0' ? '~' : '/';
+                    i++;
+                } else {
+                    token += raw[i];
+                }
+            }
+            tokens.push_back(std::move(token));
+            if (end == string::npos) {
+                break;
+            }
+            start = end + 1;
+        }
+        return tokens;
+    }
+
+    // Dotted path (e.g. "device.id")
+    size_t start = 0;
+    while (true) {
+        size_t end = path.find('.', start);
+        string token = path.substr(start, end == string::npos ? string::npos : end - start);
+        if (token.empty()) {
+            throw std::runtime_error("Invalid json_extract path '" + path + "': empty path segment " +
+                                     "(use a JSON pointer such as '/a.b' for keys that contain dots)");
+        }
+        tokens.push_back(std::move(token));
+        if (end == string::npos) {
+            break;
+        }
+        start = end + 1;
+    }
+    return tokens;
+}
+
+static bool JsonExtractTypeIsSupported(const LogicalType &type) {
+    switch (type.id()) {
+    case LogicalTypeId::VARCHAR:
+    case LogicalTypeId::BOOLEAN:
+    case LogicalTypeId::TINYINT:
+    case LogicalTypeId::SMALLINT:
+    case LogicalTypeId::INTEGER:
+    case LogicalTypeId::BIGINT:
+    case LogicalTypeId::UTINYINT:
+    case LogicalTypeId::USMALLINT:
+    case LogicalTypeId::UINTEGER:
+    case LogicalTypeId::UBIGINT:
+    case LogicalTypeId::FLOAT:
+    case LogicalTypeId::DOUBLE:
+    case LogicalTypeId::TIMESTAMP:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static void AddJsonField(ClientContext &context, vector<NatsJsonField> &fields, const string &path,
+                         const Value &type_name) {
+    NatsJsonField field;
+    field.path = path;
+    field.tokens = CompileJsonPath(path);
+
+    // Column names join the path tokens with underscores, like proto_extract
+    for (auto &token : field.tokens) {
+        if (!field.column_name.empty()) {
+            field.column_name += "_";
+        }
+        field.column_name += token;
+    }
+    if (field.column_name.empty()) {
+        field.column_name = path;
+    }
+
+    if (type_name.IsNull()) {
+        field.type = LogicalType(LogicalTypeId::VARCHAR);
+    } else {
+        if (type_name.type().id() != LogicalTypeId::VARCHAR) {
+            throw std::runtime_error("json_extract type for '" + path + "' must be a type name string");
+        }
+        field.type = TransformStringToLogicalType(StringValue::Get(type_name), context);
+        if (!JsonExtractTypeIsSupported(field.type)) {
+            throw std::runtime_error("Unsupported json_extract type '" + StringValue::Get(type_name) + "' for '" +
+                                     path + "': expected VARCHAR, BOOLEAN, an integer type, FLOAT, DOUBLE or TIMESTAMP");
+        }
+    }
+
+    fields.push_back(std::move(field));
+}
+
+vector<NatsJsonField> ParseJsonExtractFields(ClientContext &context, const Value &param) {
+    vector<NatsJsonField> fields;
+    if (param.IsNull()) {
+        return fields;
+    }
+
+    auto &type = param.type();
+    switch (type.id()) {
+    case LogicalTypeId::LIST: {
+        // ['device_id', 'kw']: untyped fields are returned as VARCHAR
+        for (auto &child : ListValue::GetChildren(param)) {
+            if (child.IsNull() || child.type().id() != LogicalTypeId::VARCHAR) {
+                throw std::runtime_error("json_extract list entries must be path strings");
+            }
+            AddJsonField(context, fields, StringValue::Get(child), Value());
+        }
+        break;
+    }
+    case LogicalTypeId::STRUCT: {
+        // {'kw': 'DOUBLE', 'meter.serial': 'UBIGINT'}
+        auto &child_types = StructType::GetChildTypes(type);
+        auto &children = StructValue::GetChildren(param);
+        for (idx_t i = 0; i < children.size(); i++) {
+            AddJsonField(context, fields, child_types[i].first, children[i]);
+        }
+        break;
+    }
+    case LogicalTypeId::MAP: {
+        // MAP {'kw': 'DOUBLE'}, for paths that are not valid struct keys
+        for (auto &entry : MapValue::GetChildren(param)) {
+            auto &key_value = StructValue::GetChildren(entry);
+            AddJsonField(context, fields, key_value[0].ToString(), key_value[1]);
+        }
+        break;
+    }
+    default:
+        throw std::runtime_error("json_extract must be a list of paths or a struct/map of path -> type");
+    }
+
+    return fields;
+}
+
+bool NatsJsonDecoder::Parse(const char *data, idx_t len) {
+    doc = nullptr;
+
+    // Size the buffer for the worst case of this payload so the pool allocator never runs out
+    idx_t needed = yyjson_read_max_memory_usage(len, 0);
+    if (needed == 0) {
+        return false;
+    }
+    if (needed > buffer_size) {
+        buffer_size = NextPowerOfTwo(needed);
+        buffer = make_unsafe_uniq_array_uninitialized<data_t>(buffer_size);
+    }
+
+    yyjson_alc alc;
+    if (!yyjson_alc_pool_init(&alc, buffer.get(), buffer_size)) {
+        return false;
+    }
+
+    // Without YYJSON_READ_INSITU the input is not modified
+    doc = yyjson_read_opts(const_cast<char *>(data), len, 0, &alc, nullptr);
+    return doc != nullptr;
+}
+
+// Convert a scalar JSON value with DuckDB's cast rules (e.g. "42" -> 42, 1.5 -> 2 for integers)
+template <class T>
+static bool TryConvertJsonValue(yyjson_val *val, T &result) {
+    switch (yyjson_get_type(val)) {
+    case YYJSON_TYPE_NUM:
+        switch (yyjson_get_subtype(val)) {
+        case YYJSON_SUBTYPE_UINT:
+            return TryCast::Operation<uint64_t, T>(yyjson_get_uint(val), result);
+        case YYJSON_SUBTYPE_SINT:
+            return TryCast::Operation<int64_t, T>(yyjson_get_sint(val), result);
+        default:
+            return TryCast::Operation<double, T>(yyjson_get_real(val), result);
+        }
+    case YYJSON_TYPE_BOOL:
+        return TryCast::Operation<bool, T>(yyjson_get_bool(val), result);
+    case YYJSON_TYPE_STR:
+        return TryCast::Operation<string_t, T>(string_t(yyjson_get_str(val), yyjson_get_len(val)), result);
+    default:
+        return false;
+    }
+}
+
+template <class T>
+static void WriteJsonValue(yyjson_val *val, Vector &result, idx_t row) {
+    if (!TryConvertJsonValue<T>(val, FlatVector::GetData<T>(result)[row])) {
+        FlatVector::SetNull(result, row, true);
+    }
+}
+
+// Timestamps are only read from strings (e.g. ISO 8601)
+static void WriteJsonTimestamp(yyjson_val *val, Vector &result, idx_t row) {
+    if (!yyjson_is_str(val) ||
+        !TryCast::Operation<string_t, timestamp_t>(string_t(yyjson_get_str(val), yyjson_get_len(val)),
+                                                   FlatVector::GetData<timestamp_t>(result)[row])) {
+        FlatVector::SetNull(result, row, true);
+    }
+}
+
+// Strings are returned as-is, numbers keep their full precision, and objects/arrays are
+// serialized back to JSON text
+static void WriteJsonString(yyjson_val *val, Vector &result, idx_t row) {
+    auto result_data = FlatVector::GetData<string_t>(result);
+    switch (yyjson_get_type(val)) {
+    case YYJSON_TYPE_STR:
+        result_data[row] = StringVector::AddString(result, yyjson_get_str(val), yyjson_get_len(val));
+        return;
+    case YYJSON_TYPE_BOOL:
+        result_data[row] = StringVector::AddString(result, yyjson_get_bool(val) ? "true" : "false");
+        return;
+    case YYJSON_TYPE_NUM:
+        switch (yyjson_get_subtype(val)) {
+        case YYJSON_SUBTYPE_UINT:
+            result_data[row] = StringCast::Operation<uint64_t>(yyjson_get_uint(val), result);
+            return;
+        case YYJSON_SUBTYPE_SINT:
+            result_data[row] = StringCast::Operation<int64_t>(yyjson_get_sint(val), result);
+            return;
+        default:
+            result_data[row] = StringCast::Operation<double>(yyjson_get_real(val), result);
+            return;
+        }
+    default: {
+        size_t json_len = 0;
+        char *json_str = yyjson_val_write(val, 0, &json_len);
+        if (json_str) {
+            result_data[row] = StringVector::AddString(result, json_str, json_len);
+            free(json_str);
+        } else {
+            FlatVector::SetNull(result, row, true);  // NULL on error
+        }
+        return;
+    }
+    }
+}
+
+static void WriteJsonTyped(yyjson_val *val, const LogicalType &type, Vector &result, idx_t row,
+                           bool case_insensitive);
+
+// Look up an object key, falling back to a case-insensitive match if case_insensitive is set
+static yyjson_val *GetJsonKey(yyjson_val *obj, const string &key, bool case_insensitive) {
+    yyjson_val *val = yyjson_obj_getn(obj, key.c_str(), key.size());
+    if (val || !case_insensitive) {
+        return val;
+    }
+    size_t index, max;
+    yyjson_val *name, *child;
+    yyjson_obj_foreach(obj, index, max, name, child) {
+        if (yyjson_get_len(name) != key.size()) {
+            continue;
+        }
+        const char *str = yyjson_get_str(name);
+        idx_t i = 0;
+        while (i < key.size() && StringUtil::CharacterToLower(str[i]) == StringUtil::CharacterToLower(key[i])) {
+            i++;
+        }
+        if (i == key.size()) {
+            return child;
+        }
+    }
+    return nullptr;
+}
+
+// Objects fill the STRUCT's child vectors by key; other values are NULL
+static void WriteJsonStruct(yyjson_val *val, const LogicalType &type, Vector &result, idx_t row,
+                            bool case_insensitive) {
+    if (!yyjson_is_obj(val)) {
+        FlatVector::SetNull(result, row, true);
+        return;
+    }
+    auto &child_types = StructType::GetChildTypes(type);
+    auto &entries = StructVector::GetEntries(result);
+    for (idx_t i = 0; i < child_types.size(); i++) {
+        auto &key = child_types[i].first;
+        WriteJsonTyped(GetJsonKey(val, key, case_insensitive), child_types[i].second, *entries[i], row,
+                       case_insensitive);
+    }
+}
+
+// Arrays append their elements to the LIST's child vector; other values are NULL
+static void WriteJsonList(yyjson_val *val, const LogicalType &type, Vector &result, idx_t row,
+                          bool case_insensitive) {
+    if (!yyjson_is_arr(val)) {
+        FlatVector::SetNull(result, row, true);
+        return;
+    }
+    idx_t count = yyjson_arr_size(val);
+    idx_t offset = ListVector::GetListSize(result);
+    ListVector::Reserve(result, offset + count);
+    auto &child = ListVector::GetEntry(result);
+    auto &child_type = ListType::GetChildType(type);
+
+    size_t index, max;
+    yyjson_val *element;
+    yyjson_arr_foreach(val, index, max, element) {
+        WriteJsonTyped(element, child_type, child, offset + index, case_insensitive);
+    }
+    FlatVector::GetData<list_entry_t>(result)[row] = list_entry_t(offset, count);
+    ListVector::SetListSize(result, offset + count);
+}
+
+// Write a JSON value as `type`. Missing values and JSON nulls are NULL. STRUCT children are
+// looked up ignoring case if case_insensitive is set.
+static void WriteJsonTyped(yyjson_val *val, const LogicalType &type, Vector &result, idx_t row,
+                           bool case_insensitive) {
+    if (!val || yyjson_is_null(val)) {
+        FlatVector::SetNull(result, row, true);
+        return;
+    }
+
+    switch (type.id()) {
+    case LogicalTypeId::VARCHAR:
+        WriteJsonString(val, result, row);
+        break;
+    case LogicalTypeId::BOOLEAN:
+        WriteJsonValue<bool>(val, result, row);
+        break;
+    case LogicalTypeId::TINYINT:
+        WriteJsonValue<int8_t>(val, result, row);
+        break;
+    case LogicalTypeId::SMALLINT:
+        WriteJsonValue<int16_t>(val, result, row);
+        break;
+    case LogicalTypeId::INTEGER:
+        WriteJsonValue<int32_t>(val, result, row);
+        break;
+    case LogicalTypeId::BIGINT:
+        WriteJsonValue<int64_t>(val, result, row);
+        break;
+    case LogicalTypeId::UTINYINT:
+        WriteJsonValue<uint8_t>(val, result, row);
+        break;
+    case LogicalTypeId::USMALLINT:
+        WriteJsonValue<uint16_t>(val, result, row);
+        break;
+    case LogicalTypeId::UINTEGER:
+        WriteJsonValue<uint32_t>(val, result, row);
+        break;
+    case LogicalTypeId::UBIGINT:
+        WriteJsonValue<uint64_t>(val, result, row);
+        break;
+    case LogicalTypeId::FLOAT:
+        WriteJsonValue<float>(val, result, row);
+        break;
+    case LogicalTypeId::DOUBLE:
+        WriteJsonValue<double>(val, result, row);
+        break;
+    case LogicalTypeId::TIMESTAMP:
+        WriteJsonTimestamp(val, result, row);
+        break;
+    case LogicalTypeId::STRUCT:
+        WriteJsonStruct(val, type, result, row, case_insensitive);
+        break;
+    case LogicalTypeId::LIST:
+        WriteJsonList(val, type, result, row, case_insensitive);
+        break;
+    default:
+        FlatVector::SetNull(result, row, true);
+        break;
+    }
+}
+
+void NatsJsonDecoder::WriteField(const NatsJsonField &field, Vector &result, idx_t row) const {
+    // Follow the path: object keys by name, array elements by index
+    yyjson_val *val = doc ? yyjson_doc_get_root(doc) : nullptr;
+    for (auto &token : field.tokens) {
+        if (!val) {
+            break;
+        }
+        if (yyjson_is_obj(val)) {
+            val = GetJsonKey(val, token, field.case_insensitive_keys);
+        } else if (yyjson_is_arr(val)) {
+            char *end = nullptr;
+            unsigned long long index = strtoull(token.c_str(), &end, 10);
+            bool is_index = !token.empty() && token[0] >= '0' && token[0] <= '9' && *end == '\0';
+            val = is_index ? yyjson_arr_get(val, index) : nullptr;
+        } else {
+            val = nullptr;
+        }
+    }
+
+    // Fields that are not found are NULL
+    WriteJsonTyped(val, field.type, result, row, field.case_insensitive_keys);
+}
+
+// Objects and arrays nested deeper than this are inferred as VARCHAR (JSON text)
+static constexpr idx_t NATS_JSON_AUTO_MAX_DEPTH = 16;
+
+// The values sampled at one position of the documents (a key, or the elements of an array)
+struct NatsJsonSchemaInference::Node {
+    enum class Kind : uint8_t { UNSEEN, BOOLEAN, NUMBER, STRING, OBJECT, ARRAY, MIXED };
+    Kind kind = Kind::UNSEEN;
+
+    // Numbers: whether any was fractional, negative, or above the BIGINT range
+    bool has_real = false;
+    bool has_negative = false;
+    bool has_large = false;
+    // Strings: whether every one parsed as a timestamp
+    bool all_timestamps = true;
+    // Objects: keys in first-seen order
+    vector<std::pair<string, unique_ptr<Node>>> children;
+    case_insensitive_map_t<idx_t> child_index;
+    // Whether this key was seen with more than one spelling
+    bool mixed_spelling = false;
+    // Arrays: the merged elements
+    unique_ptr<Node> element;
+
+    static Kind GetKind(yyjson_val *val) {
+        switch (yyjson_get_type(val)) {
+        case YYJSON_TYPE_BOOL:
+            return Kind::BOOLEAN;
+        case YYJSON_TYPE_NUM:
+            return Kind::NUMBER;
+        case YYJSON_TYPE_STR:
+            return Kind::STRING;
+        case YYJSON_TYPE_OBJ:
+            return Kind::OBJECT;
+        case YYJSON_TYPE_ARR:
+            return Kind::ARRAY;
+        default:
+            return Kind::UNSEEN;
+        }
+    }
+
+    void Add(yyjson_val *val, idx_t depth) {
+        auto val_kind = GetKind(val);
+        if (val_kind == Kind::UNSEEN || kind == Kind::MIXED) {
+            // JSON nulls say nothing about the type
+            return;
+        }
+        if (kind != Kind::UNSEEN && kind != val_kind) {
+            kind = Kind::MIXED;
+            return;
+        }
+        kind = val_kind;
+
+        switch (kind) {
+        case Kind::NUMBER:
+            switch (yyjson_get_subtype(val)) {
+            case YYJSON_SUBTYPE_UINT:
+                has_large = has_large || yyjson_get_uint(val) > uint64_t(NumericLimits<int64_t>::Maximum());
+                break;
+            case YYJSON_SUBTYPE_SINT:
+                has_negative = has_negative || yyjson_get_sint(val) < 0;
+                break;
+            default:
+                has_real = true;
+                break;
+            }
+            break;
+        case Kind::STRING:
+            if (all_timestamps) {
+                timestamp_t ts;
+                all_timestamps = TryCast::Operation<string_t, timestamp_t>(
+                    string_t(yyjson_get_str(val), yyjson_get_len(val)), ts);
+            }
+            break;
+        case Kind::OBJECT: {
+            if (depth >= NATS_JSON_AUTO_MAX_DEPTH) {
+                kind = Kind::MIXED;
+                break;
+            }
+            size_t index, max;
+            yyjson_val *key, *child;
+            yyjson_obj_foreach(val, index, max, key, child) {
+                string name(yyjson_get_str(key), yyjson_get_len(key));
+                if (name.empty()) {
+                    continue;
+                }
+                auto entry = child_index.find(name);
+                if (entry == child_index.end()) {
+                    entry = child_index.emplace(name, children.size()).first;
+                    children.emplace_back(name, make_uniq<Node>());
+                } else if (children[entry->second].first != name) {
+                    children[entry->second].second->mixed_spelling = true;
+                }
+                children[entry->second].second->Add(child, depth + 1);
+            }
+            break;
+        }
+        case Kind::ARRAY: {
+            if (depth >= NATS_JSON_AUTO_MAX_DEPTH) {
+                kind = Kind::MIXED;
+                break;
+            }
+            if (!element) {
+                element = make_uniq<Node>();
+            }
+            size_t index, max;
+            yyjson_val *child;
+            yyjson_arr_foreach(val, index, max, child) {
+                element->Add(child, depth + 1);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    // Whether this key or any key nested in it was seen with more than one spelling
+    bool HasMixedSpelling() const {
+        if (mixed_spelling || (element && element->HasMixedSpelling())) {
+            return true;
+        }
+        for (auto &child : children) {
+            if (child.second->HasMixedSpelling()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    LogicalType GetType() const {
+        switch (kind) {
+        case Kind::BOOLEAN:
+            return LogicalType(LogicalTypeId::BOOLEAN);
+        case Kind::NUMBER:
+            if (has_real || (has_large && has_negative)) {
+                return LogicalType(LogicalTypeId::DOUBLE);
+            }
+            return LogicalType(has_large ? LogicalTypeId::UBIGINT : LogicalTypeId::BIGINT);
+        case Kind::STRING:
+            return LogicalType(all_timestamps ? LogicalTypeId::TIMESTAMP : LogicalTypeId::VARCHAR);
+        case Kind::OBJECT: {
+            if (children.empty()) {
+                break;
+            }
+            child_list_t<LogicalType> child_types;
+            for (auto &child : children) {
+                child_types.emplace_back(child.first, child.second->GetType());
+            }
+            return LogicalType::STRUCT(std::move(child_types));
+        }
+        case Kind::ARRAY:
+            return LogicalType::LIST(element->GetType());
+        default:
+            break;
+        }
+        // Only nulls, empty objects or values of different kinds
+        return LogicalType(LogicalTypeId::VARCHAR);
+    }
+};
+
+NatsJsonSchemaInference::NatsJsonSchemaInference() : root(make_uniq<Node>()) {
+}
+
+NatsJsonSchemaInference::~NatsJsonSchemaInference() {
+}
+
+void NatsJsonSchemaInference::AddSample(const char *data, idx_t len) {
+    yyjson_doc *doc = yyjson_read(data, len, 0);
+    if (!doc) {
+        return;
+    }
+    yyjson_val *val = yyjson_doc_get_root(doc);
+    if (yyjson_is_obj(val)) {
+        root->Add(val, 0);
+    }
+    yyjson_doc_free(doc);
+}
+
+vector<NatsJsonField> NatsJsonSchemaInference::GetFields() const {
+    vector<NatsJsonField> fields;
+    for (auto &child : root->children) {
+        NatsJsonField field;
+        field.path = child.first;
+        field.column_name = child.first;
+        field.type = child.second->GetType();
+        field.tokens.push_back(child.first);
+        field.case_insensitive_keys = child.second->HasMixedSpelling();
+        fields.push_back(std::move(field));
+    }
+    return fields;
+}
+
+} // namespace duckdb
@@ -0,0 +1,171 @@
+#include "nats_metadata.hpp"
+#include "nats_connection_pool.hpp"
+#include "nats_fetch.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include <algorithm>
+
+namespace duckdb {
+
+struct NatsMetadataBindData : public TableFunctionData {
+    string stream_name;
+    string subject_filter;
+    string nats_url = "nats://localhost:4222";
+};
+
+static unique_ptr<NatsMetadataBindData> BindMetadataParameters(TableFunctionBindInput &input) {
+    auto bind_data = make_uniq<NatsMetadataBindData>();
+    bind_data->stream_name = input.inputs[0].GetValue<string>();
+    if (input.inputs.size() > 1) {
+        bind_data->subject_filter = input.inputs[1].GetValue<string>();
+        if (!NatsSubjectFilterIsValid(bind_data->subject_filter)) {
+            throw std::runtime_error("Invalid subject filter '" + bind_data->subject_filter +
+                                     "': expected a NATS subject where '*' matches one token and '>' matches the rest");
+        }
+    }
+    for (auto &kv : input.named_parameters) {
+        if (kv.first == "url") {
+            bind_data->nats_url = StringValue::Get(kv.second);
+        }
+    }
+    return bind_data;
+}
+
+// nats_stream_info(stream): a single row with the stream state
+struct NatsStreamInfoState : public GlobalTableFunctionState {
+    jsStreamState state;
+    bool done = false;
+};
+
+static unique_ptr<FunctionData> NatsStreamInfoBind(ClientContext &context, TableFunctionBindInput &input,
+                                                   vector<LogicalType> &return_types, vector<string> &names) {
+    names.emplace_back("stream");
+    return_types.emplace_back(LogicalType(LogicalTypeId::VARCHAR));
+    names.emplace_back("messages");
+    return_types.emplace_back(LogicalType(LogicalTypeId::UBIGINT));
+    names.emplace_back("bytes");
+    return_types.emplace_back(LogicalType(LogicalTypeId::UBIGINT));
+    names.emplace_back("first_seq");
+    return_types.emplace_back(LogicalType(LogicalTypeId::UBIGINT));
+    names.emplace_back("last_seq");
+    return_types.emplace_back(LogicalType(LogicalTypeId::UBIGINT));
+    names.emplace_back("first_ts");
+    return_types.emplace_back(LogicalType(LogicalTypeId::TIMESTAMP));
+    names.emplace_back("last_ts");
+    return_types.emplace_back(LogicalType(LogicalTypeId::TIMESTAMP));
+    names.emplace_back("num_subjects");
+    return_types.emplace_back(LogicalType(LogicalTypeId::UBIGINT));
+    names.emplace_back("num_deleted");
+    return_types.emplace_back(LogicalType(LogicalTypeId::UBIGINT));
+    names.emplace_back("consumers");
+    return_types.emplace_back(LogicalType(LogicalTypeId::UBIGINT));
+    return BindMetadataParameters(input);
+}
+
+static unique_ptr<GlobalTableFunctionState> NatsStreamInfoInit(ClientContext &context,
+                                                               TableFunctionInitInput &input) {
+    auto &bind_data = input.bind_data->Cast<NatsMetadataBindData>();
+    auto result = make_uniq<NatsStreamInfoState>();
+
+    NatsConnectionLease connection(context, bind_data.nats_url);
+    jsStreamInfo *info = NatsGetStreamInfo(connection.js, bind_data.stream_name);
+    result->state = info->State;
+    // The copied state must not point into the destroyed info
+    result->state.Subjects = nullptr;
+    result->state.Deleted = nullptr;
+    result->state.Lost = nullptr;
+    jsStreamInfo_Destroy(info);
+    return result;
+}
+
+static void NatsStreamInfoExecute(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+    auto &bind_data = data_p.bind_data->Cast<NatsMetadataBindData>();
+    auto &state = data_p.global_state->Cast<NatsStreamInfoState>();
+    if (state.done) {
+        output.SetCardinality(0);
+        return;
+    }
+    auto &stream_state = state.state;
+    bool empty = stream_state.Msgs == 0;
+    output.SetValue(0, 0, Value(bind_data.stream_name));
+    output.SetValue(1, 0, Value::UBIGINT(stream_state.Msgs));
+    output.SetValue(2, 0, Value::UBIGINT(stream_state.Bytes));
+    output.SetValue(3, 0, Value::UBIGINT(stream_state.FirstSeq));
+    output.SetValue(4, 0, Value::UBIGINT(stream_state.LastSeq));
+    output.SetValue(5, 0, empty ? Value(LogicalType::TIMESTAMP) : Value::TIMESTAMP(timestamp_t(stream_state.FirstTime / 1000)));
+    output.SetValue(6, 0, empty ? Value(LogicalType::TIMESTAMP) : Value::TIMESTAMP(timestamp_t(stream_state.LastTime / 1000)));
+    output.SetValue(7, 0, Value::UBIGINT(uint64_t(stream_state.NumSubjects)));
+    output.SetValue(8, 0, Value::UBIGINT(uint64_t(stream_state.NumDeleted)));
+    output.SetValue(9, 0, Value::UBIGINT(uint64_t(stream_state.Consumers)));
+    output.SetCardinality(1);
+    state.done = true;
+}
+
+// nats_subject_counts(stream[, filter]): one row per subject, in subject order
+struct NatsSubjectCountsState : public GlobalTableFunctionState {
+    vector<pair<string, uint64_t>> counts;
+    idx_t offset = 0;
+};
+
+static unique_ptr<FunctionData> NatsSubjectCountsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                      vector<LogicalType> &return_types, vector<string> &names) {
+    names.emplace_back("subject");
+    return_types.emplace_back(LogicalType(LogicalTypeId::VARCHAR));
+    names.emplace_back("messages");
+    return_types.emplace_back(LogicalType(LogicalTypeId::UBIGINT));
+    return BindMetadataParameters(input);
+}
+
+static unique_ptr<GlobalTableFunctionState> NatsSubjectCountsInit(ClientContext &context,
+                                                                  TableFunctionInitInput &input) {
+    auto &bind_data = input.bind_data->Cast<NatsMetadataBindData>();
+    auto result = make_uniq<NatsSubjectCountsState>();
+
+    // Without a filter every subject in the stream is counted
+    NatsConnectionLease connection(context, bind_data.nats_url);
+    string filter = bind_data.subject_filter.empty() ? ">" : bind_data.subject_filter;
+    jsStreamInfo *info = NatsGetStreamInfo(connection.js, bind_data.stream_name, filter);
+    auto subjects = info->State.Subjects;
+    if (subjects != nullptr) {
+        result->counts.reserve(subjects->Count);
+        for (int i = 0; i < subjects->Count; i++) {
+            result->counts.emplace_back(subjects->List[i].Subject, subjects->List[i].Msgs);
+        }
+    }
+    jsStreamInfo_Destroy(info);
+
+    std::sort(result->counts.begin(), result->counts.end());
+    return result;
+}
+
+static void NatsSubjectCountsExecute(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+    auto &state = data_p.global_state->Cast<NatsSubjectCountsState>();
+    idx_t count = 0;
+    while (state.offset < state.counts.size() && count < STANDARD_VECTOR_SIZE) {
+        auto &entry = state.counts[state.offset++];
+        output.SetValue(0, count, Value(entry.first));
+        output.SetValue(1, count, Value::UBIGINT(entry.second));
+        count++;
+    }
+    output.SetCardinality(count);
+}
+
+void NatsMetadataFunctions::Register(ExtensionLoader &loader) {
+    TableFunction nats_stream_info("nats_stream_info", {LogicalType(LogicalTypeId::VARCHAR)}, NatsStreamInfoExecute,
+                                   NatsStreamInfoBind, NatsStreamInfoInit);
+    nats_stream_info.named_parameters["url"] = LogicalType(LogicalTypeId::VARCHAR);
+    loader.RegisterFunction(nats_stream_info);
+
+    TableFunctionSet nats_subject_counts("nats_subject_counts");
+    TableFunction all_subjects({LogicalType(LogicalTypeId::VARCHAR)}, NatsSubjectCountsExecute, NatsSubjectCountsBind,
+                               NatsSubjectCountsInit);
+    all_subjects.named_parameters["url"] = LogicalType(LogicalTypeId::VARCHAR);
+    nats_subject_counts.AddFunction(all_subjects);
+    TableFunction filtered_subjects({LogicalType(LogicalTypeId::VARCHAR), LogicalType(LogicalTypeId::VARCHAR)},
+                                    NatsSubjectCountsExecute, NatsSubjectCountsBind, NatsSubjectCountsInit);
+    filtered_subjects.named_parameters["url"] = LogicalType(LogicalTypeId::VARCHAR);
+    nats_subject_counts.AddFunction(filtered_subjects);
+    loader.RegisterFunction(nats_subject_counts);
+}
+
+} // namespace duckdb
@@ -0,0 +1,106 @@
+#include "nats_prefetch.hpp"
+
+namespace duckdb {
+
+// Upper bound on queued batches, regardless of their size
+static constexpr idx_t NATS_PREFETCH_MAX_BATCHES = 8;
+
+NatsPrefetcher::NatsPrefetcher(unique_ptr<NatsDirectGetFetcher> fetcher_p, const vector<string> &stream_names_p,
+                               NatsClaimMorselFunction claim_morsel_p, idx_t max_bytes_p)
+    : fetcher(std::move(fetcher_p)), stream_names(stream_names_p), claim_morsel(std::move(claim_morsel_p)),
+      max_bytes(max_bytes_p) {
+    thread = std::thread([this]() { Run(); });
+}
+
+NatsPrefetcher::~NatsPrefetcher() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopped = true;
+    }
+    space_ready.notify_all();
+    // A fetch in flight completes (or times out) before the thread notices
+    thread.join();
+
+    for (auto &batch : queue) {
+        NatsDirectGetFetcher::DestroyMessages(batch.messages);
+    }
+}
+
+void NatsPrefetcher::Run() {
+    try {
+        FetchMorsels();
+    } catch (...) {
+        lock_guard<mutex> guard(lock);
+        error = std::current_exception();
+    }
+    {
+        lock_guard<mutex> guard(lock);
+        finished = true;
+    }
+    batch_ready.notify_all();
+}
+
+void NatsPrefetcher::FetchMorsels() {
+    NatsMorsel morsel;
+    while (claim_morsel(morsel)) {
+        fetcher->SetStream(stream_names[morsel.stream_index]);
+        fetcher->SetCache(morsel.cache);
+        uint64_t next_seq = morsel.start_seq;
+        bool more = true;
+        while (more) {
+            NatsPrefetchBatch batch;
+            // Frees the batch's messages if the fetch throws; a queued batch has been moved out
+            NatsFetchedMessagesGuard messages_guard(batch.messages);
+            batch.stream_index = morsel.stream_index;
+            batch.batch_index = morsel.batch_index;
+            more = fetcher->Fetch(next_seq, morsel.end_seq, STANDARD_VECTOR_SIZE, batch.messages);
+            batch.end_of_morsel = !more;
+            // Empty batches are only queued to mark the end of a morsel
+            if (batch.messages.empty() && more) {
+                continue;
+            }
+            for (auto &message : batch.messages) {
+                batch.bytes += natsMsg_GetDataLength(message.msg);
+            }
+            if (!Push(batch)) {
+                return;
+            }
+        }
+    }
+}
+
+bool NatsPrefetcher::Push(NatsPrefetchBatch &batch) {
+    unique_lock<mutex> guard(lock);
+    space_ready.wait(guard, [&]() {
+        return stopped || queue.empty() ||
+               (queue.size() < NATS_PREFETCH_MAX_BATCHES && queued_bytes + batch.bytes <= max_bytes);
+    });
+    if (stopped) {
+        NatsDirectGetFetcher::DestroyMessages(batch.messages);
+        return false;
+    }
+    queued_bytes += batch.bytes;
+    queue.push_back(std::move(batch));
+    guard.unlock();
+    batch_ready.notify_one();
+    return true;
+}
+
+bool NatsPrefetcher::Next(NatsPrefetchBatch &batch) {
+    unique_lock<mutex> guard(lock);
+    batch_ready.wait(guard, [&]() { return !queue.empty() || finished; });
+    if (queue.empty()) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return false;
+    }
+    batch = std::move(queue.front());
+    queue.pop_front();
+    queued_bytes -= batch.bytes;
+    guard.unlock();
+    space_ready.notify_one();
+    return true;
+}
+
+} // namespace duckdb
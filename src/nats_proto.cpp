@@ -0,0 +1,137 @@
+#include "nats_proto.hpp"
+#include "duckdb/common/string_util.hpp"
+#include <google/protobuf/descriptor.pb.h>
+#include <filesystem>
+#include <fstream>
+
+using namespace google::protobuf;
+using namespace google::protobuf::compiler;
+
+namespace duckdb {
+
+static bool IsProtoSourceFile(const string &path) {
+    return StringUtil::EndsWith(StringUtil::Lower(path), ".proto");
+}
+
+shared_ptr<NatsProtoSchema> NatsProtoSchema::Load(const string &path) {
+    auto schema = make_shared_ptr<NatsProtoSchema>();
+
+    if (IsProtoSourceFile(path)) {
+        // Set up source tree to find .proto files
+        schema->source_tree = make_uniq<DiskSourceTree>();
+
+        // Get directory and filename from proto_file path
+        std::filesystem::path proto_path(path);
+        string proto_dir = proto_path.parent_path().string();
+        string proto_filename = proto_path.filename().string();
+
+        // If no directory specified, use current directory
+        if (proto_dir.empty()) {
+            proto_dir = ".";
+        }
+
+        // Map empty virtual path to the directory containing the .proto file
+        schema->source_tree->MapPath("", proto_dir);
+
+        // Set up error collector and importer
+        schema->error_collector = make_uniq<ProtobufErrorCollector>();
+        schema->importer = make_uniq<Importer>(schema->source_tree.get(), schema->error_collector.get());
+
+        // Import the .proto file
+        const FileDescriptor* file_desc = schema->importer->Import(proto_filename);
+        if (!file_desc) {
+            string error_msg = "Failed to import protobuf schema file: " + path;
+            if (schema->error_collector->HasErrors()) {
+                error_msg += "\n" + schema->error_collector->GetErrors();
+            }
+            throw std::runtime_error(error_msg);
+        }
+
+        schema->pool = schema->importer->pool();
+        schema->files.push_back(file_desc);
+    } else {
+        // Precompiled FileDescriptorSet: no .proto parsing at all
+        std::ifstream input(path, std::ios::binary);
+        if (!input) {
+            throw std::runtime_error("Failed to open protobuf descriptor set: " + path);
+        }
+        FileDescriptorSet descriptor_set;
+        if (!descriptor_set.ParseFromIstream(&input)) {
+            throw std::runtime_error("Failed to parse protobuf descriptor set: " + path +
+                                     " (expected a serialized FileDescriptorSet, or a .proto file)");
+        }
+
+        // protoc writes --include_imports sets in dependency order, so files can be built one by one
+        schema->descriptor_pool = make_uniq<DescriptorPool>();
+        for (const auto &file_proto : descriptor_set.file()) {
+            const FileDescriptor* file_desc = schema->descriptor_pool->BuildFile(file_proto);
+            if (!file_desc) {
+                throw std::runtime_error("Failed to load '" + string(file_proto.name()) + "' from protobuf descriptor set " +
+                                         path + " (generate it with protoc --include_imports)");
+            }
+            schema->files.push_back(file_desc);
+        }
+        schema->pool = schema->descriptor_pool.get();
+    }
+
+    schema->message_factory = make_uniq<DynamicMessageFactory>(schema->pool);
+    return schema;
+}
+
+const Descriptor *NatsProtoSchema::FindMessageType(const string &name) const {
+    // Names relative to a loaded file (e.g. 'Telemetry'), then fully qualified names
+    // (e.g. 'acme.telemetry.Telemetry')
+    for (auto file_desc : files) {
+        const Descriptor* descriptor = file_desc->FindMessageTypeByName(name);
+        if (descriptor) {
+            return descriptor;
+        }
+    }
+    return pool->FindMessageTypeByName(name);
+}
+
+const Message *NatsProtoSchema::GetPrototype(const Descriptor *descriptor) {
+    return message_factory->GetPrototype(descriptor);
+}
+
+namespace {
+
+struct NatsProtoSchemaCacheEntry {
+    std::filesystem::file_time_type mtime;
+    uintmax_t size = 0;
+    shared_ptr<NatsProtoSchema> schema;
+};
+
+} // namespace
+
+shared_ptr<NatsProtoSchema> GetCachedProtoSchema(const string &path) {
+    static mutex cache_lock;
+    static unordered_map<string, NatsProtoSchemaCacheEntry> cache;
+
+    // Files that cannot be inspected are not cached; Load reports the error
+    std::error_code ec;
+    auto absolute_path = std::filesystem::absolute(path, ec);
+    auto mtime = ec ? std::filesystem::file_time_type() : std::filesystem::last_write_time(absolute_path, ec);
+    auto size = ec ? 0 : std::filesystem::file_size(absolute_path, ec);
+    if (ec) {
+        return NatsProtoSchema::Load(path);
+    }
+
+    // Loading under the lock keeps concurrent binds of a new schema from parsing it twice
+    lock_guard<mutex> guard(cache_lock);
+    auto key = absolute_path.lexically_normal().string();
+    auto entry = cache.find(key);
+    if (entry != cache.end() && entry->second.mtime == mtime && entry->second.size == size) {
+        return entry->second.schema;
+    }
+
+    // Queries still holding a replaced schema keep it alive until they finish
+    NatsProtoSchemaCacheEntry new_entry;
+    new_entry.mtime = mtime;
+    new_entry.size = size;
+    new_entry.schema = NatsProtoSchema::Load(path);
+    cache[key] = new_entry;
+    return new_entry.schema;
+}
+
+} // namespace duckdb
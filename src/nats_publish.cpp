@@ -0,0 +1,323 @@
+#include "nats_publish.hpp"
+#include "nats_connection_pool.hpp"
+#include "nats_fetch.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/function/copy_function.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include <nats/nats.h>
+
+namespace duckdb {
+
+// Messages a sink may have in flight before publishing waits for acks
+static constexpr int64_t NATS_PUBLISH_DEFAULT_MAX_PENDING = 65536;
+
+// How long a sink waits for acks, both for room in a full window and when it finishes
+static constexpr int64_t NATS_PUBLISH_ACK_TIMEOUT_MS = 30000;
+
+struct NatsPublishBindData : public TableFunctionData {
+    string nats_url;
+    string stream;        // Expected stream of every message (ExpectStream), empty to not check
+    string subject;       // Subject of every message, when there is no subject column
+    idx_t subject_col = DConstants::INVALID_INDEX;
+    idx_t payload_col = DConstants::INVALID_INDEX;
+    idx_t headers_col = DConstants::INVALID_INDEX;
+    bool multi_value_headers = false;  // headers are MAP(VARCHAR, VARCHAR[]) rather than MAP(VARCHAR, VARCHAR)
+    int64_t max_pending = NATS_PUBLISH_DEFAULT_MAX_PENDING;
+};
+
+struct NatsPublishGlobalState : public GlobalFunctionData {
+};
+
+// Failed acks reported by the library's ack handler thread
+struct NatsPublishErrors {
+    mutex lock;
+    idx_t count = 0;
+    string first;
+};
+
+struct NatsPublishLocalState : public LocalFunctionData {
+    NatsPublishErrors errors;
+    unique_ptr<NatsConnectionLease> connection;
+    jsCtx *js = nullptr;  // Publishing context with the sink's ack window
+    string subject;       // Null-terminated subject of the row being published
+
+    ~NatsPublishLocalState() override {
+        // Drop the context, and any publishes still in flight, before the connection returns to the pool
+        if (js != nullptr) {
+            jsCtx_Destroy(js);
+        }
+    }
+};
+
+static void NatsPublishAckError(jsCtx *js, jsPubAckErr *pae, void *closure) {
+    auto &errors = *static_cast<NatsPublishErrors *>(closure);
+    lock_guard<mutex> guard(errors.lock);
+    if (errors.count++ == 0) {
+        errors.first = pae->ErrText != nullptr ? pae->ErrText : natsStatus_GetText(pae->Err);
+    }
+}
+
+static void ThrowPublishErrors(NatsPublishErrors &errors) {
+    lock_guard<mutex> guard(errors.lock);
+    if (errors.count > 0) {
+        throw std::runtime_error(std::to_string(errors.count) + " published message(s) were not stored: " +
+                                 errors.first);
+    }
+}
+
+static string GetStringOption(const string &name, const vector<Value> &values) {
+    if (values.size() != 1 || values[0].IsNull()) {
+        throw std::runtime_error("COPY option " + StringUtil::Upper(name) + " expects a single value");
+    }
+    return values[0].ToString();
+}
+
+static idx_t FindColumn(const vector<string> &names, const string &option, const string &column) {
+    for (idx_t i = 0; i < names.size(); i++) {
+        if (StringUtil::CIEquals(names[i], column)) {
+            return i;
+        }
+    }
+    throw std::runtime_error("Column '" + column + "' named by " + option + " is not in the copied query");
+}
+
+static unique_ptr<FunctionData> NatsPublishBind(ClientContext &context, CopyFunctionBindInput &input,
+                                                const vector<string> &names, const vector<LogicalType> &sql_types) {
+    auto bind_data = make_uniq<NatsPublishBindData>();
+    bind_data->nats_url = input.info.file_path;
+
+    string subject_column;
+    string payload_column = "payload";
+    string headers_column;
+    for (auto &option : input.info.options) {
+        auto name = StringUtil::Lower(option.first);
+        if (name == "stream") {
+            bind_data->stream = GetStringOption(name, option.second);
+        } else if (name == "subject") {
+            bind_data->subject = GetStringOption(name, option.second);
+        } else if (name == "subject_column") {
+            subject_column = GetStringOption(name, option.second);
+        } else if (name == "payload_column") {
+            payload_column = GetStringOption(name, option.second);
+        } else if (name == "headers_column") {
+            headers_column = GetStringOption(name, option.second);
+        } else if (name == "max_pending") {
+            if (option.second.size() != 1) {
+                throw std::runtime_error("COPY option MAX_PENDING expects a single value");
+            }
+            bind_data->max_pending = option.second[0].GetValue<int64_t>();
+            if (bind_data->max_pending <= 0) {
+                throw std::runtime_error("MAX_PENDING must be greater than 0");
+            }
+        } else {
+            throw std::runtime_error("Unrecognized option '" + option.first + "' for COPY TO nats: expected " +
+                                     "STREAM, SUBJECT, SUBJECT_COLUMN, PAYLOAD_COLUMN, HEADERS_COLUMN or MAX_PENDING");
+        }
+    }
+
+    // Subjects come from a column ('subject' by default) or are the same for every row
+    if (!bind_data->subject.empty() && !subject_column.empty()) {
+        throw std::runtime_error("SUBJECT and SUBJECT_COLUMN cannot both be set");
+    }
+    if (bind_data->subject.empty()) {
+        bind_data->subject_col = FindColumn(names, "SUBJECT_COLUMN", subject_column.empty() ? "subject" : subject_column);
+        if (sql_types[bind_data->subject_col].id() != LogicalTypeId::VARCHAR) {
+            throw std::runtime_error("Subject column '" + names[bind_data->subject_col] + "' must be VARCHAR");
+        }
+    } else if (!NatsSubjectFilterIsValid(bind_data->subject) || bind_data->subject.find_first_of("*>") != string::npos) {
+        throw std::runtime_error("Invalid SUBJECT '" + bind_data->subject + "': expected a NATS subject without wildcards");
+    }
+
+    bind_data->payload_col = FindColumn(names, "PAYLOAD_COLUMN", payload_column);
+    auto payload_type = sql_types[bind_data->payload_col].id();
+    if (payload_type != LogicalTypeId::VARCHAR && payload_type != LogicalTypeId::BLOB) {
+        throw std::runtime_error("Payload column '" + names[bind_data->payload_col] + "' must be VARCHAR or BLOB");
+    }
+
+    // Headers in the layout of nats_scan's headers column, or a single value per header
+    if (!headers_column.empty()) {
+        bind_data->headers_col = FindColumn(names, "HEADERS_COLUMN", headers_column);
+        auto &headers_type = sql_types[bind_data->headers_col];
+        bool valid = headers_type.id() == LogicalTypeId::MAP &&
+                     MapType::KeyType(headers_type).id() == LogicalTypeId::VARCHAR;
+        if (valid) {
+            auto &value_type = MapType::ValueType(headers_type);
+            bind_data->multi_value_headers = value_type.id() == LogicalTypeId::LIST;
+            valid = value_type.id() == LogicalTypeId::VARCHAR ||
+                    (bind_data->multi_value_headers && ListType::GetChildType(value_type).id() == LogicalTypeId::VARCHAR);
+        }
+        if (!valid) {
+            throw std::runtime_error("Headers column '" + names[bind_data->headers_col] +
+                                     "' must be MAP(VARCHAR, VARCHAR) or MAP(VARCHAR, VARCHAR[])");
+        }
+    }
+
+    return bind_data;
+}
+
+static unique_ptr<GlobalFunctionData> NatsPublishInitGlobal(ClientContext &context, FunctionData &bind_data,
+                                                            const string &file_path) {
+    return make_uniq<NatsPublishGlobalState>();
+}
+
+static unique_ptr<LocalFunctionData> NatsPublishInitLocal(ExecutionContext &context, FunctionData &bind_data_p) {
+    auto &bind_data = bind_data_p.Cast<NatsPublishBindData>();
+    auto state = make_uniq<NatsPublishLocalState>();
+    state->connection = make_uniq<NatsConnectionLease>(context.client, bind_data.nats_url);
+
+    // A context of its own per sink, so each one has its own ack window and error handler.
+    // Publishing blocks while the window is full rather than failing.
+    jsOptions options;
+    jsOptions_Init(&options);
+    options.PublishAsync.MaxPending = bind_data.max_pending;
+    options.PublishAsync.StallWait = NATS_PUBLISH_ACK_TIMEOUT_MS;
+    options.PublishAsync.ErrHandler = NatsPublishAckError;
+    options.PublishAsync.ErrHandlerClosure = &state->errors;
+    natsStatus s = natsConnection_JetStream(&state->js, state->connection->conn, &options);
+    if (s != NATS_OK) {
+        state->js = nullptr;
+        throw std::runtime_error(std::string("Failed to create JetStream context: ") + natsStatus_GetText(s));
+    }
+    return state;
+}
+
+// Add the headers of one row to msg. Values come through Value, as headers are rarely set
+// on bulk publishes.
+static void AddPublishHeaders(const NatsPublishBindData &bind_data, Vector &headers, idx_t row, natsMsg *msg) {
+    auto map_value = headers.GetValue(row);
+    if (map_value.IsNull()) {
+        return;
+    }
+    for (auto &entry : MapValue::GetChildren(map_value)) {
+        auto &key_value = StructValue::GetChildren(entry);
+        auto key = key_value[0].ToString();
+        vector<Value> values;
+        if (key_value[1].IsNull()) {
+            continue;
+        } else if (bind_data.multi_value_headers) {
+            values = ListValue::GetChildren(key_value[1]);
+        } else {
+            values.push_back(key_value[1]);
+        }
+        for (auto &value : values) {
+            if (value.IsNull()) {
+                continue;
+            }
+            natsStatus s = natsMsgHeader_Add(msg, key.c_str(), StringValue::Get(value).c_str());
+            if (s != NATS_OK) {
+                throw std::runtime_error("Failed to add header " + key + ": " + natsStatus_GetText(s));
+            }
+        }
+    }
+}
+
+static void NatsPublishSink(ExecutionContext &context, FunctionData &bind_data_p, GlobalFunctionData &gstate,
+                            LocalFunctionData &lstate, DataChunk &input) {
+    auto &bind_data = bind_data_p.Cast<NatsPublishBindData>();
+    auto &state = lstate.Cast<NatsPublishLocalState>();
+
+    // Fail early once the server has rejected a message
+    ThrowPublishErrors(state.errors);
+
+    UnifiedVectorFormat subject_format;
+    UnifiedVectorFormat payload_format;
+    if (bind_data.subject_col != DConstants::INVALID_INDEX) {
+        input.data[bind_data.subject_col].ToUnifiedFormat(input.size(), subject_format);
+    }
+    input.data[bind_data.payload_col].ToUnifiedFormat(input.size(), payload_format);
+    auto payloads = UnifiedVectorFormat::GetData<string_t>(payload_format);
+
+    jsPubOptions pub_options;
+    jsPubOptions_Init(&pub_options);
+    if (!bind_data.stream.empty()) {
+        pub_options.ExpectStream = bind_data.stream.c_str();
+    }
+
+    for (idx_t row = 0; row < input.size(); row++) {
+        const char *subject = bind_data.subject.c_str();
+        if (bind_data.subject_col != DConstants::INVALID_INDEX) {
+            auto idx = subject_format.sel->get_index(row);
+            if (!subject_format.validity.RowIsValid(idx)) {
+                throw std::runtime_error("Cannot publish a row with a NULL subject");
+            }
+            auto &value = UnifiedVectorFormat::GetData<string_t>(subject_format)[idx];
+            state.subject.assign(value.GetData(), value.GetSize());
+            subject = state.subject.c_str();
+        }
+
+        // NULL payloads are published as empty messages
+        const char *data = nullptr;
+        int data_len = 0;
+        auto payload_idx = payload_format.sel->get_index(row);
+        if (payload_format.validity.RowIsValid(payload_idx)) {
+            data = payloads[payload_idx].GetData();
+            data_len = static_cast<int>(payloads[payload_idx].GetSize());
+        }
+
+        natsStatus s;
+        if (bind_data.headers_col == DConstants::INVALID_INDEX) {
+            s = js_PublishAsync(state.js, subject, data, data_len, &pub_options);
+        } else {
+            natsMsg *msg = nullptr;
+            s = natsMsg_Create(&msg, subject, nullptr, data, data_len);
+            if (s == NATS_OK) {
+                try {
+                    AddPublishHeaders(bind_data, input.data[bind_data.headers_col], row, msg);
+                } catch (...) {
+                    natsMsg_Destroy(msg);
+                    throw;
+                }
+                // The library takes ownership of the message on success
+                s = js_PublishMsgAsync(state.js, &msg, &pub_options);
+            }
+            if (msg != nullptr) {
+                natsMsg_Destroy(msg);
+            }
+        }
+        if (s != NATS_OK) {
+            throw std::runtime_error(string("Failed to publish to ") + subject + ": " + natsStatus_GetText(s));
+        }
+    }
+}
+
+// A sink is done once every message it published has been acknowledged
+static void NatsPublishCombine(ExecutionContext &context, FunctionData &bind_data, GlobalFunctionData &gstate,
+                               LocalFunctionData &lstate) {
+    auto &state = lstate.Cast<NatsPublishLocalState>();
+
+    jsPubOptions options;
+    jsPubOptions_Init(&options);
+    options.MaxWait = NATS_PUBLISH_ACK_TIMEOUT_MS;
+    natsStatus s = js_PublishAsyncComplete(state.js, &options);
+    if (s == NATS_TIMEOUT) {
+        throw std::runtime_error("Timed out after " + std::to_string(NATS_PUBLISH_ACK_TIMEOUT_MS) +
+                                 " ms waiting for publish acks");
+    }
+    if (s != NATS_OK) {
+        throw std::runtime_error(std::string("Failed to wait for publish acks: ") + natsStatus_GetText(s));
+    }
+    ThrowPublishErrors(state.errors);
+}
+
+static void NatsPublishFinalize(ClientContext &context, FunctionData &bind_data, GlobalFunctionData &gstate) {
+}
+
+// Rows are published in order by a single sink unless insertion order need not be preserved
+static CopyFunctionExecutionMode NatsPublishExecutionMode(bool preserve_insertion_order, bool supports_type_changes) {
+    return preserve_insertion_order ? CopyFunctionExecutionMode::REGULAR_COPY_TO_FILE
+                                    : CopyFunctionExecutionMode::PARALLEL_COPY_TO_FILE;
+}
+
+void NatsPublishFunction::Register(ExtensionLoader &loader) {
+    CopyFunction nats_copy("nats");
+    nats_copy.copy_to_bind = NatsPublishBind;
+    nats_copy.copy_to_initialize_global = NatsPublishInitGlobal;
+    nats_copy.copy_to_initialize_local = NatsPublishInitLocal;
+    nats_copy.copy_to_sink = NatsPublishSink;
+    nats_copy.copy_to_combine = NatsPublishCombine;
+    nats_copy.copy_to_finalize = NatsPublishFinalize;
+    nats_copy.execution_mode = NatsPublishExecutionMode;
+    loader.RegisterFunction(nats_copy);
+}
+
+} // namespace duckdb
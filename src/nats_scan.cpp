@@ -1,14 +1,40 @@
 #include "nats_scan.hpp"
+#include "nats_connection_pool.hpp"
+#include "nats_fetch.hpp"
+#include "nats_prefetch.hpp"
+#include "nats_json.hpp"
+#include "nats_proto.hpp"
+#include "nats_subject.hpp"
+#include "nats_cursor.hpp"
+#include "nats_cache.hpp"
+#include "nats_compression.hpp"
+#include "nats_stats.hpp"
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/parser/parsed_data/create_table_function_info.hpp"
 #include "duckdb/main/extension/extension_loader.hpp"
 #include "duckdb/common/types/timestamp.hpp"
-#include "yyjson.hpp"
+#include "duckdb/common/types/interval.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/string_map_set.hpp"
+#include "duckdb/common/types/vector.hpp"
+#include "utf8proc_wrapper.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/optimizer/optimizer_extension.hpp"
+#include "duckdb/planner/operator/logical_get.hpp"
+#include "duckdb/planner/operator/logical_projection.hpp"
+#include "duckdb/planner/operator/logical_top_n.hpp"
+#include "duckdb/planner/expression/bound_between_expression.hpp"
+#include "duckdb/planner/expression/bound_cast_expression.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_comparison_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/expression/bound_operator_expression.hpp"
 #include <nats/nats.h>
-#include <google/protobuf/compiler/importer.h>
-#include <google/protobuf/dynamic_message.h>
-#include <google/protobuf/descriptor.h>
-#include <filesystem>
+#include <atomic>
+#include <chrono>
+#include <cmath>
 
 // Windows defines GetMessage as a macro (GetMessageA/GetMessageW)
 // This conflicts with protobuf's Reflection::GetMessage() method
@@ -16,67 +42,123 @@
 #undef GetMessage
 #endif
 
-using namespace duckdb_yyjson;
 using namespace google::protobuf;
-using namespace google::protobuf::compiler;
 
 namespace duckdb {
 
-// Error collector for protobuf schema parsing
-class ProtobufErrorCollector : public MultiFileErrorCollector {
-public:
-    // Protobuf 3.21.x and earlier use AddError with std::string
-    // Protobuf 3.22.x and later use RecordError with absl::string_view
-#if GOOGLE_PROTOBUF_VERSION >= 3022000
-    void RecordError(absl::string_view filename, int line, int column, absl::string_view message) override {
-        errors.push_back(string(filename) + ":" + std::to_string(line) + ":" + std::to_string(column) + ": " + string(message));
-    }
-#else
-    void AddError(const std::string& filename, int line, int column, const std::string& message) override {
-        errors.push_back(filename + ":" + std::to_string(line) + ":" + std::to_string(column) + ": " + message);
-    }
-#endif
+// How nats_scan reads the stream
+enum class NatsScanMode : uint8_t {
+    DIRECT,    // Random access by sequence number using direct get
+    CONSUMER,  // Sequential streaming through an ephemeral pull consumer
+    LAST       // Last message per subject using multi_last direct get
+};
 
-    string GetErrors() const {
-        string result;
-        for (const auto &err : errors) {
-            result += err + "\n";
-        }
-        return result;
+static const char *NatsScanModeName(NatsScanMode mode) {
+    switch (mode) {
+    case NatsScanMode::CONSUMER:
+        return "consumer";
+    case NatsScanMode::LAST:
+        return "last";
+    default:
+        return "direct";
     }
+}
 
-    bool HasErrors() const {
-        return !errors.empty();
-    }
+// Default pull request size for consumer mode
+static constexpr int32_t NATS_SCAN_DEFAULT_BATCH_SIZE = STANDARD_VECTOR_SIZE;
+
+// Subject filters matching more subjects than this are not counted per subject for
+// cardinality estimates, since the subject list would be transferred at every bind
+static constexpr int64_t NATS_SCAN_MAX_ESTIMATE_SUBJECTS = 10000;
+
+// Stream state read at bind time for cardinality estimates
+struct NatsScanStreamStats {
+    uint64_t msgs = 0;
+    uint64_t first_seq = 0;
+    uint64_t last_seq = 0;
+    int64_t first_time = 0;
+    int64_t last_time = 0;
+    // Messages on subjects matching the subject filter (msgs without a filter), or
+    // UINT64_MAX if the filter matches too many subjects to count
+    uint64_t subject_msgs = UINT64_MAX;
+    // Subjects matching the subject filter, or UINT64_MAX if not counted
+    uint64_t subjects = UINT64_MAX;
+};
 
-private:
-    vector<string> errors;
+// A proto_extract path compiled to the field descriptors to follow from the root message
+using ProtobufFieldPath = vector<const FieldDescriptor*>;
+
+// A pushed-down filter on a header_extract column: the header must be present and, unless
+// values is empty (IS NOT NULL), have one of the values (= or IN)
+struct NatsHeaderFilter {
+    idx_t header_index;  // Into header_fields
+    vector<string> values;
 };
 
 // Bind data structure to hold connection and stream information
 struct NatsScanBindData : public TableFunctionData {
-    string stream_name;
-    string subject_filter;
+    vector<string> stream_names;  // Streams to scan, in scan order
+    string subject_filter;  // Filter applied by the server, empty for the whole stream
+    // Client-side filter for subject lists that no single server filter matches exactly
+    shared_ptr<NatsSubjectMatcher> subject_matcher;
     string nats_url;
     uint64_t start_seq;
     uint64_t end_seq;
     int64_t start_time;  // Nanoseconds since epoch, 0 means not set
     int64_t end_time;    // Nanoseconds since epoch, 0 means not set
-    vector<string> json_fields;  // JSON fields to extract
+    vector<NatsJsonField> json_fields;  // JSON fields to extract (compiled paths and output types)
     string proto_file;           // Path to .proto file
     string proto_message;        // Protobuf message type name
     vector<string> proto_fields; // Protobuf field paths to extract (with dot notation)
 
-    // Protobuf schema objects (must be kept alive for the query duration)
-    shared_ptr<DiskSourceTree> proto_source_tree;
-    shared_ptr<ProtobufErrorCollector> proto_error_collector;
-    shared_ptr<Importer> proto_importer;
-    const Descriptor* proto_descriptor = nullptr;  // Owned by importer's descriptor pool
+    // Protobuf schema (shared through the schema cache, kept alive for the query duration)
+    shared_ptr<NatsProtoSchema> proto_schema;
+    const Descriptor* proto_descriptor = nullptr;  // Owned by the schema's descriptor pool
+    vector<ProtobufFieldPath> proto_field_paths;   // Compiled proto_fields, in the same order
+
+    // How payloads are compressed; they are decompressed before they are returned or decoded
+    NatsCompression compression = NatsCompression::NONE;
+
+    // Headers extracted into their own columns, after the payload fields
+    vector<string> header_fields;
+    // Header filters pushed down from WHERE, checked before a message is decoded
+    vector<NatsHeaderFilter> header_filters;
+
+    // Read mode and consumer pull request limits
+    NatsScanMode mode = NatsScanMode::DIRECT;
+    int32_t batch_size = NATS_SCAN_DEFAULT_BATCH_SIZE;
+    int64_t max_bytes = 0;  // 0 means no byte limit
+
+    // Payload bytes each direct get thread may fetch ahead of decoding, 0 disables prefetching
+    int64_t prefetch_bytes = NATS_PREFETCH_DEFAULT_BYTES;
 
-    NatsScanBindData(string stream, string subject, string url, uint64_t start, uint64_t end,
-                     int64_t start_ts, int64_t end_ts, vector<string> json_flds,
+    // Follow mode: keep returning messages published after the scan started
+    bool follow = false;
+    int64_t max_wait_ms = 0;      // How long a chunk that has rows waits for more before it is emitted
+    int64_t idle_timeout_ms = 0;  // End a follow scan after this long without new messages, 0 never
+    uint64_t max_rows = 0;        // End the scan after this many rows, 0 means no limit
+
+    // Scan direction, and the rows each stream needs to return under a pushed-down
+    // ORDER BY seq LIMIT, after which the scan moves on to the next stream (0 means no limit)
+    bool reverse = false;
+    uint64_t stream_limit = 0;
+
+    // Durable cursor: scans start after the position stored for each stream, and the
+    // position advances over the returned rows when the transaction commits
+    string cursor_name;                // Empty without a cursor
+    string cursor_subject;             // Subject filters the positions are valid for, joined by ','
+    vector<uint64_t> cursor_seqs;      // Stored position per stream_names, 0 for none
+
+    // Directory of the segment cache (the nats_cache_directory setting), empty if disabled
+    string cache_directory;
+
+    // Stream state read at bind time, one entry per stream_names
+    vector<NatsScanStreamStats> stream_stats;
+
+    NatsScanBindData(vector<string> streams, string subject, string url, uint64_t start, uint64_t end,
+                     int64_t start_ts, int64_t end_ts, vector<NatsJsonField> json_flds,
                      string proto_f, string proto_msg, vector<string> proto_flds)
-        : stream_name(std::move(stream))
+        : stream_names(std::move(streams))
         , subject_filter(std::move(subject))
         , nats_url(std::move(url))
         , start_seq(start)
@@ -88,10 +170,68 @@ struct NatsScanBindData : public TableFunctionData {
         , proto_message(std::move(proto_msg))
         , proto_fields(std::move(proto_flds)) {
     }
+
+    // Extracted JSON or protobuf fields, which precede the header_extract columns
+    idx_t FieldCount() const {
+        return json_fields.size() + proto_fields.size();
+    }
+};
+
+// Base columns of every nats_scan result, followed by the extracted JSON/protobuf fields
+// and the header_extract columns
+static constexpr idx_t NATS_COL_STREAM = 0;
+static constexpr idx_t NATS_COL_SUBJECT = 1;
+static constexpr idx_t NATS_COL_SEQ = 2;
+static constexpr idx_t NATS_COL_TS = 3;
+static constexpr idx_t NATS_COL_PAYLOAD = 4;
+static constexpr idx_t NATS_COL_HEADERS = 5;
+static constexpr idx_t NATS_BASE_COLUMN_COUNT = 6;
+
+// Maps the columns referenced by the query (projection pushdown) to output chunk columns
+struct NatsScanProjection {
+    idx_t stream_col = DConstants::INVALID_INDEX;
+    idx_t subject_col = DConstants::INVALID_INDEX;
+    idx_t seq_col = DConstants::INVALID_INDEX;
+    idx_t ts_col = DConstants::INVALID_INDEX;
+    idx_t payload_col = DConstants::INVALID_INDEX;
+    idx_t headers_col = DConstants::INVALID_INDEX;
+    // (output column, index into json_fields/proto_fields) for each projected extracted field
+    vector<std::pair<idx_t, idx_t>> field_cols;
+    // (output column, index into header_fields) for each projected header_extract column
+    vector<std::pair<idx_t, idx_t>> header_cols;
+    // Output columns that do not map to a nats_scan column (e.g. row id)
+    vector<idx_t> virtual_cols;
+
+    NatsScanProjection() = default;
+    NatsScanProjection(const vector<column_t> &column_ids, idx_t field_count, idx_t header_count) {
+        for (idx_t out_col = 0; out_col < column_ids.size(); out_col++) {
+            auto column_id = column_ids[out_col];
+            if (column_id == NATS_COL_STREAM) {
+                stream_col = out_col;
+            } else if (column_id == NATS_COL_SUBJECT) {
+                subject_col = out_col;
+            } else if (column_id == NATS_COL_SEQ) {
+                seq_col = out_col;
+            } else if (column_id == NATS_COL_TS) {
+                ts_col = out_col;
+            } else if (column_id == NATS_COL_PAYLOAD) {
+                payload_col = out_col;
+            } else if (column_id == NATS_COL_HEADERS) {
+                headers_col = out_col;
+            } else if (column_id < NATS_BASE_COLUMN_COUNT + field_count) {
+                field_cols.emplace_back(out_col, column_id - NATS_BASE_COLUMN_COUNT);
+            } else if (column_id < NATS_BASE_COLUMN_COUNT + field_count + header_count) {
+                header_cols.emplace_back(out_col, column_id - NATS_BASE_COLUMN_COUNT - field_count);
+            } else {
+                virtual_cols.push_back(out_col);
+            }
+        }
+    }
 };
 
-// Helper function to get the FieldDescriptor for a field path
-static const FieldDescriptor* GetFieldDescriptorForPath(const Descriptor* message_desc, const string& field_path) {
+// Helper function to compile a field path (e.g., "location.zone") into the chain of field
+// descriptors to follow from the root message. Throws if the path does not exist.
+static ProtobufFieldPath CompileProtobufFieldPath(const Descriptor* message_desc, const string& field_path) {
     // Parse field path (e.g., "location.zone")
     vector<string> path_parts;
     size_t start = 0;
@@ -104,106 +244,678 @@ static const FieldDescriptor* GetFieldDescriptorForPath(const Descriptor* messag
     }
     path_parts.push_back(field_path.substr(start));
 
-    // Navigate through nested messages to find the final field
+    // Navigate through nested messages to validate the path
+    ProtobufFieldPath compiled;
     const Descriptor* current_desc = message_desc;
-    const FieldDescriptor* field = nullptr;
-
     for (size_t i = 0; i < path_parts.size(); i++) {
-        field = current_desc->FindFieldByName(path_parts[i]);
+        const FieldDescriptor* field = current_desc->FindFieldByName(path_parts[i]);
         if (!field) {
-            return nullptr;  // Field not found
+            throw std::runtime_error("Field '" + path_parts[i] + "' not found in message type '" +
+                                   string(current_desc->name()) + "' (field path: " + field_path + ")");
         }
+        compiled.push_back(field);
 
-        // If not the last part, navigate to nested message
+        // If not the last part, must be a singular nested message
         if (i < path_parts.size() - 1) {
             if (field->type() != FieldDescriptor::TYPE_MESSAGE) {
-                return nullptr;  // Can't navigate into non-message field
+                throw std::runtime_error("Field '" + path_parts[i] + "' is not a message type, cannot navigate to '" +
+                                       path_parts[i+1] + "' (field path: " + field_path + ")");
+            }
+            if (field->is_repeated()) {
+                throw std::runtime_error("Field '" + path_parts[i] + "' is repeated, cannot navigate to '" +
+                                       path_parts[i+1] + "'; extract '" + path_parts[i] +
+                                       "' as a list instead (field path: " + field_path + ")");
             }
             current_desc = field->message_type();
         }
     }
 
-    return field;
+    return compiled;
 }
 
-// Helper function to map protobuf field type to DuckDB LogicalType
-static LogicalType ProtobufTypeToDuckDBType(const FieldDescriptor* field) {
+static LogicalType ProtobufTypeToDuckDBType(const FieldDescriptor* field, vector<const Descriptor*> &open_messages);
+
+// Map a message type to a STRUCT with one child per field, in declaration order.
+// open_messages holds the messages being mapped further up, to reject recursive schemas.
+static LogicalType ProtobufMessageToDuckDBType(const Descriptor* message_desc, vector<const Descriptor*> &open_messages) {
+    if (std::find(open_messages.begin(), open_messages.end(), message_desc) != open_messages.end()) {
+        throw std::runtime_error("Message type '" + string(message_desc->full_name()) +
+                               "' is recursive and cannot be extracted as a whole; extract its fields with dot notation");
+    }
+    if (message_desc->field_count() == 0) {
+        throw std::runtime_error("Message type '" + string(message_desc->full_name()) +
+                               "' has no fields and cannot be extracted as a struct");
+    }
+
+    open_messages.push_back(message_desc);
+    child_list_t<LogicalType> children;
+    for (int i = 0; i < message_desc->field_count(); i++) {
+        const FieldDescriptor* child = message_desc->field(i);
+        children.emplace_back(string(child->name()), ProtobufTypeToDuckDBType(child, open_messages));
+    }
+    open_messages.pop_back();
+    return LogicalType::STRUCT(std::move(children));
+}
+
+// Helper function to map protobuf field type to DuckDB LogicalType: map fields become MAP,
+// other repeated fields LIST of the element type and nested messages STRUCT
+static LogicalType ProtobufTypeToDuckDBType(const FieldDescriptor* field, vector<const Descriptor*> &open_messages) {
+    if (field->is_map()) {
+        // Map entries are messages with a key and a value field
+        const Descriptor* entry = field->message_type();
+        return LogicalType::MAP(ProtobufTypeToDuckDBType(entry->map_key(), open_messages),
+                                ProtobufTypeToDuckDBType(entry->map_value(), open_messages));
+    }
+    LogicalType type;
     switch (field->type()) {
         case FieldDescriptor::TYPE_STRING:
-            return LogicalType(LogicalTypeId::VARCHAR);
+            type = LogicalType(LogicalTypeId::VARCHAR);
+            break;
         case FieldDescriptor::TYPE_BYTES:
-            return LogicalType(LogicalTypeId::BLOB);
+            type = LogicalType(LogicalTypeId::BLOB);
+            break;
         case FieldDescriptor::TYPE_INT32:
         case FieldDescriptor::TYPE_SINT32:
         case FieldDescriptor::TYPE_SFIXED32:
-            return LogicalType(LogicalTypeId::INTEGER);
+            type = LogicalType(LogicalTypeId::INTEGER);
+            break;
         case FieldDescriptor::TYPE_INT64:
         case FieldDescriptor::TYPE_SINT64:
         case FieldDescriptor::TYPE_SFIXED64:
-            return LogicalType(LogicalTypeId::BIGINT);
+            type = LogicalType(LogicalTypeId::BIGINT);
+            break;
         case FieldDescriptor::TYPE_UINT32:
         case FieldDescriptor::TYPE_FIXED32:
-            return LogicalType(LogicalTypeId::UINTEGER);
+            type = LogicalType(LogicalTypeId::UINTEGER);
+            break;
         case FieldDescriptor::TYPE_UINT64:
         case FieldDescriptor::TYPE_FIXED64:
-            return LogicalType(LogicalTypeId::UBIGINT);
+            type = LogicalType(LogicalTypeId::UBIGINT);
+            break;
         case FieldDescriptor::TYPE_FLOAT:
-            return LogicalType(LogicalTypeId::FLOAT);
+            type = LogicalType(LogicalTypeId::FLOAT);
+            break;
         case FieldDescriptor::TYPE_DOUBLE:
-            return LogicalType(LogicalTypeId::DOUBLE);
+            type = LogicalType(LogicalTypeId::DOUBLE);
+            break;
         case FieldDescriptor::TYPE_BOOL:
-            return LogicalType(LogicalTypeId::BOOLEAN);
+            type = LogicalType(LogicalTypeId::BOOLEAN);
+            break;
         case FieldDescriptor::TYPE_ENUM:
             // Enums are represented as VARCHAR with the enum name
-            return LogicalType(LogicalTypeId::VARCHAR);
+            type = LogicalType(LogicalTypeId::VARCHAR);
+            break;
         case FieldDescriptor::TYPE_MESSAGE:
-            // Nested messages not supported as column types (should be extracted as fields)
-            return LogicalType(LogicalTypeId::VARCHAR);
+        case FieldDescriptor::TYPE_GROUP:
+            type = ProtobufMessageToDuckDBType(field->message_type(), open_messages);
+            break;
         default:
             // Unknown type - default to VARCHAR
-            return LogicalType(LogicalTypeId::VARCHAR);
+            type = LogicalType(LogicalTypeId::VARCHAR);
+            break;
     }
+    // Repeated fields hold a list of the values a singular field would have
+    return field->is_repeated() ? LogicalType::LIST(type) : type;
 }
 
-// Global state for the scan operation
-struct NatsScanGlobalState : public GlobalTableFunctionState {
-    natsConnection *conn = nullptr;
-    jsCtx *js = nullptr;
-    jsStreamInfo *stream_info = nullptr;
-    uint64_t current_seq = 0;
+// Follow mode waits for new messages in slices of this length, so interrupted queries and
+// idle timeouts are noticed promptly
+static constexpr int64_t NATS_FOLLOW_POLL_MS = 100;
+
+// Number of live messages handed to a thread at a time. Each morsel is
+// claimed by exactly one thread and maps to one batch index so that DuckDB can
+// restore sequence order when insertion order must be preserved.
+static constexpr uint64_t NATS_SCAN_MORSEL_SIZE = STANDARD_VECTOR_SIZE;
+
+// Upper bound on the sequence span of one morsel in streams with large deletion gaps
+static constexpr uint64_t NATS_SCAN_MAX_MORSEL_SPAN = 1ULL << 32;
+
+// Resolved scan range of one of the scanned streams
+struct NatsScanStream {
+    jsStreamInfo *info = nullptr;
+    // Scan range [start_seq, end_seq] and the next unclaimed sequence (0 once claimed)
+    uint64_t start_seq = 0;
     uint64_t end_seq = 0;
-    bool done = false;
-    bool timestamps_resolved = false;  // Track if we've resolved timestamps to sequences
+    uint64_t next_seq = 0;
+    // Sequence span of a morsel, widened when deleted sequences leave gaps in the stream
+    uint64_t morsel_span = NATS_SCAN_MORSEL_SIZE;
+    // Segment cache of direct mode scans, if nats_cache_directory is set
+    unique_ptr<NatsStreamCache> cache;
+};
 
-    // Protobuf message factory (created once, reused for all messages)
-    shared_ptr<DynamicMessageFactory> proto_factory;
-    const Message* proto_prototype = nullptr;  // Owned by factory
+// Global state for the scan operation
+// Borrows the metadata connection used to resolve the scan ranges and hands out
+// sequence morsels to the per-thread local states. Streams are claimed one after the
+// other, so batch indices follow (stream, sequence) order; threads that finish the
+// morsels of a stream move on to the next one.
+struct NatsScanGlobalState : public GlobalTableFunctionState {
+    unique_ptr<NatsConnectionLease> connection;
+
+    // One entry per bind_data.stream_names, in the same order
+    mutex lock;
+    vector<NatsScanStream> streams;
+    // First stream with unclaimed morsels (direct) or the stream being read (consumer, last)
+    idx_t current_stream = 0;
+    idx_t next_batch_index = 0;
+    // Streams before progress_stream and sequences of it before progress_seq (after it in
+    // reverse scans) have been claimed (direct) or delivered (consumer, last) and count as
+    // scanned for progress reporting. Read without the lock.
+    std::atomic<idx_t> progress_stream {0};
+    std::atomic<uint64_t> progress_seq {0};
+    idx_t max_threads = 1;
+
+    // Columns referenced by the query
+    NatsScanProjection projection;
+
+    // Consumer mode: one ephemeral consumer shared by all threads, recreated for each
+    // stream. Pull requests are issued under the lock, decoding happens in parallel
+    // outside of it.
+    unique_ptr<NatsConsumerFetcher> consumer;
+    // Last mode: one fetcher on the metadata connection, shared like the consumer
+    unique_ptr<NatsDirectGetFetcher> last_fetcher;
+    const NatsScanBindData *bind_data = nullptr;
+
+    // Follow mode: the first thread to run out of messages follows the stream on the
+    // metadata connection, the other threads finish
+    bool follower_claimed = false;
+    unique_ptr<NatsFollowFetcher> follower;
+    // Rows the scan may still return under max_rows
+    std::atomic<uint64_t> rows_left {UINT64_MAX};
+
+    // Durable cursor: the sequence range each batch covers, in batch index order. The cursor
+    // only advances over batches returned in full, and into the first one that is not yet,
+    // so it never skips rows that another thread has not returned yet.
+    struct CursorBatch {
+        idx_t stream_index;
+        uint64_t end_seq;           // Last sequence the batch covers
+        uint64_t returned_seq = 0;  // Last sequence returned so far
+        bool complete = false;      // Every row of the batch has been returned
+    };
+    shared_ptr<NatsCursorState> cursor_state;
+    vector<CursorBatch> cursor_batches;
+    idx_t cursor_watermark = 0;
+
+    // Protobuf message prototype that each thread instantiates its own message from
+    const Message* proto_prototype = nullptr;  // Owned by the schema's message factory
+
+    // Counters of this scan, added to the instance's scan history when the scan finishes
+    NatsScanStats stats;
+    shared_ptr<NatsScanStatsHistory> stats_history;
+    string stats_streams;
+    string stats_mode;
+    uint64_t start_ns = 0;
 
     ~NatsScanGlobalState() {
-        if (stream_info != nullptr) {
-            jsStreamInfo_Destroy(stream_info);
-            stream_info = nullptr;
+        if (stats_history) {
+            stats_history->Add(NatsScanStatsRecord(stats, std::move(stats_streams), std::move(stats_mode),
+                                                   double(NatsNowNanos() - start_ns) / 1e6));
+        }
+        // Delete the consumer while the JetStream context is still alive
+        consumer.reset();
+        last_fetcher.reset();
+        follower.reset();
+        for (auto &stream : streams) {
+            if (stream.info != nullptr) {
+                jsStreamInfo_Destroy(stream.info);
+                stream.info = nullptr;
+            }
+        }
+    }
+
+    // Claim the next morsel of the sequence ranges. Returns false once every stream is exhausted.
+    bool ClaimMorsel(NatsMorsel &morsel) {
+        lock_guard<mutex> guard(lock);
+        for (; current_stream < streams.size(); current_stream++) {
+            auto &stream = streams[current_stream];
+            if (stream.next_seq == 0 || stream.next_seq > stream.end_seq) {
+                continue;
+            }
+            morsel.stream_index = current_stream;
+            if (bind_data->reverse) {
+                // next_seq is the last unclaimed sequence, morsels are claimed from the end back
+                morsel.end_seq = stream.next_seq;
+                morsel.start_seq = stream.next_seq - stream.start_seq < stream.morsel_span
+                                       ? stream.start_seq
+                                       : stream.next_seq - stream.morsel_span + 1;
+                progress_seq = morsel.end_seq;
+                stream.next_seq = morsel.start_seq == stream.start_seq ? 0 : morsel.start_seq - 1;
+            } else {
+                morsel.start_seq = stream.next_seq;
+                morsel.end_seq = stream.end_seq - stream.next_seq < stream.morsel_span
+                                     ? stream.end_seq
+                                     : stream.next_seq + stream.morsel_span - 1;
+                progress_seq = morsel.start_seq;
+                // Guard against wrap-around when end_seq is the largest representable sequence
+                stream.next_seq = morsel.end_seq == UINT64_MAX ? 0 : morsel.end_seq + 1;
+            }
+            morsel.batch_index = next_batch_index++;
+            morsel.cache = stream.cache.get();
+            AddCursorBatch(current_stream, morsel.end_seq);
+            progress_stream = current_stream;
+            if (bind_data->stream_limit > 0) {
+                // Limited scans often stop after the first morsel, and widen the following
+                // ones to get through sparse matches in few round trips
+                stream.morsel_span = MinValue<uint64_t>(stream.morsel_span * 2, NATS_SCAN_MAX_MORSEL_SPAN);
+            }
+            return true;
+        }
+        progress_stream = streams.size();
+        return false;
+    }
+
+    // Pull the next chunk's worth of messages from the shared consumer (or last-per-subject
+    // fetcher), moving on to the next stream when one is exhausted. All messages of one call
+    // come from one stream and share a batch index, so chunks keep stream order across threads.
+    bool FetchShared(idx_t max_msgs, vector<NatsFetchedMessage> &out, idx_t &stream_index, idx_t &batch_index) {
+        lock_guard<mutex> guard(lock);
+        while (current_stream < streams.size()) {
+            auto &stream = streams[current_stream];
+            auto &stream_name = bind_data->stream_names[current_stream];
+            bool more = false;
+            if (stream.start_seq <= stream.end_seq) {
+                if (bind_data->mode == NatsScanMode::CONSUMER) {
+                    if (!consumer) {
+                        consumer = make_uniq<NatsConsumerFetcher>(connection->js, stream_name,
+                                                                  bind_data->subject_filter, stream.start_seq,
+                                                                  bind_data->batch_size, bind_data->max_bytes);
+                        consumer->SetStats(&stats);
+                    }
+                    more = consumer->Fetch(stream.end_seq, max_msgs, out);
+                } else {
+                    if (!last_fetcher) {
+                        last_fetcher = make_uniq<NatsDirectGetFetcher>(connection->conn, connection->js, stream_name,
+                                                                      bind_data->subject_filter);
+                        last_fetcher->SetStats(&stats);
+                    }
+                    last_fetcher->SetStream(stream_name);
+                    more = last_fetcher->FetchLastPerSubject(stream.start_seq, stream.end_seq, max_msgs, out);
+                }
+            }
+            if (!out.empty()) {
+                stream_index = current_stream;
+                batch_index = next_batch_index++;
+                AddCursorBatch(current_stream, out.back().seq);
+                progress_stream = current_stream;
+                progress_seq = out.back().seq;
+            }
+            if (!more) {
+                consumer.reset();
+                current_stream++;
+                if (current_stream < streams.size()) {
+                    progress_seq = streams[current_stream].start_seq;
+                }
+                progress_stream = current_stream;
+            }
+            if (!out.empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Leave the unclaimed morsels of a stream that has returned every row it needs
+    void EndStream(idx_t stream_index) {
+        lock_guard<mutex> guard(lock);
+        streams[stream_index].next_seq = 0;
+    }
+
+    // Make the calling thread the follower. Returns false if another thread already is.
+    bool ClaimFollower() {
+        lock_guard<mutex> guard(lock);
+        if (follower_claimed) {
+            return false;
+        }
+        follower_claimed = true;
+        return true;
+    }
+
+    // Batch index for rows of stream_index up to end_seq that were fetched outside of
+    // ClaimMorsel and FetchShared
+    idx_t NextBatchIndex(idx_t stream_index, uint64_t end_seq) {
+        lock_guard<mutex> guard(lock);
+        AddCursorBatch(stream_index, end_seq);
+        return next_batch_index++;
+    }
+
+    // Record that the rows of a batch up to returned_seq, or all of them if complete, have
+    // been returned, and move the cursor as far as the returned rows allow
+    void ReturnBatch(idx_t batch_index, uint64_t returned_seq, bool complete) {
+        if (!cursor_state) {
+            return;
         }
-        if (js != nullptr) {
-            jsCtx_Destroy(js);
-            js = nullptr;
+        lock_guard<mutex> guard(lock);
+        auto &batch = cursor_batches[batch_index];
+        batch.returned_seq = MaxValue<uint64_t>(batch.returned_seq, returned_seq);
+        batch.complete = batch.complete || complete;
+        while (cursor_watermark < cursor_batches.size() && cursor_batches[cursor_watermark].complete) {
+            auto &returned = cursor_batches[cursor_watermark++];
+            AdvanceCursor(returned.stream_index, returned.end_seq);
         }
-        if (conn != nullptr) {
-            natsConnection_Destroy(conn);
-            conn = nullptr;
+        if (cursor_watermark < cursor_batches.size() && cursor_batches[cursor_watermark].returned_seq > 0) {
+            // Rows of a batch are returned in sequence order
+            auto &partial = cursor_batches[cursor_watermark];
+            AdvanceCursor(partial.stream_index, partial.returned_seq);
+        }
+    }
+
+    // Reserve up to count of the rows that max_rows still allows. Returns the reserved count.
+    idx_t TakeRows(idx_t count) {
+        uint64_t left = rows_left;
+        while (true) {
+            uint64_t take = MinValue<uint64_t>(left, count);
+            if (rows_left.compare_exchange_weak(left, left - take)) {
+                return take;
+            }
         }
     }
 
     idx_t MaxThreads() const override {
-        return 1; // Single-threaded for now
+        return max_threads;
+    }
+
+private:
+    // Must hold lock. Called for every batch index handed out, in batch index order.
+    void AddCursorBatch(idx_t stream_index, uint64_t end_seq) {
+        if (cursor_state) {
+            cursor_batches.push_back(CursorBatch {stream_index, end_seq});
+        }
+    }
+
+    void AdvanceCursor(idx_t stream_index, uint64_t seq) {
+        if (seq == 0) {
+            return;
+        }
+        cursor_state->Advance(bind_data->nats_url, bind_data->cursor_name, bind_data->stream_names[stream_index],
+                              bind_data->cursor_subject, seq);
+    }
+};
+
+// Keeps the messages of an output chunk alive while its payload column points into them.
+// Attached to the payload vector, so the messages are destroyed when the chunk is reset.
+class NatsMessageBuffer : public VectorBuffer {
+public:
+    NatsMessageBuffer() : VectorBuffer(VectorBufferType::OPAQUE_BUFFER) {
+        messages.reserve(STANDARD_VECTOR_SIZE);
+    }
+    ~NatsMessageBuffer() override {
+        for (auto msg : messages) {
+            natsMsg_Destroy(msg);
+        }
+    }
+
+    vector<natsMsg *> messages;
+};
+
+// Dictionary encoding of the subject column of the chunk being written. Streams have few
+// distinct subjects, so each one is copied once per chunk and rows select it by index.
+struct NatsSubjectDictionary {
+    // Distinct subjects of the chunk; a new vector for every chunk that references it
+    unique_ptr<Vector> dictionary;
+    idx_t size = 0;
+    SelectionVector sel;
+    // Dictionary index by subject, keyed by the strings stored in the dictionary
+    string_map_t<idx_t> entries;
+
+    void Reset() {
+        dictionary = make_uniq<Vector>(LogicalType::VARCHAR, STANDARD_VECTOR_SIZE);
+        size = 0;
+        sel.Initialize(STANDARD_VECTOR_SIZE);
+        entries.clear();
+    }
+
+    void Add(idx_t row, const char *subject) {
+        string_t key(subject, static_cast<uint32_t>(strlen(subject)));
+        auto entry = entries.find(key);
+        if (entry == entries.end()) {
+            auto stored = StringVector::AddString(*dictionary, key);
+            FlatVector::GetData<string_t>(*dictionary)[size] = stored;
+            entry = entries.emplace(stored, size++).first;
+        }
+        sel.set_index(row, entry->second);
+    }
+
+    // Turn the subject column into a dictionary vector over the rows written so far
+    void Finish(Vector &result, idx_t count) {
+        if (count > 0) {
+            result.Dictionary(*dictionary, size, sel, count);
+        }
     }
 };
 
 // Local state for each thread
+// Every thread fetches over its own pooled connection and decodes into its own message instance.
 struct NatsScanLocalState : public LocalTableFunctionState {
+    unique_ptr<NatsConnectionLease> connection;
+    unique_ptr<NatsDirectGetFetcher> fetcher;
+
+    // Messages of the batch currently being written to the output chunk
+    vector<NatsFetchedMessage> messages;
+
+    // With prefetching, the fetcher is owned by a background thread that claims morsels
+    // ahead of this one. prefetch_batch is the batch being written, up to prefetch_offset.
+    unique_ptr<NatsPrefetcher> prefetcher;
+    NatsPrefetchBatch prefetch_batch;
+    idx_t prefetch_offset = 0;
+
+    // Currently claimed morsel, fetched up to current_seq
+    bool has_morsel = false;
+    NatsMorsel morsel;
+    uint64_t current_seq = 0;
+
+    // Reverse scans: the matching messages of the current morsel, written from the back
+    vector<NatsFetchedMessage> reverse_messages;
+
+    // Limited scans: rows returned so far from stream limit_stream
+    idx_t limit_stream = DConstants::INVALID_INDEX;
+    uint64_t stream_rows = 0;
+
+    // Counters of the chunk being written, added to the scan's stats when it is complete
+    uint64_t skipped_filter = 0;
+    uint64_t decode_ns = 0;
+
+    // Stream and batch index of the chunk being written
+    idx_t stream_index = 0;
+    idx_t batch_index = 0;
+
+    // This thread follows the stream for new messages (follow mode)
+    bool following = false;
+
+    // Sequence of the last row written, for durable cursors
+    uint64_t returned_seq = 0;
+
+    // Reusable protobuf message (ParseFromArray clears it before each parse)
+    unique_ptr<Message> proto_message;
+
+    // Reusable JSON parse buffer
+    NatsJsonDecoder json_decoder;
+
+    // Reusable decompression buffer and codec contexts
+    NatsDecompressor decompressor;
+
+    // Message buffer of the chunk being written, owned by its payload and header_extract vectors
+    NatsMessageBuffer *chunk_messages = nullptr;
+    NatsSubjectDictionary subject_dictionary;
+
+    ~NatsScanLocalState() {
+        // Release messages and the reply subscription before the connection returns to the pool
+        NatsDirectGetFetcher::DestroyMessages(messages);
+        NatsDirectGetFetcher::DestroyMessages(reverse_messages);
+        prefetcher.reset();
+        NatsDirectGetFetcher::DestroyMessages(prefetch_batch.messages);
+        fetcher.reset();
+    }
 };
 
+// Read the stream state used to estimate the cardinality of a scan
+static NatsScanStreamStats ReadStreamStats(jsCtx *js, const string &stream_name, const string &subject_filter,
+                                           const NatsSubjectMatcher *subject_matcher) {
+    NatsScanStreamStats stats;
+
+    jsStreamInfo *info = NatsGetStreamInfo(js, stream_name);
+    stats.msgs = info->State.Msgs;
+    stats.first_seq = info->State.FirstSeq;
+    stats.last_seq = info->State.LastSeq;
+    stats.first_time = info->State.FirstTime;
+    stats.last_time = info->State.LastTime;
+    int64_t num_subjects = info->State.NumSubjects;
+    jsStreamInfo_Destroy(info);
+
+    if (subject_filter.empty() && !subject_matcher) {
+        stats.subject_msgs = stats.msgs;
+        stats.subjects = uint64_t(num_subjects);
+    } else if (num_subjects <= NATS_SCAN_MAX_ESTIMATE_SUBJECTS) {
+        // Sum the per-subject counts of the subjects matching the filter
+        info = NatsGetStreamInfo(js, stream_name, subject_filter.empty() ? ">" : subject_filter);
+        stats.subject_msgs = 0;
+        stats.subjects = 0;
+        auto subjects = info->State.Subjects;
+        if (subjects != nullptr) {
+            for (int i = 0; i < subjects->Count; i++) {
+                if (subject_matcher && !subject_matcher->Matches(subjects->List[i].Subject)) {
+                    continue;
+                }
+                stats.subjects++;
+                stats.subject_msgs += subjects->List[i].Msgs;
+            }
+        }
+        jsStreamInfo_Destroy(info);
+    }
+    return stats;
+}
+
+// Match a stream name against a glob pattern where '*' matches any run of characters
+static bool NatsStreamGlobMatches(const string &pattern, const string &name) {
+    idx_t p = 0;
+    idx_t n = 0;
+    // Position after the last '*' seen, and the name position it was matched up to
+    idx_t star = DConstants::INVALID_INDEX;
+    idx_t star_n = 0;
+    while (n < name.size()) {
+        if (p < pattern.size() && pattern[p] == '*') {
+            star = ++p;
+            star_n = n;
+        } else if (p < pattern.size() && pattern[p] == name[n]) {
+            p++;
+            n++;
+        } else if (star != DConstants::INVALID_INDEX) {
+            // Let the last '*' absorb one more character
+            p = star;
+            n = ++star_n;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+        p++;
+    }
+    return p == pattern.size();
+}
+
+// Read the stream_name argument: a stream name or glob, or a list of them
+static vector<string> ReadStreamPatterns(const Value &value) {
+    if (value.IsNull()) {
+        throw std::runtime_error("nats_scan stream_name must not be NULL");
+    }
+    vector<string> patterns;
+    auto &type = value.type();
+    if (type.id() == LogicalTypeId::LIST && (ListType::GetChildType(type).id() == LogicalTypeId::VARCHAR ||
+                                             ListType::GetChildType(type).id() == LogicalTypeId::SQLNULL)) {
+        for (auto &child : ListValue::GetChildren(value)) {
+            if (child.IsNull()) {
+                throw std::runtime_error("nats_scan stream_name list must not contain NULL");
+            }
+            patterns.push_back(StringValue::Get(child));
+        }
+    } else if (type.id() == LogicalTypeId::VARCHAR) {
+        patterns.push_back(StringValue::Get(value));
+    } else {
+        throw std::runtime_error("nats_scan stream_name must be a VARCHAR or a list of VARCHAR, got " +
+                                 type.ToString());
+    }
+    if (patterns.empty()) {
+        throw std::runtime_error("nats_scan requires at least one stream");
+    }
+    return patterns;
+}
+
+// Resolve stream name patterns to the streams to scan. Patterns containing '*' are
+// matched against the server's stream list and expand to their matches in name order.
+// A stream matched more than once is scanned once, at its first position.
+static vector<string> ResolveStreamNames(jsCtx *js, const vector<string> &patterns) {
+    vector<string> stream_names;
+    vector<string> server_streams;
+    bool listed = false;
+    auto add_stream = [&stream_names](const string &name) {
+        if (std::find(stream_names.begin(), stream_names.end(), name) == stream_names.end()) {
+            stream_names.push_back(name);
+        }
+    };
+    for (auto &pattern : patterns) {
+        if (pattern.find('*') == string::npos) {
+            add_stream(pattern);
+            continue;
+        }
+        if (!listed) {
+            server_streams = NatsListStreamNames(js);
+            listed = true;
+        }
+        bool matched = false;
+        for (auto &name : server_streams) {
+            if (NatsStreamGlobMatches(pattern, name)) {
+                add_stream(name);
+                matched = true;
+            }
+        }
+        if (!matched) {
+            throw std::runtime_error("No streams match '" + pattern + "'");
+        }
+    }
+    return stream_names;
+}
+
+// Read a non-negative INTERVAL parameter in milliseconds
+static int64_t ReadIntervalMillis(const string &name, const Value &value) {
+    auto micros = Interval::GetMicro(IntervalValue::Get(value));
+    if (micros < 0) {
+        throw std::runtime_error(name + " must not be negative");
+    }
+    return micros / Interval::MICROS_PER_MSEC;
+}
+
+// Read the subject parameter: a NATS subject filter, or a list of them
+static vector<string> ReadSubjectFilters(const Value &value) {
+    vector<string> filters;
+    if (value.IsNull()) {
+        return filters;
+    }
+    auto &type = value.type();
+    if (type.id() == LogicalTypeId::LIST && (ListType::GetChildType(type).id() == LogicalTypeId::VARCHAR ||
+                                             ListType::GetChildType(type).id() == LogicalTypeId::SQLNULL)) {
+        for (auto &child : ListValue::GetChildren(value)) {
+            if (child.IsNull()) {
+                throw std::runtime_error("subject list must not contain NULL");
+            }
+            filters.push_back(StringValue::Get(child));
+        }
+        if (filters.empty()) {
+            throw std::runtime_error("subject list must not be empty");
+        }
+    } else if (type.id() == LogicalTypeId::VARCHAR) {
+        // An empty subject selects the whole stream
+        auto filter = StringValue::Get(value);
+        if (!filter.empty()) {
+            filters.push_back(std::move(filter));
+        }
+    } else {
+        throw std::runtime_error("subject must be a VARCHAR or a list of VARCHAR, got " + type.ToString());
+    }
+    return filters;
+}
+
 // Bind function - validates parameters and creates bind data
+static vector<NatsJsonField> InferJsonFields(ClientContext &context, const NatsScanBindData &bind_data,
+                                             idx_t sample_size);
+
 static unique_ptr<FunctionData> NatsScanBind(ClientContext &context, TableFunctionBindInput &input,
                                               vector<LogicalType> &return_types, vector<string> &names) {
     // Required parameters
@@ -211,24 +923,38 @@ static unique_ptr<FunctionData> NatsScanBind(ClientContext &context, TableFuncti
         throw std::runtime_error("nats_scan requires at least one argument: stream_name");
     }
 
-    auto stream_name = input.inputs[0].GetValue<string>();
+    auto stream_patterns = ReadStreamPatterns(input.inputs[0]);
 
     // Optional named parameters with defaults
-    string subject_filter = "";
+    vector<string> subject_filters;
     string nats_url = "nats://localhost:4222";
     uint64_t start_seq = 0;
     uint64_t end_seq = UINT64_MAX;
     int64_t start_time = 0;  // 0 means not set
     int64_t end_time = 0;    // 0 means not set
-    vector<string> json_fields;  // JSON fields to extract
+    vector<NatsJsonField> json_fields;  // JSON fields to extract
+    bool json_auto = false;  // Infer the JSON fields from sampled messages
+    uint64_t sample_size = 0;  // 0 means not set
     string proto_file = "";      // Path to .proto file
     string proto_message = "";   // Protobuf message type name
     vector<string> proto_fields; // Protobuf field paths to extract
+    vector<string> header_fields;  // Headers to extract
+    NatsCompression compression = NatsCompression::NONE;
+    NatsScanMode mode = NatsScanMode::DIRECT;
+    int32_t batch_size = NATS_SCAN_DEFAULT_BATCH_SIZE;
+    int64_t max_bytes = 0;
+    int64_t prefetch_bytes = NATS_PREFETCH_DEFAULT_BYTES;
+    bool follow = false;
+    int64_t max_wait_ms = -1;      // -1 means not set
+    int64_t idle_timeout_ms = -1;  // -1 means not set
+    uint64_t max_rows = 0;
+    bool reverse = false;
+    string cursor_name;
 
     // Check for named parameters
     for (auto &kv : input.named_parameters) {
         if (kv.first == "subject") {
-            subject_filter = StringValue::Get(kv.second);
+            subject_filters = ReadSubjectFilters(kv.second);
         } else if (kv.first == "url") {
             nats_url = StringValue::Get(kv.second);
         } else if (kv.first == "start_seq") {
@@ -244,11 +970,14 @@ static unique_ptr<FunctionData> NatsScanBind(ClientContext &context, TableFuncti
             timestamp_t ts = TimestampValue::Get(kv.second);
             end_time = ts.value * 1000;  // Convert microseconds to nanoseconds
         } else if (kv.first == "json_extract") {
-            // Extract list of field names
-            auto &list_value = kv.second;
-            auto list_children = ListValue::GetChildren(list_value);
-            for (auto &child : list_children) {
-                json_fields.push_back(StringValue::Get(child));
+            // List of paths (VARCHAR columns) or struct/map of path -> type
+            json_fields = ParseJsonExtractFields(context, kv.second);
+        } else if (kv.first == "json_auto") {
+            json_auto = BooleanValue::Get(kv.second);
+        } else if (kv.first == "sample_size") {
+            sample_size = UBigIntValue::Get(kv.second);
+            if (sample_size == 0) {
+                throw std::runtime_error("sample_size must be greater than 0");
             }
         } else if (kv.first == "proto_file") {
             proto_file = StringValue::Get(kv.second);
@@ -261,9 +990,112 @@ static unique_ptr<FunctionData> NatsScanBind(ClientContext &context, TableFuncti
             for (auto &child : list_children) {
                 proto_fields.push_back(StringValue::Get(child));
             }
+        } else if (kv.first == "header_extract") {
+            for (auto &child : ListValue::GetChildren(kv.second)) {
+                if (child.IsNull() || StringValue::Get(child).empty()) {
+                    throw std::runtime_error("header_extract names must not be NULL or empty");
+                }
+                header_fields.push_back(StringValue::Get(child));
+            }
+        } else if (kv.first == "compression") {
+            compression = ParseNatsCompression(StringValue::Get(kv.second));
+        } else if (kv.first == "mode") {
+            auto mode_str = StringUtil::Lower(StringValue::Get(kv.second));
+            if (mode_str == "direct") {
+                mode = NatsScanMode::DIRECT;
+            } else if (mode_str == "consumer") {
+                mode = NatsScanMode::CONSUMER;
+            } else if (mode_str == "last") {
+                mode = NatsScanMode::LAST;
+            } else {
+                throw std::runtime_error("Invalid mode '" + mode_str + "': expected 'direct', 'consumer' or 'last'");
+            }
+        } else if (kv.first == "batch_size") {
+            batch_size = IntegerValue::Get(kv.second);
+        } else if (kv.first == "max_bytes") {
+            max_bytes = BigIntValue::Get(kv.second);
+        } else if (kv.first == "prefetch_bytes") {
+            prefetch_bytes = BigIntValue::Get(kv.second);
+        } else if (kv.first == "follow") {
+            follow = BooleanValue::Get(kv.second);
+        } else if (kv.first == "max_wait") {
+            max_wait_ms = ReadIntervalMillis("max_wait", kv.second);
+        } else if (kv.first == "idle_timeout") {
+            idle_timeout_ms = ReadIntervalMillis("idle_timeout", kv.second);
+        } else if (kv.first == "max_rows") {
+            max_rows = UBigIntValue::Get(kv.second);
+            if (max_rows == 0) {
+                throw std::runtime_error("max_rows must be greater than 0");
+            }
+        } else if (kv.first == "reverse") {
+            reverse = BooleanValue::Get(kv.second);
+        } else if (kv.first == "cursor") {
+            cursor_name = StringValue::Get(kv.second);
+            NatsValidateCursorName(cursor_name);
+        }
+    }
+
+    // Validate the subject filters (NATS wildcard syntax)
+    for (auto &filter : subject_filters) {
+        if (!NatsSubjectFilterIsValid(filter)) {
+            throw std::runtime_error("Invalid subject filter '" + filter +
+                                     "': expected a NATS subject where '*' matches one token and '>' matches the rest");
+        }
+    }
+
+    // The server takes one filter per request, so a list of filters is sent as the narrowest
+    // filter covering all of them, and subjects are matched against the full list on the
+    // client unless the covering filter is one of the listed filters
+    string subject_filter = NatsSubjectMatcher::CoveringFilter(subject_filters);
+    shared_ptr<NatsSubjectMatcher> subject_matcher;
+    if (subject_filters.size() > 1) {
+        auto exact = subject_filter.empty() ? string(">") : subject_filter;
+        if (std::find(subject_filters.begin(), subject_filters.end(), exact) == subject_filters.end()) {
+            subject_matcher = make_shared_ptr<NatsSubjectMatcher>(subject_filters);
         }
     }
 
+    // Validate consumer pull request limits
+    if (batch_size <= 0) {
+        throw std::runtime_error("batch_size must be greater than 0");
+    }
+    if (max_bytes < 0) {
+        throw std::runtime_error("max_bytes must not be negative");
+    }
+    if (prefetch_bytes < 0) {
+        throw std::runtime_error("prefetch_bytes must not be negative");
+    }
+
+    // Validate follow mode
+    if (!follow && (max_wait_ms >= 0 || idle_timeout_ms >= 0)) {
+        throw std::runtime_error("max_wait and idle_timeout require follow := true");
+    }
+    if (follow && mode == NatsScanMode::LAST) {
+        throw std::runtime_error("follow cannot be combined with mode 'last'");
+    }
+    if (follow && (end_seq != UINT64_MAX || end_time > 0)) {
+        throw std::runtime_error("follow cannot be combined with end_seq or end_time");
+    }
+
+    // Validate reverse scans, which claim the direct get morsels from the end of each stream
+    if (reverse && mode != NatsScanMode::DIRECT) {
+        throw std::runtime_error("reverse requires mode 'direct'");
+    }
+    if (reverse && follow) {
+        throw std::runtime_error("reverse cannot be combined with follow");
+    }
+    if (reverse && !cursor_name.empty()) {
+        throw std::runtime_error("reverse cannot be combined with cursor");
+    }
+
+    // Validate the durable cursor
+    if (!cursor_name.empty() && mode == NatsScanMode::LAST) {
+        throw std::runtime_error("cursor cannot be combined with mode 'last'");
+    }
+    if (!cursor_name.empty() && max_rows > 0) {
+        throw std::runtime_error("cursor cannot be combined with max_rows");
+    }
+
     // Validate that sequence and time parameters are not mixed
     if ((start_seq > 0 || end_seq != UINT64_MAX) && (start_time > 0 || end_time > 0)) {
         throw std::runtime_error("Cannot mix sequence-based (start_seq/end_seq) and time-based (start_time/end_time) parameters");
@@ -273,6 +1105,12 @@ static unique_ptr<FunctionData> NatsScanBind(ClientContext &context, TableFuncti
     if (!json_fields.empty() && !proto_fields.empty()) {
         throw std::runtime_error("Cannot use both json_extract and proto_extract parameters");
     }
+    if (json_auto && (!json_fields.empty() || !proto_fields.empty())) {
+        throw std::runtime_error("json_auto cannot be combined with json_extract or proto_extract");
+    }
+    if (sample_size > 0 && !json_auto) {
+        throw std::runtime_error("sample_size requires json_auto := true");
+    }
 
     // Validate protobuf parameters
     if (!proto_fields.empty()) {
@@ -284,81 +1122,24 @@ static unique_ptr<FunctionData> NatsScanBind(ClientContext &context, TableFuncti
         }
     }
 
-    // Parse protobuf schema if proto_extract is specified
-    shared_ptr<DiskSourceTree> source_tree;
-    shared_ptr<ProtobufErrorCollector> error_collector;
-    shared_ptr<Importer> importer;
+    // Load protobuf schema if proto_extract is specified. Parsed schemas are cached
+    // across queries until the schema file changes.
+    shared_ptr<NatsProtoSchema> proto_schema;
     const Descriptor* descriptor = nullptr;
+    vector<ProtobufFieldPath> proto_field_paths;
 
     if (!proto_fields.empty()) {
-        // Set up source tree to find .proto files
-        source_tree = make_shared_ptr<DiskSourceTree>();
-
-        // Get directory and filename from proto_file path
-        std::filesystem::path proto_path(proto_file);
-        string proto_dir = proto_path.parent_path().string();
-        string proto_filename = proto_path.filename().string();
-
-        // If no directory specified, use current directory
-        if (proto_dir.empty()) {
-            proto_dir = ".";
-        }
-
-        // Map empty virtual path to the directory containing the .proto file
-        source_tree->MapPath("", proto_dir);
-
-        // Set up error collector and importer
-        error_collector = make_shared_ptr<ProtobufErrorCollector>();
-        importer = make_shared_ptr<Importer>(source_tree.get(), error_collector.get());
-
-        // Import the .proto file
-        const FileDescriptor* file_desc = importer->Import(proto_filename);
-        if (!file_desc) {
-            string error_msg = "Failed to import protobuf schema file: " + proto_file;
-            if (error_collector->HasErrors()) {
-                error_msg += "\n" + error_collector->GetErrors();
-            }
-            throw std::runtime_error(error_msg);
-        }
+        proto_schema = GetCachedProtoSchema(proto_file);
 
         // Find the message type
-        descriptor = file_desc->FindMessageTypeByName(proto_message);
+        descriptor = proto_schema->FindMessageType(proto_message);
         if (!descriptor) {
             throw std::runtime_error("Message type '" + proto_message + "' not found in " + proto_file);
         }
 
-        // Validate that all requested fields exist in the schema
+        // Compile the requested field paths once; this also validates that they exist in the schema
         for (const auto &field_path : proto_fields) {
-            // Parse field path (e.g., "location.zone")
-            vector<string> path_parts;
-            size_t start = 0;
-            size_t end = field_path.find('.');
-
-            while (end != string::npos) {
-                path_parts.push_back(field_path.substr(start, end - start));
-                start = end + 1;
-                end = field_path.find('.', start);
-            }
-            path_parts.push_back(field_path.substr(start));
-
-            // Navigate through nested messages to validate the path
-            const Descriptor* current_desc = descriptor;
-            for (size_t i = 0; i < path_parts.size(); i++) {
-                const FieldDescriptor* field = current_desc->FindFieldByName(path_parts[i]);
-                if (!field) {
-                    throw std::runtime_error("Field '" + path_parts[i] + "' not found in message type '" +
-                                           string(current_desc->name()) + "' (field path: " + field_path + ")");
-                }
-
-                // If not the last part, must be a nested message
-                if (i < path_parts.size() - 1) {
-                    if (field->type() != FieldDescriptor::TYPE_MESSAGE) {
-                        throw std::runtime_error("Field '" + path_parts[i] + "' is not a message type, cannot navigate to '" +
-                                               path_parts[i+1] + "' (field path: " + field_path + ")");
-                    }
-                    current_desc = field->message_type();
-                }
-            }
+            proto_field_paths.push_back(CompileProtobufFieldPath(descriptor, field_path));
         }
     }
 
@@ -378,522 +1159,1712 @@ static unique_ptr<FunctionData> NatsScanBind(ClientContext &context, TableFuncti
     names.emplace_back("payload");
     // Use BLOB for payload when using protobuf OR when no extraction is specified
     // This prevents UTF-8 validation errors on binary/protobuf data
-    if (!proto_fields.empty() || json_fields.empty()) {
+    if (!proto_fields.empty() || (json_fields.empty() && !json_auto)) {
         return_types.emplace_back(LogicalType(LogicalTypeId::BLOB));
     } else {
         return_types.emplace_back(LogicalType(LogicalTypeId::VARCHAR));
     }
 
+    // Headers, with every value of repeated headers
+    names.emplace_back("headers");
+    return_types.emplace_back(LogicalType::MAP(LogicalType::VARCHAR, LogicalType::LIST(LogicalType::VARCHAR)));
+
     // Add JSON field columns if json_extract is specified
+    // Dotted paths and JSON pointers become underscore-separated column names
     for (const auto &field : json_fields) {
-        names.emplace_back(field);
-        return_types.emplace_back(LogicalType(LogicalTypeId::VARCHAR));
+        names.emplace_back(field.column_name);
+        return_types.emplace_back(field.type);
     }
 
     // Add protobuf field columns if proto_extract is specified
     // Convert dot notation to underscores for column names
     // Determine actual DuckDB types from protobuf field types
-    for (const auto &field_path : proto_fields) {
-        string column_name = field_path;
+    for (idx_t i = 0; i < proto_fields.size(); i++) {
+        string column_name = proto_fields[i];
         std::replace(column_name.begin(), column_name.end(), '.', '_');
         names.emplace_back(column_name);
 
-        // Get the field descriptor and determine the DuckDB type
-        const FieldDescriptor* field_desc = GetFieldDescriptorForPath(descriptor, field_path);
-        if (field_desc) {
-            return_types.emplace_back(ProtobufTypeToDuckDBType(field_desc));
-        } else {
-            // Should not happen since we validated fields earlier, but default to VARCHAR
-            return_types.emplace_back(LogicalType(LogicalTypeId::VARCHAR));
+        // The last field descriptor of the compiled path determines the DuckDB type
+        vector<const Descriptor*> open_messages;
+        return_types.emplace_back(ProtobufTypeToDuckDBType(proto_field_paths[i].back(), open_messages));
+    }
+
+    // Add header columns if header_extract is specified (e.g. Trace-Id becomes Trace_Id)
+    for (const auto &header : header_fields) {
+        string column_name = header;
+        std::replace(column_name.begin(), column_name.end(), '-', '_');
+        names.emplace_back(column_name);
+        return_types.emplace_back(LogicalType(LogicalTypeId::VARCHAR));
+    }
+
+    // Resolve globs and read the stream state over one pooled connection
+    vector<string> stream_names;
+    vector<NatsScanStreamStats> stream_stats;
+    auto cursor_subject = StringUtil::Join(subject_filters, ",");
+    vector<uint64_t> cursor_seqs;
+    {
+        NatsConnectionLease connection(context, nats_url);
+        stream_names = ResolveStreamNames(connection.js, stream_patterns);
+        if (follow && stream_names.size() != 1) {
+            throw std::runtime_error("follow requires a single stream");
+        }
+        for (auto &stream_name : stream_names) {
+            stream_stats.push_back(ReadStreamStats(connection.js, stream_name, subject_filter, subject_matcher.get()));
+        }
+
+        // Resume after the cursor's position, preferring one reached earlier in this transaction
+        for (auto &stream_name : stream_names) {
+            if (cursor_name.empty()) {
+                break;
+            }
+            NatsCursorPosition position;
+            if (!NatsCursorState::Get(context)->GetPending(nats_url, cursor_name, stream_name, position) &&
+                !NatsReadCursor(connection.js, cursor_name, stream_name, position)) {
+                cursor_seqs.push_back(0);
+                continue;
+            }
+            if (position.subject != cursor_subject) {
+                throw std::runtime_error("Cursor '" + cursor_name + "' on stream " + stream_name +
+                                         " was created for subject '" + position.subject +
+                                         "'; use another cursor name for a different subject");
+            }
+            cursor_seqs.push_back(position.seq);
         }
     }
 
-    auto bind_data = make_uniq<NatsScanBindData>(stream_name, subject_filter, nats_url, start_seq, end_seq,
+    auto bind_data = make_uniq<NatsScanBindData>(std::move(stream_names), subject_filter, nats_url, start_seq, end_seq,
                                                   start_time, end_time, json_fields, proto_file, proto_message, proto_fields);
 
     // Store protobuf schema objects in bind data
     if (!proto_fields.empty()) {
-        bind_data->proto_source_tree = source_tree;
-        bind_data->proto_error_collector = error_collector;
-        bind_data->proto_importer = importer;
+        bind_data->proto_schema = proto_schema;
         bind_data->proto_descriptor = descriptor;
+        bind_data->proto_field_paths = std::move(proto_field_paths);
     }
 
-    return bind_data;
-}
-
-// Init global state
-static unique_ptr<GlobalTableFunctionState> NatsScanInitGlobal(ClientContext &context,
-                                                                 TableFunctionInitInput &input) {
-    auto &bind_data = input.bind_data->Cast<NatsScanBindData>();
-    auto state = make_uniq<NatsScanGlobalState>();
-
-    // Initialize sequence range from bind data
-    state->current_seq = bind_data.start_seq > 0 ? bind_data.start_seq : 1;
-
-    // If end_seq is not specified (UINT64_MAX), we'll determine it when we connect
-    // Otherwise use the user-specified value
-    state->end_seq = bind_data.end_seq;
-    state->done = false;
-
-    // Initialize protobuf factory if proto_extract is specified
-    if (!bind_data.proto_fields.empty() && bind_data.proto_descriptor != nullptr) {
-        state->proto_factory = make_shared_ptr<DynamicMessageFactory>();
-        state->proto_prototype = state->proto_factory->GetPrototype(bind_data.proto_descriptor);
+    bind_data->mode = mode;
+    bind_data->batch_size = batch_size;
+    bind_data->max_bytes = max_bytes;
+    bind_data->prefetch_bytes = prefetch_bytes;
+    bind_data->follow = follow;
+    bind_data->max_wait_ms = MaxValue<int64_t>(max_wait_ms, 0);
+    bind_data->idle_timeout_ms = MaxValue<int64_t>(idle_timeout_ms, 0);
+    bind_data->max_rows = max_rows;
+    bind_data->reverse = reverse;
+    bind_data->cursor_name = std::move(cursor_name);
+    bind_data->cursor_subject = std::move(cursor_subject);
+    bind_data->cursor_seqs = std::move(cursor_seqs);
+    bind_data->stream_stats = std::move(stream_stats);
+    bind_data->subject_matcher = std::move(subject_matcher);
+    bind_data->header_fields = std::move(header_fields);
+    bind_data->compression = compression;
+
+    // json_auto columns come right after the base columns, where json_extract columns go
+    if (json_auto) {
+        bind_data->json_fields = InferJsonFields(context, *bind_data,
+                                                 sample_size > 0 ? sample_size : NATS_JSON_AUTO_DEFAULT_SAMPLE_SIZE);
+        idx_t column = NATS_BASE_COLUMN_COUNT;
+        for (auto &field : bind_data->json_fields) {
+            names.insert(names.begin() + column, field.column_name);
+            return_types.insert(return_types.begin() + column, field.type);
+            column++;
+        }
     }
 
-    return state;
-}
+    Value cache_directory;
+    if (context.TryGetCurrentSetting(NATS_CACHE_DIRECTORY_SETTING, cache_directory) && !cache_directory.IsNull()) {
+        bind_data->cache_directory = cache_directory.ToString();
+    }
 
-// Init local state
-static unique_ptr<LocalTableFunctionState> NatsScanInitLocal(ExecutionContext &context,
-                                                               TableFunctionInitInput &input,
-                                                               GlobalTableFunctionState *global_state) {
-    return make_uniq<NatsScanLocalState>();
+    return bind_data;
 }
 
-// Helper function to extract a protobuf field value and convert to DuckDB Value
-static Value ExtractProtobufValue(const Message* message, const string& field_path, const Descriptor* root_descriptor) {
-    // Parse field path (e.g., "location.zone")
-    vector<string> path_parts;
-    size_t start = 0;
-    size_t end = field_path.find('.');
+static void WriteProtobufValue(const Message &message, const FieldDescriptor* field, Vector &result, idx_t row);
 
-    while (end != string::npos) {
-        path_parts.push_back(field_path.substr(start, end - start));
-        start = end + 1;
-        end = field_path.find('.', start);
-    }
-    path_parts.push_back(field_path.substr(start));
+// Write one value of field into row `row` of `result`: element `index` of a repeated field,
+// or the field's only value when index is -1
+static void WriteProtobufElement(const Message &message, const FieldDescriptor* field, int index,
+                                 Vector &result, idx_t row) {
+    const Reflection* reflection = message.GetReflection();
+    const bool singular = index < 0;
+    switch (field->type()) {
+        case FieldDescriptor::TYPE_STRING:
+        case FieldDescriptor::TYPE_BYTES: {
+            string scratch;
+            const string &str = singular ? reflection->GetStringReference(message, field, &scratch)
+                                         : reflection->GetRepeatedStringReference(message, field, index, &scratch);
+            FlatVector::GetData<string_t>(result)[row] = StringVector::AddStringOrBlob(result, str.data(), str.size());
+            return;
+        }
+        case FieldDescriptor::TYPE_INT32:
+        case FieldDescriptor::TYPE_SINT32:
+        case FieldDescriptor::TYPE_SFIXED32:
+            FlatVector::GetData<int32_t>(result)[row] = singular ? reflection->GetInt32(message, field)
+                                                                 : reflection->GetRepeatedInt32(message, field, index);
+            return;
+        case FieldDescriptor::TYPE_INT64:
+        case FieldDescriptor::TYPE_SINT64:
+        case FieldDescriptor::TYPE_SFIXED64:
+            FlatVector::GetData<int64_t>(result)[row] = singular ? reflection->GetInt64(message, field)
+                                                                 : reflection->GetRepeatedInt64(message, field, index);
+            return;
+        case FieldDescriptor::TYPE_UINT32:
+        case FieldDescriptor::TYPE_FIXED32:
+            FlatVector::GetData<uint32_t>(result)[row] = singular ? reflection->GetUInt32(message, field)
+                                                                  : reflection->GetRepeatedUInt32(message, field, index);
+            return;
+        case FieldDescriptor::TYPE_UINT64:
+        case FieldDescriptor::TYPE_FIXED64:
+            FlatVector::GetData<uint64_t>(result)[row] = singular ? reflection->GetUInt64(message, field)
+                                                                  : reflection->GetRepeatedUInt64(message, field, index);
+            return;
+        case FieldDescriptor::TYPE_FLOAT:
+            FlatVector::GetData<float>(result)[row] = singular ? reflection->GetFloat(message, field)
+                                                               : reflection->GetRepeatedFloat(message, field, index);
+            return;
+        case FieldDescriptor::TYPE_DOUBLE:
+            FlatVector::GetData<double>(result)[row] = singular ? reflection->GetDouble(message, field)
+                                                                : reflection->GetRepeatedDouble(message, field, index);
+            return;
+        case FieldDescriptor::TYPE_BOOL:
+            FlatVector::GetData<bool>(result)[row] = singular ? reflection->GetBool(message, field)
+                                                              : reflection->GetRepeatedBool(message, field, index);
+            return;
+        case FieldDescriptor::TYPE_ENUM: {
+            const EnumValueDescriptor* enum_val = singular ? reflection->GetEnum(message, field)
+                                                           : reflection->GetRepeatedEnum(message, field, index);
+            const auto &name = enum_val->name();
+            FlatVector::GetData<string_t>(result)[row] = StringVector::AddString(result, name.data(), name.size());
+            return;
+        }
+        case FieldDescriptor::TYPE_MESSAGE:
+        case FieldDescriptor::TYPE_GROUP: {
+            // Sub-messages fill the STRUCT's child vectors, one per field in declaration order
+            const Message &sub_message = singular ? reflection->GetMessage(message, field)
+                                                  : reflection->GetRepeatedMessage(message, field, index);
+            auto &entries = StructVector::GetEntries(result);
+            const Descriptor* sub_desc = field->message_type();
+            for (int i = 0; i < sub_desc->field_count(); i++) {
+                WriteProtobufValue(sub_message, sub_desc->field(i), *entries[i], row);
+            }
+            return;
+        }
+        default:
+            // Unknown types are NULL
+            break;
+    }
 
-    // Navigate through nested messages to find the final field
-    const Message* current_message = message;
-    const Descriptor* current_desc = root_descriptor;
-    const Reflection* reflection = message->GetReflection();
+    FlatVector::SetNull(result, row, true);
+}
 
-    for (size_t i = 0; i < path_parts.size(); i++) {
-        const FieldDescriptor* field = current_desc->FindFieldByName(path_parts[i]);
-        if (!field) {
-            return Value();  // Field not found - return NULL
+// Write the value of field in message into row `row` of `result`, which has the type chosen by
+// ProtobufTypeToDuckDBType. Repeated fields, including map fields whose entries share the
+// key/value STRUCT layout of a MAP, append their elements to the list's child vector.
+static void WriteProtobufValue(const Message &message, const FieldDescriptor* field, Vector &result, idx_t row) {
+    const Reflection* reflection = message.GetReflection();
+    if (field->is_repeated()) {
+        const int count = reflection->FieldSize(message, field);
+        const idx_t offset = ListVector::GetListSize(result);
+        ListVector::Reserve(result, offset + count);
+        auto &child = ListVector::GetEntry(result);
+        for (int i = 0; i < count; i++) {
+            WriteProtobufElement(message, field, i, child, offset + i);
         }
+        FlatVector::GetData<list_entry_t>(result)[row] = list_entry_t(offset, count);
+        ListVector::SetListSize(result, offset + count);
+        return;
+    }
 
-        // If not the last part, navigate to nested message
-        if (i < path_parts.size() - 1) {
-            if (field->type() != FieldDescriptor::TYPE_MESSAGE) {
-                return Value();  // Can't navigate into non-message field - return NULL
-            }
+    // Unset sub-messages are NULL (for proto3, primitive fields are always "set" with default values)
+    if (field->message_type() && !reflection->HasField(message, field)) {
+        FlatVector::SetNull(result, row, true);
+        return;
+    }
+    WriteProtobufElement(message, field, -1, result, row);
+}
 
-            // Check if the nested message field is set
-            if (!reflection->HasField(*current_message, field)) {
-                return Value();  // Nested message not set - return NULL
-            }
+// Helper function to extract a protobuf field and write it into row `row` of `result`
+// The result vector has the type chosen by ProtobufTypeToDuckDBType for the last field of the path
+static void WriteProtobufField(const Message* message, const ProtobufFieldPath& field_path, Vector &result, idx_t row) {
+    // Navigate through nested messages to the message holding the final field
+    const Message* current_message = message;
+    for (idx_t i = 0; i + 1 < field_path.size(); i++) {
+        const Reflection* reflection = current_message->GetReflection();
+        // Nested message not set - NULL
+        if (!reflection->HasField(*current_message, field_path[i])) {
+            FlatVector::SetNull(result, row, true);
+            return;
+        }
+        current_message = &reflection->GetMessage(*current_message, field_path[i]);
+    }
 
-            // Get the nested message
-            current_message = &reflection->GetMessage(*current_message, field);
-            current_desc = field->message_type();
-            reflection = current_message->GetReflection();
+    // Lists and structs are filled in the same pass over the message
+    WriteProtobufValue(*current_message, field_path.back(), result, row);
+}
+
+// Probe for the first live message at or after seq, skipping deleted sequences in the
+// same round trip. Returns false if there is none.
+static bool ProbeSequence(jsCtx *js, const char *stream_name, uint64_t seq, uint64_t &found_seq, int64_t &time_ns) {
+    natsMsg *msg = nullptr;
+    jsDirectGetMsgOptions opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.Sequence = seq;
+    opts.NextBySubject = ">";
+
+    natsStatus s = js_DirectGetMsg(&msg, js, stream_name, nullptr, &opts);
+    if (s == NATS_NOT_FOUND) {
+        return false;
+    }
+    if (s != NATS_OK) {
+        throw std::runtime_error(std::string("Failed to fetch message at sequence ") +
+                               std::to_string(seq) + " for timestamp resolution: " + natsStatus_GetText(s));
+    }
+    found_seq = natsMsg_GetSequence(msg);
+    time_ns = natsMsg_GetTime(msg);
+    natsMsg_Destroy(msg);
+    return true;
+}
+
+// Helper function to resolve a timestamp to the first sequence at or after it.
+// Returns UINT64_MAX if no message exists at or after the timestamp. Every direct get it
+// sends is counted in probes.
+// Servers that support it seek by time in a single direct get request. Otherwise the
+// sequence is found with an interpolation search seeded from the stream's first and
+// last message times.
+static uint64_t ResolveTimestampToSequence(natsConnection *conn, jsCtx *js, const string &stream_name,
+                                           int64_t timestamp_ns, const jsStreamState &stream_state,
+                                           uint64_t &probes) {
+    if (stream_state.Msgs == 0 || timestamp_ns > stream_state.LastTime) {
+        return UINT64_MAX;
+    }
+    if (timestamp_ns <= stream_state.FirstTime) {
+        return stream_state.FirstSeq;
+    }
+
+    uint64_t seek_seq = 0;
+    probes++;
+    switch (NatsDirectGetSeekTime(conn, stream_name, timestamp_ns, seek_seq)) {
+    case NatsTimeSeekResult::FOUND:
+        return seek_seq;
+    case NatsTimeSeekResult::NOT_FOUND:
+        return UINT64_MAX;
+    case NatsTimeSeekResult::UNSUPPORTED:
+        break;
+    }
+
+    // Search for the smallest probe sequence whose next live message is at or after the
+    // timestamp. (lo_seq, lo_time) is the latest live message known to be before the
+    // timestamp, and (hi_seq, hi_time) the earliest live message known to be at or after it.
+    uint64_t lo_seq = stream_state.FirstSeq;
+    int64_t lo_time = stream_state.FirstTime;
+    uint64_t hi_seq = stream_state.LastSeq;
+    int64_t hi_time = stream_state.LastTime;
+
+    // Candidate probe sequences are [left, right]
+    uint64_t left = lo_seq + 1;
+    uint64_t right = hi_seq - 1;
+
+    // Interpolation steps alternate with bisection steps, so unevenly spaced timestamps
+    // cost at most twice the probes of a binary search
+    bool interpolate = true;
+    while (left <= right) {
+        uint64_t probe;
+        if (interpolate && hi_time > lo_time) {
+            double fraction = double(timestamp_ns - lo_time) / double(hi_time - lo_time);
+            probe = lo_seq + uint64_t(fraction * double(hi_seq - lo_seq));
+            probe = MinValue<uint64_t>(MaxValue<uint64_t>(probe, left), right);
         } else {
-            // Last part - extract the value
-            // Check if field is set (for proto3, primitive fields are always "set" with default values)
-            if (!reflection->HasField(*current_message, field) && field->type() == FieldDescriptor::TYPE_MESSAGE) {
-                return Value();  // Message field not set - return NULL
-            }
-
-            // Extract value based on type
-            switch (field->type()) {
-                case FieldDescriptor::TYPE_STRING:
-                    return Value(reflection->GetString(*current_message, field));
-                case FieldDescriptor::TYPE_BYTES: {
-                    string bytes = reflection->GetString(*current_message, field);
-                    return Value::BLOB(const_data_ptr_cast(bytes.data()), bytes.size());
-                }
-                case FieldDescriptor::TYPE_INT32:
-                case FieldDescriptor::TYPE_SINT32:
-                case FieldDescriptor::TYPE_SFIXED32:
-                    return Value::INTEGER(reflection->GetInt32(*current_message, field));
-                case FieldDescriptor::TYPE_INT64:
-                case FieldDescriptor::TYPE_SINT64:
-                case FieldDescriptor::TYPE_SFIXED64:
-                    return Value::BIGINT(reflection->GetInt64(*current_message, field));
-                case FieldDescriptor::TYPE_UINT32:
-                case FieldDescriptor::TYPE_FIXED32:
-                    return Value::UINTEGER(reflection->GetUInt32(*current_message, field));
-                case FieldDescriptor::TYPE_UINT64:
-                case FieldDescriptor::TYPE_FIXED64:
-                    return Value::UBIGINT(reflection->GetUInt64(*current_message, field));
-                case FieldDescriptor::TYPE_FLOAT:
-                    return Value::FLOAT(reflection->GetFloat(*current_message, field));
-                case FieldDescriptor::TYPE_DOUBLE:
-                    return Value::DOUBLE(reflection->GetDouble(*current_message, field));
-                case FieldDescriptor::TYPE_BOOL:
-                    return Value::BOOLEAN(reflection->GetBool(*current_message, field));
-                case FieldDescriptor::TYPE_ENUM: {
-                    const EnumValueDescriptor* enum_val = reflection->GetEnum(*current_message, field);
-                    return Value(string(enum_val->name()));
-                }
-                case FieldDescriptor::TYPE_MESSAGE:
-                    // Nested messages should have been extracted as separate fields
-                    return Value();
-                default:
-                    return Value();  // Unknown type - return NULL
-            }
+            probe = left + (right - left) / 2;
+        }
+        interpolate = !interpolate;
+
+        uint64_t found_seq;
+        int64_t found_time;
+        probes++;
+        if (!ProbeSequence(js, stream_name.c_str(), probe, found_seq, found_time) || found_seq >= hi_seq) {
+            // No live message between the probe and hi_seq
+            right = probe - 1;
+        } else if (found_time >= timestamp_ns) {
+            hi_seq = found_seq;
+            hi_time = found_time;
+            right = probe - 1;
+        } else {
+            // Everything up to the found message is before the timestamp
+            lo_seq = found_seq;
+            lo_time = found_time;
+            left = found_seq + 1;
         }
     }
 
-    return Value();  // Should not reach here
+    return hi_seq;
 }
 
-// Helper function to resolve a timestamp to a sequence number using binary search
-// Searches through messages to find the first one at or after the given timestamp
-static uint64_t ResolveTimestampToSequence(jsCtx *js, const char *stream_name,
-                                           int64_t timestamp_ns,
-                                           uint64_t first_seq, uint64_t last_seq) {
-    natsStatus s;
-    uint64_t left = first_seq;
-    uint64_t right = last_seq;
-    uint64_t result_seq = UINT64_MAX;  // Default: no message found
+// Resolve the scan range of one stream from its info and the bind data's sequence and
+// time bounds, and size its morsels. Timestamp resolution probes are counted in stats, if set.
+static void ResolveStreamRange(natsConnection *conn, jsCtx *js, const string &stream_name,
+                               const NatsScanBindData &bind_data, uint64_t cursor_seq, NatsScanStream &stream,
+                               NatsScanStats *stats) {
+    auto &stream_state = stream.info->State;
+
+    // Initialize sequence range from bind data, continuing after the cursor's position
+    uint64_t start_seq = bind_data.start_seq > 0 ? bind_data.start_seq : 1;
+    if (cursor_seq > 0) {
+        start_seq = MaxValue<uint64_t>(start_seq, cursor_seq + 1);
+    }
 
-    // Binary search for the first message at or after the timestamp
-    while (left <= right) {
-        uint64_t mid = left + (right - left) / 2;
+    // If end_seq is not specified (UINT64_MAX), use the last sequence in the stream
+    uint64_t end_seq = bind_data.end_seq;
+    if (end_seq == UINT64_MAX) {
+        end_seq = stream_state.LastSeq;
+    }
 
-        // Fetch message at mid sequence
-        natsMsg *msg = nullptr;
-        jsDirectGetMsgOptions opts;
-        memset(&opts, 0, sizeof(opts));
-        opts.Sequence = mid;
+    // Resolve timestamps to sequences if needed
+    uint64_t probes = 0;
+    if (bind_data.start_time > 0) {
+        uint64_t resolved_seq =
+            ResolveTimestampToSequence(conn, js, stream_name, bind_data.start_time, stream_state, probes);
 
-        s = js_DirectGetMsg(&msg, js, stream_name, nullptr, &opts);
+        // If resolved_seq is UINT64_MAX, it means no messages exist at or after this timestamp
+        if (resolved_seq == UINT64_MAX) {
+            start_seq = 1;
+            end_seq = 0;
+        } else {
+            // Pushed-down seq predicates may narrow the range further
+            start_seq = MaxValue<uint64_t>(start_seq, resolved_seq);
+        }
+    }
 
-        if (s == NATS_NOT_FOUND) {
-            // Message not found at this sequence, try next
-            left = mid + 1;
-            continue;
+    if (bind_data.end_time > 0 && start_seq <= end_seq) {
+        // end_time is inclusive: the range ends just before the first message published after it,
+        // so the scan never returns (and a cursor never moves past) a message beyond the bound
+        uint64_t resolved_seq =
+            ResolveTimestampToSequence(conn, js, stream_name, bind_data.end_time + 1, stream_state, probes);
+
+        // If resolved_seq is UINT64_MAX, use the last sequence in the stream
+        if (resolved_seq != UINT64_MAX) {
+            end_seq = MinValue<uint64_t>(end_seq, resolved_seq - 1);
         }
+    }
+
+    stream.start_seq = start_seq;
+    stream.end_seq = end_seq;
+    stream.next_seq = start_seq <= end_seq ? start_seq : 0;
+    if (stats != nullptr) {
+        stats->resolve_probes += probes;
+        stats->round_trips += probes;
+    }
+
+    // Streams with deleted messages (purges, MaxMsgsPerSubject) have gaps in their sequence
+    // range. Widen morsels by the stream's average gap so each one still holds about a chunk
+    // of live messages, since fetches skip the gaps on the server.
+    if (stream_state.Msgs > 0 && stream_state.LastSeq >= stream_state.FirstSeq) {
+        uint64_t stream_span = stream_state.LastSeq - stream_state.FirstSeq + 1;
+        uint64_t sequences_per_message = MaxValue<uint64_t>(1, stream_span / stream_state.Msgs);
+        stream.morsel_span = MinValue<uint64_t>(NATS_SCAN_MORSEL_SIZE * sequences_per_message,
+                                                NATS_SCAN_MAX_MORSEL_SPAN);
+    }
+}
 
-        if (s != NATS_OK) {
-            throw std::runtime_error(std::string("Failed to fetch message at sequence ") +
-                                   std::to_string(mid) + " for timestamp resolution: " + natsStatus_GetText(s));
+// Init global state
+// Connects once to fetch stream info and resolve timestamps, then partitions the
+// resulting sequence range of every stream into morsels that the scan threads claim.
+static unique_ptr<GlobalTableFunctionState> NatsScanInitGlobal(ClientContext &context,
+                                                                 TableFunctionInitInput &input) {
+    auto &bind_data = input.bind_data->Cast<NatsScanBindData>();
+    auto state = make_uniq<NatsScanGlobalState>();
+    state->bind_data = &bind_data;
+    state->projection = NatsScanProjection(input.column_ids, bind_data.FieldCount(), bind_data.header_fields.size());
+    state->stats_history = NatsScanStatsHistory::Get(context);
+    state->stats_streams = StringUtil::Join(bind_data.stream_names, ",");
+    state->stats_mode = NatsScanModeName(bind_data.mode);
+    state->start_ns = NatsNowNanos();
+
+    // Borrow a pooled connection; repeated queries against the same server skip the dial
+    state->connection = make_uniq<NatsConnectionLease>(context, bind_data.nats_url);
+    auto js = state->connection->js;
+
+    // Get stream info (needed for end_seq and timestamp resolution)
+    uint64_t morsels = 0;
+    state->streams.resize(bind_data.stream_names.size());
+    for (idx_t i = 0; i < bind_data.stream_names.size(); i++) {
+        auto &stream = state->streams[i];
+        stream.info = NatsGetStreamInfo(js, bind_data.stream_names[i]);
+        uint64_t cursor_seq = bind_data.cursor_seqs.empty() ? 0 : bind_data.cursor_seqs[i];
+        ResolveStreamRange(state->connection->conn, js, bind_data.stream_names[i], bind_data, cursor_seq, stream,
+                           &state->stats);
+        if (bind_data.reverse && stream.next_seq != 0) {
+            stream.next_seq = stream.end_seq;
+        }
+        if (!bind_data.cache_directory.empty() && bind_data.mode == NatsScanMode::DIRECT) {
+            stream.cache = make_uniq<NatsStreamCache>(bind_data.cache_directory, bind_data.stream_names[i],
+                                                      stream.info->Created, bind_data.subject_filter,
+                                                      stream.info->State.LastSeq);
+        }
+        if (stream.start_seq <= stream.end_seq) {
+            morsels += (stream.end_seq - stream.start_seq) / stream.morsel_span + 1;
         }
+    }
+    state->progress_seq = bind_data.reverse ? state->streams[0].end_seq : state->streams[0].start_seq;
+    if (bind_data.max_rows > 0) {
+        state->rows_left = bind_data.max_rows;
+    }
+    if (!bind_data.cursor_name.empty()) {
+        state->cursor_state = NatsCursorState::Get(context);
+    }
 
-        // Get message timestamp
-        int64_t msg_time_ns = natsMsg_GetTime(msg);
+    // One thread per morsel, capped by the number of DuckDB threads. Consumer and last
+    // mode fetch through the global state, so their threads only decode in parallel.
+    if (morsels > 0) {
+        auto threads = idx_t(TaskScheduler::GetScheduler(context).NumberOfThreads());
+        state->max_threads = MaxValue<idx_t>(1, MinValue<idx_t>(threads, morsels));
+    }
+    // A limited scan reads its streams in order on one thread, so that each stream can stop
+    // as soon as it has returned the rows the limit needs
+    if (bind_data.stream_limit > 0) {
+        state->max_threads = 1;
+    }
 
-        natsMsg_Destroy(msg);
+    // Look up the message prototype if a proto_extract field is projected
+    if (!state->projection.field_cols.empty() && bind_data.proto_descriptor != nullptr) {
+        state->proto_prototype = bind_data.proto_schema->GetPrototype(bind_data.proto_descriptor);
+    }
 
-        if (msg_time_ns >= timestamp_ns) {
-            // This message is at or after the target timestamp
-            result_seq = mid;
-            right = mid - 1;  // Try to find an earlier one
-        } else {
-            // This message is before the target timestamp
-            left = mid + 1;
+    return state;
+}
+
+// Init local state
+static unique_ptr<LocalTableFunctionState> NatsScanInitLocal(ExecutionContext &context,
+                                                               TableFunctionInitInput &input,
+                                                               GlobalTableFunctionState *global_state) {
+    auto &bind_data = input.bind_data->Cast<NatsScanBindData>();
+    auto &gstate = global_state->Cast<NatsScanGlobalState>();
+    auto state = make_uniq<NatsScanLocalState>();
+
+    // Consumer mode fetches through the global state's consumer; direct get threads fetch on their own
+    if (bind_data.mode == NatsScanMode::DIRECT) {
+        state->connection = make_uniq<NatsConnectionLease>(context.client, bind_data.nats_url);
+        state->fetcher = make_uniq<NatsDirectGetFetcher>(state->connection->conn, state->connection->js,
+                                                        bind_data.stream_names[0], bind_data.subject_filter);
+        state->fetcher->SetStats(&gstate.stats);
+        // Limited scans fetch on demand, since prefetched morsels past the limit would be wasted
+        if (bind_data.prefetch_bytes > 0 && bind_data.stream_limit == 0) {
+            // Hand the fetcher to a background thread that fetches morsels while this thread decodes
+            auto claim_morsel = [&gstate](NatsMorsel &morsel) {
+                return gstate.ClaimMorsel(morsel);
+            };
+            state->prefetcher = make_uniq<NatsPrefetcher>(std::move(state->fetcher), bind_data.stream_names,
+                                                          std::move(claim_morsel), idx_t(bind_data.prefetch_bytes));
         }
     }
 
-    return result_seq;
+    if (gstate.proto_prototype != nullptr) {
+        state->proto_message = unique_ptr<Message>(gstate.proto_prototype->New());
+    }
+
+    return state;
 }
 
-// Main scan function - retrieves data from NATS
-static void NatsScanExecute(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
-    auto &bind_data = data_p.bind_data->Cast<NatsScanBindData>();
-    auto &global_state = data_p.global_state->Cast<NatsScanGlobalState>();
-    auto &local_state = data_p.local_state->Cast<NatsScanLocalState>();
+// Estimate the number of rows a scan returns from one stream, given its state read at bind
+// time. Messages are assumed to be spread evenly over the stream's sequence and time ranges,
+// and the subject filter scales the estimate by the share of matching messages.
+static void EstimateStreamRows(const NatsScanBindData &bind_data, const NatsScanStreamStats &stats,
+                               uint64_t cursor_seq, idx_t &estimate, idx_t &max_rows) {
+    estimate = 0;
+    max_rows = 0;
+    if (stats.msgs == 0 || stats.last_seq < stats.first_seq) {
+        return;
+    }
 
-    // If we're done, return empty chunk
-    if (global_state.done) {
-        output.SetCardinality(0);
+    // Share of the stream's sequence range covered by the scan
+    uint64_t start_seq = MaxValue<uint64_t>(bind_data.start_seq, stats.first_seq);
+    if (cursor_seq > 0) {
+        start_seq = MaxValue<uint64_t>(start_seq, cursor_seq + 1);
+    }
+    uint64_t end_seq = MinValue<uint64_t>(bind_data.end_seq, stats.last_seq);
+    if (start_seq > end_seq) {
         return;
     }
+    double fraction = double(end_seq - start_seq + 1) / double(stats.last_seq - stats.first_seq + 1);
+
+    // Share of the stream's time range covered by the scan
+    if ((bind_data.start_time > 0 || bind_data.end_time > 0) && stats.last_time > stats.first_time) {
+        int64_t start_time = MaxValue<int64_t>(bind_data.start_time, stats.first_time);
+        int64_t end_time = bind_data.end_time > 0 ? MinValue<int64_t>(bind_data.end_time, stats.last_time)
+                                                  : stats.last_time;
+        fraction *= start_time > end_time ? 0.0
+                                          : double(end_time - start_time) / double(stats.last_time - stats.first_time);
+    }
 
-    // Create connection if it doesn't exist
-    if (global_state.conn == nullptr) {
-        natsOptions *opts = nullptr;
-        natsStatus s = natsOptions_Create(&opts);
-        if (s != NATS_OK) {
-            throw std::runtime_error(std::string("Failed to create NATS options: ") + natsStatus_GetText(s));
+    // Last mode returns at most one row per subject
+    if (bind_data.mode == NatsScanMode::LAST) {
+        max_rows = stats.subjects == UINT64_MAX ? stats.msgs : MinValue<uint64_t>(stats.subjects, stats.msgs);
+        estimate = max_rows;
+        return;
+    }
+
+    // Unknown subject counts leave the estimate at the unfiltered message count
+    max_rows = stats.subject_msgs == UINT64_MAX ? stats.msgs : stats.subject_msgs;
+    estimate = MinValue<idx_t>(idx_t(fraction * double(max_rows)), max_rows);
+}
+
+// Estimate the number of rows a scan returns as the sum of its per-stream estimates
+static unique_ptr<NodeStatistics> NatsScanCardinality(ClientContext &context, const FunctionData *bind_data_p) {
+    auto &bind_data = bind_data_p->Cast<NatsScanBindData>();
+    idx_t estimate = 0;
+    idx_t max_rows = 0;
+    for (idx_t i = 0; i < bind_data.stream_stats.size(); i++) {
+        uint64_t cursor_seq = bind_data.cursor_seqs.empty() ? 0 : bind_data.cursor_seqs[i];
+        idx_t stream_estimate;
+        idx_t stream_max_rows;
+        EstimateStreamRows(bind_data, bind_data.stream_stats[i], cursor_seq, stream_estimate, stream_max_rows);
+        estimate += stream_estimate;
+        max_rows += stream_max_rows;
+    }
+    if (bind_data.max_rows > 0) {
+        max_rows = bind_data.follow ? bind_data.max_rows : MinValue<idx_t>(max_rows, bind_data.max_rows);
+        estimate = MinValue<idx_t>(estimate, max_rows);
+    } else if (bind_data.follow) {
+        // Following a stream has no upper bound on the rows it returns
+        return make_uniq<NodeStatistics>(estimate);
+    }
+    return make_uniq<NodeStatistics>(estimate, max_rows);
+}
+
+// Report scan progress as the share of the streams' sequence ranges that has been scanned
+static double NatsScanProgress(ClientContext &context, const FunctionData *bind_data_p,
+                               const GlobalTableFunctionState *global_state_p) {
+    auto &bind_data = bind_data_p->Cast<NatsScanBindData>();
+    auto &global_state = global_state_p->Cast<NatsScanGlobalState>();
+    idx_t progress_stream = global_state.progress_stream;
+    uint64_t progress_seq = global_state.progress_seq;
+    double scanned = 0.0;
+    double total = 0.0;
+    for (idx_t i = 0; i < global_state.streams.size(); i++) {
+        auto &stream = global_state.streams[i];
+        if (stream.start_seq > stream.end_seq) {
+            continue;
         }
+        double span = double(stream.end_seq - stream.start_seq) + 1.0;
+        total += span;
+        if (i < progress_stream) {
+            scanned += span;
+        } else if (i == progress_stream && bind_data.reverse && progress_seq < stream.end_seq) {
+            scanned += MinValue<double>(span, double(stream.end_seq - progress_seq));
+        } else if (i == progress_stream && !bind_data.reverse && progress_seq > stream.start_seq) {
+            scanned += MinValue<double>(span, double(progress_seq - stream.start_seq));
+        }
+    }
+    if (total == 0.0) {
+        return 100.0;
+    }
+    return MinValue<double>(100.0, 100.0 * scanned / total);
+}
 
-        // Set connection timeout to 5 seconds
-        s = natsOptions_SetTimeout(opts, 5000); // 5000 milliseconds
-        if (s != NATS_OK) {
-            natsOptions_Destroy(opts);
-            throw std::runtime_error(std::string("Failed to set NATS timeout: ") + natsStatus_GetText(s));
+// Report the morsel a chunk came from so DuckDB can preserve sequence order
+static OperatorPartitionData NatsScanGetPartitionData(ClientContext &context, TableFunctionGetPartitionInput &input) {
+    if (input.partition_info.RequiresPartitionColumns()) {
+        throw InternalException("nats_scan does not support partition columns");
+    }
+    auto &local_state = input.local_state->Cast<NatsScanLocalState>();
+    return OperatorPartitionData(local_state.batch_index);
+}
+
+// Write the headers of a message as a map of header name to values, leaving out those the
+// server adds to direct get responses
+static void WriteHeaderMap(natsMsg *msg, Vector &map_vec, idx_t row) {
+    auto list_offset = ListVector::GetListSize(map_vec);
+    idx_t entries = 0;
+    const char **keys = nullptr;
+    int key_count = 0;
+    if (natsMsgHeader_Keys(msg, &keys, &key_count) == NATS_OK) {
+        ListVector::Reserve(map_vec, list_offset + key_count);
+        auto &key_vec = MapVector::GetKeys(map_vec);
+        auto &value_vec = MapVector::GetValues(map_vec);
+        for (int k = 0; k < key_count; k++) {
+            const char **values = nullptr;
+            int value_count = 0;
+            if (NatsIsDirectGetHeader(keys[k]) ||
+                natsMsgHeader_Values(msg, keys[k], &values, &value_count) != NATS_OK) {
+                continue;
+            }
+            auto entry = list_offset + entries++;
+            FlatVector::GetData<string_t>(key_vec)[entry] = StringVector::AddString(key_vec, keys[k]);
+
+            auto value_offset = ListVector::GetListSize(value_vec);
+            ListVector::Reserve(value_vec, value_offset + value_count);
+            auto &value_child = ListVector::GetEntry(value_vec);
+            for (int v = 0; v < value_count; v++) {
+                FlatVector::GetData<string_t>(value_child)[value_offset + v] =
+                    StringVector::AddString(value_child, values[v]);
+            }
+            FlatVector::GetData<list_entry_t>(value_vec)[entry] = list_entry_t(value_offset, value_count);
+            ListVector::SetListSize(value_vec, value_offset + value_count);
+            free(values);
         }
+        free(keys);
+    }
+    FlatVector::GetData<list_entry_t>(map_vec)[row] = list_entry_t(list_offset, entries);
+    ListVector::SetListSize(map_vec, list_offset + entries);
+}
 
-        s = natsOptions_SetURL(opts, bind_data.nats_url.c_str());
-        if (s != NATS_OK) {
-            natsOptions_Destroy(opts);
-            throw std::runtime_error(std::string("Failed to set NATS URL: ") + natsStatus_GetText(s));
+// Write one message into row `row` of the output chunk. Only projected columns are
+// written, and payloads are only decoded when an extracted field is projected.
+// Values are written straight into the flat column buffers; subjects go into the chunk's
+// subject dictionary, and the constant stream column is filled once per chunk by
+// WriteConstantColumns. Projected payload and header_extract columns
+// reference the message buffer instead of copying it, so the message is handed over to
+// the chunk's message buffer and message.msg is cleared.
+static void WriteMessageRow(const NatsScanBindData &bind_data, const NatsScanProjection &projection,
+                            NatsScanLocalState &local_state, NatsFetchedMessage &message,
+                            DataChunk &output, idx_t row) {
+    local_state.returned_seq = message.seq;
+
+    // Column: subject
+    if (projection.subject_col != DConstants::INVALID_INDEX) {
+        local_state.subject_dictionary.Add(row, message.subject);
+    }
+
+    // Column: seq
+    if (projection.seq_col != DConstants::INVALID_INDEX) {
+        FlatVector::GetData<uint64_t>(output.data[projection.seq_col])[row] = message.seq;
+    }
+
+    // Column: ts_nats (message timestamp converted from nanoseconds to microseconds)
+    if (projection.ts_col != DConstants::INVALID_INDEX) {
+        FlatVector::GetData<timestamp_t>(output.data[projection.ts_col])[row] = timestamp_t(message.time_ns / 1000);
+    }
+
+    const char *data = natsMsg_GetData(message.msg);
+    int data_len = natsMsg_GetDataLength(message.msg);
+    // Whether a column points into the message buffer
+    bool referenced = false;
+
+    // Decompress the payload into the thread's buffer if it is returned or decoded
+    bool decompressed = false;
+    if (bind_data.compression != NatsCompression::NONE &&
+        (projection.payload_col != DConstants::INVALID_INDEX || !projection.field_cols.empty())) {
+        auto codec = NatsDetectCompression(bind_data.compression, message.msg, data, data_len);
+        if (codec != NatsCompression::NONE) {
+            if (!local_state.decompressor.Decompress(codec, data, data_len)) {
+                throw std::runtime_error("Failed to decompress payload of message " + std::to_string(message.seq) +
+                                         " as " + NatsCompressionName(codec) + ": " +
+                                         local_state.decompressor.Error());
+            }
+            data = local_state.decompressor.Data();
+            data_len = static_cast<int>(local_state.decompressor.Size());
+            decompressed = true;
         }
+    }
 
-        s = natsConnection_Connect(&global_state.conn, opts);
-        natsOptions_Destroy(opts);
+    // Column: payload (raw bytes)
+    if (projection.payload_col != DConstants::INVALID_INDEX) {
+        // Use BLOB for protobuf OR when no extraction is specified (prevents UTF-8 validation errors)
+        // Use VARCHAR only when json_extract is specified (data is expected to be valid JSON/UTF-8)
+        auto &payload_vec = output.data[projection.payload_col];
+        if (payload_vec.GetType().id() == LogicalTypeId::VARCHAR && !Utf8Proc::IsValid(data, data_len)) {
+            throw std::runtime_error("Payload of message " + std::to_string(message.seq) +
+                                     " is not valid UTF-8; omit json_extract to read it as BLOB");
+        }
+        if (decompressed) {
+            // The decompression buffer is reused for the next message
+            FlatVector::GetData<string_t>(payload_vec)[row] = StringVector::AddStringOrBlob(payload_vec, data, data_len);
+        } else {
+            string_t payload(data, static_cast<uint32_t>(data_len));
+            FlatVector::GetData<string_t>(payload_vec)[row] = payload;
+            // Short payloads are copied into the string_t itself and need no message
+            referenced = !payload.IsInlined();
+        }
+    }
 
-        if (s != NATS_OK) {
-            throw std::runtime_error(std::string("Failed to connect to NATS: ") + natsStatus_GetText(s));
+    // Column: headers (parsed by the client library on first access)
+    if (projection.headers_col != DConstants::INVALID_INDEX) {
+        WriteHeaderMap(message.msg, output.data[projection.headers_col], row);
+    }
+
+    // Columns: header_extract (the first value of each header)
+    for (auto &header_col : projection.header_cols) {
+        auto &header_vec = output.data[header_col.first];
+        const char *value = nullptr;
+        if (natsMsgHeader_Get(message.msg, bind_data.header_fields[header_col.second].c_str(), &value) != NATS_OK) {
+            FlatVector::SetNull(header_vec, row, true);
+            continue;
+        }
+        auto value_len = strlen(value);
+        if (!Utf8Proc::IsValid(value, value_len)) {
+            throw std::runtime_error("Header " + bind_data.header_fields[header_col.second] + " of message " +
+                                     std::to_string(message.seq) + " is not valid UTF-8");
         }
+        string_t header_value(value, static_cast<uint32_t>(value_len));
+        FlatVector::GetData<string_t>(header_vec)[row] = header_value;
+        referenced = referenced || !header_value.IsInlined();
+    }
+
+    if (referenced) {
+        local_state.chunk_messages->messages.push_back(message.msg);
+        message.msg = nullptr;
     }
 
-    // Create JetStream context if it doesn't exist
-    if (global_state.js == nullptr) {
-        natsStatus s = natsConnection_JetStream(&global_state.js, global_state.conn, nullptr);
+    // Nothing else to do unless an extracted field is projected
+    if (projection.field_cols.empty()) {
+        return;
+    }
 
-        if (s != NATS_OK) {
-            throw std::runtime_error(std::string("Failed to create JetStream context: ") + natsStatus_GetText(s));
+    // Extract JSON fields if requested
+    if (!bind_data.json_fields.empty()) {
+        // Parse JSON payload into the thread's reusable buffer
+        if (local_state.json_decoder.Parse(data, data_len)) {
+            // Extract each projected field
+            for (auto &field_col : projection.field_cols) {
+                local_state.json_decoder.WriteField(bind_data.json_fields[field_col.second],
+                                                    output.data[field_col.first], row);
+            }
+        } else {
+            // JSON parsing failed - set all JSON fields to NULL
+            for (auto &field_col : projection.field_cols) {
+                FlatVector::SetNull(output.data[field_col.first], row, true);
+            }
         }
+    }
 
-        // Get stream info (needed for end_seq and timestamp resolution)
-        if (global_state.stream_info == nullptr) {
-            s = js_GetStreamInfo(&global_state.stream_info, global_state.js, bind_data.stream_name.c_str(), nullptr, nullptr);
+    // Extract protobuf fields if requested
+    if (!bind_data.proto_fields.empty() && local_state.proto_message) {
+        Message* proto_message = local_state.proto_message.get();
 
-            if (s != NATS_OK) {
-                throw std::runtime_error(std::string("Failed to get stream info: ") + natsStatus_GetText(s));
+        // Parse the protobuf message from the payload
+        bool parse_success = proto_message->ParseFromArray(data, data_len);
+
+        if (parse_success) {
+            // Extract each projected field along its precompiled descriptor chain
+            for (auto &field_col : projection.field_cols) {
+                WriteProtobufField(proto_message, bind_data.proto_field_paths[field_col.second],
+                                   output.data[field_col.first], row);
+            }
+        } else {
+            // Protobuf parsing failed - set all protobuf fields to NULL
+            for (auto &field_col : projection.field_cols) {
+                FlatVector::SetNull(output.data[field_col.first], row, true);
             }
         }
+    }
+}
+
+// Columns with the same value in every row are emitted as constant vectors: the stream
+// name (a chunk never spans two streams), and virtual columns (e.g. the row id requested for COUNT(*)) which carry no data
+static void WriteConstantColumns(const string &stream_name, const NatsScanProjection &projection,
+                                 DataChunk &output) {
+    if (projection.stream_col != DConstants::INVALID_INDEX) {
+        auto &stream_vec = output.data[projection.stream_col];
+        stream_vec.SetVectorType(VectorType::CONSTANT_VECTOR);
+        ConstantVector::GetData<string_t>(stream_vec)[0] = StringVector::AddString(stream_vec, stream_name);
+    }
+    for (auto col_idx : projection.virtual_cols) {
+        output.data[col_idx].SetVectorType(VectorType::CONSTANT_VECTOR);
+        ConstantVector::SetNull(output.data[col_idx], true);
+    }
+}
+
+// Client-side filters applied before a message is written: subject lists that no single
+// server filter matches exactly, and header filters pushed down from WHERE
+static bool MessageMatches(const NatsScanBindData &bind_data, const NatsFetchedMessage &message) {
+    if (bind_data.subject_matcher && !bind_data.subject_matcher->Matches(message.subject)) {
+        return false;
+    }
+    for (auto &filter : bind_data.header_filters) {
+        const char *value = nullptr;
+        if (natsMsgHeader_Get(message.msg, bind_data.header_fields[filter.header_index].c_str(), &value) != NATS_OK) {
+            return false;
+        }
+        if (!filter.values.empty() &&
+            std::find(filter.values.begin(), filter.values.end(), value) == filter.values.end()) {
+            return false;
+        }
+    }
+    return true;
+}
 
-        // Set end_seq if not specified
-        if (global_state.end_seq == UINT64_MAX) {
-            global_state.end_seq = global_state.stream_info->State.LastSeq;
+// json_auto: infer the JSON fields from the first sample_size matching messages of the
+// resolved scan range, taken from the streams in scan order
+static vector<NatsJsonField> InferJsonFields(ClientContext &context, const NatsScanBindData &bind_data,
+                                             idx_t sample_size) {
+    NatsConnectionLease connection(context, bind_data.nats_url);
+    NatsJsonSchemaInference inference;
+    NatsDecompressor decompressor;
+    idx_t sampled = 0;
+    vector<NatsFetchedMessage> messages;
+    // Frees the sampled messages if a fetch throws part way through a batch
+    NatsFetchedMessagesGuard messages_guard(messages);
+    for (idx_t i = 0; i < bind_data.stream_names.size() && sampled < sample_size; i++) {
+        auto &stream_name = bind_data.stream_names[i];
+        NatsScanStream stream;
+        stream.info = NatsGetStreamInfo(connection.js, stream_name);
+        uint64_t cursor_seq = bind_data.cursor_seqs.empty() ? 0 : bind_data.cursor_seqs[i];
+        ResolveStreamRange(connection.conn, connection.js, stream_name, bind_data, cursor_seq, stream, nullptr);
+        jsStreamInfo_Destroy(stream.info);
+        stream.info = nullptr;
+
+        NatsDirectGetFetcher fetcher(connection.conn, connection.js, stream_name, bind_data.subject_filter);
+        uint64_t next_seq = stream.next_seq;
+        while (next_seq != 0 && next_seq <= stream.end_seq && sampled < sample_size) {
+            bool more = fetcher.Fetch(next_seq, stream.end_seq, sample_size - sampled, messages);
+            for (auto &message : messages) {
+                if (sampled >= sample_size || !MessageMatches(bind_data, message)) {
+                    continue;
+                }
+                const char *data = natsMsg_GetData(message.msg);
+                idx_t data_len = natsMsg_GetDataLength(message.msg);
+                auto codec = NatsDetectCompression(bind_data.compression, message.msg, data, data_len);
+                if (codec != NatsCompression::NONE) {
+                    // Payloads that do not decompress are left out of the sample
+                    if (!decompressor.Decompress(codec, data, data_len)) {
+                        continue;
+                    }
+                    data = decompressor.Data();
+                    data_len = decompressor.Size();
+                }
+                inference.AddSample(data, data_len);
+                sampled++;
+            }
+            NatsDirectGetFetcher::DestroyMessages(messages);
+            if (!more) {
+                break;
+            }
         }
     }
+    return inference.GetFields();
+}
 
-    // Resolve timestamps to sequences if needed (only once)
-    if (!global_state.timestamps_resolved && (bind_data.start_time > 0 || bind_data.end_time > 0)) {
-        // Resolve start_time to start sequence
-        if (bind_data.start_time > 0) {
-            uint64_t resolved_seq = ResolveTimestampToSequence(
-                global_state.js,
-                bind_data.stream_name.c_str(),
-                bind_data.start_time,
-                global_state.stream_info->State.FirstSeq,
-                global_state.stream_info->State.LastSeq
-            );
+// Follow mode: wait for messages published after the scanned range and write them as soon
+// as they arrive, rather than waiting for a full chunk. Returns the number of rows written,
+// or 0 once the scan should end (idle timeout, max_rows reached or query interrupted).
+static idx_t FollowStream(ClientContext &context, const NatsScanBindData &bind_data,
+                          NatsScanGlobalState &global_state, NatsScanLocalState &local_state, DataChunk &output) {
+    if (global_state.rows_left == 0) {
+        return 0;
+    }
+    auto &stream = global_state.streams[0];
+    if (!global_state.follower) {
+        // Continue right after the stream's last message when the scan started
+        uint64_t follow_seq = MaxValue<uint64_t>(stream.start_seq, stream.info->State.LastSeq + 1);
+        global_state.follower = make_uniq<NatsFollowFetcher>(global_state.connection->js, bind_data.stream_names[0],
+                                                             bind_data.subject_filter, follow_seq);
+    }
 
-            // If resolved_seq is UINT64_MAX, it means no messages exist at or after this timestamp
-            if (resolved_seq == UINT64_MAX) {
-                global_state.done = true;
-                global_state.timestamps_resolved = true;
-                output.SetCardinality(0);
-                return;
+    auto idle_since = std::chrono::steady_clock::now();
+    auto first_row = idle_since;
+    uint64_t last_seq = 0;
+    idx_t count = 0;
+    while (count < STANDARD_VECTOR_SIZE && global_state.rows_left > 0 && !context.IsInterrupted()) {
+        auto now = std::chrono::steady_clock::now();
+        int64_t wait_ms = NATS_FOLLOW_POLL_MS;
+        if (count > 0) {
+            // Rows are ready: only wait out the rest of max_wait for more
+            auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(now - first_row).count();
+            if (waited >= bind_data.max_wait_ms) {
+                break;
             }
+            wait_ms = MinValue<int64_t>(wait_ms, bind_data.max_wait_ms - waited);
+        } else if (bind_data.idle_timeout_ms > 0) {
+            auto idle = std::chrono::duration_cast<std::chrono::milliseconds>(now - idle_since).count();
+            if (idle >= bind_data.idle_timeout_ms) {
+                break;
+            }
+            wait_ms = MinValue<int64_t>(wait_ms, bind_data.idle_timeout_ms - idle);
+        }
 
-            global_state.current_seq = resolved_seq;
+        if (!global_state.follower->Fetch(wait_ms, STANDARD_VECTOR_SIZE - count, local_state.messages)) {
+            continue;
+        }
+        last_seq = local_state.messages.back().seq;
+        uint64_t decode_start = NatsNowNanos();
+        for (auto &message : local_state.messages) {
+            if (!MessageMatches(bind_data, message)) {
+                local_state.skipped_filter++;
+                continue;
+            }
+            // A start_time after the stream's last message skips messages published before it
+            if (message.time_ns < bind_data.start_time) {
+                continue;
+            }
+            if (count == 0) {
+                first_row = std::chrono::steady_clock::now();
+            }
+            WriteMessageRow(bind_data, global_state.projection, local_state, message, output, count);
+            count++;
         }
+        local_state.decode_ns += NatsNowNanos() - decode_start;
+        NatsDirectGetFetcher::DestroyMessages(local_state.messages);
+    }
 
-        // Resolve end_time to end sequence
-        if (bind_data.end_time > 0) {
-            uint64_t resolved_seq = ResolveTimestampToSequence(
-                global_state.js,
-                bind_data.stream_name.c_str(),
-                bind_data.end_time,
-                global_state.stream_info->State.FirstSeq,
-                global_state.stream_info->State.LastSeq
-            );
+    // Every message fetched here is returned with this chunk
+    local_state.stream_index = 0;
+    local_state.batch_index = global_state.NextBatchIndex(0, last_seq);
+    global_state.ReturnBatch(local_state.batch_index, 0, true);
+    return count;
+}
 
-            // If resolved_seq is UINT64_MAX, use the last sequence in the stream
-            if (resolved_seq != UINT64_MAX) {
-                global_state.end_seq = resolved_seq;
+// Reverse scans: read the next morsel whole, keeping its matching messages in
+// reverse_messages so they can be written from the last one backward. Under a pushed-down
+// limit only the last messages the stream still needs are kept. Returns false once every
+// morsel has been read.
+static bool ReadReverseMorsel(const NatsScanBindData &bind_data, NatsScanGlobalState &global_state,
+                              NatsScanLocalState &local_state) {
+    auto &buffered = local_state.reverse_messages;
+    auto keep_matching = [&](vector<NatsFetchedMessage> &messages) {
+        for (auto &message : messages) {
+            if (MessageMatches(bind_data, message)) {
+                buffered.push_back(message);
+                message.msg = nullptr;
+            } else {
+                local_state.skipped_filter++;
+            }
+        }
+        NatsDirectGetFetcher::DestroyMessages(messages);
+        if (bind_data.stream_limit > 0 && buffered.size() > bind_data.stream_limit - local_state.stream_rows) {
+            auto drop = buffered.size() - (bind_data.stream_limit - local_state.stream_rows);
+            for (idx_t i = 0; i < drop; i++) {
+                natsMsg_Destroy(buffered[i].msg);
             }
+            buffered.erase(buffered.begin(), buffered.begin() + drop);
         }
+    };
 
-        global_state.timestamps_resolved = true;
+    if (local_state.prefetcher) {
+        auto &batch = local_state.prefetch_batch;
+        do {
+            if (!local_state.prefetcher->Next(batch)) {
+                return false;
+            }
+            local_state.stream_index = batch.stream_index;
+            local_state.batch_index = batch.batch_index;
+            keep_matching(batch.messages);
+        } while (!batch.end_of_morsel);
+        return true;
     }
 
-    if (global_state.current_seq > global_state.end_seq) {
-        global_state.done = true;
-        output.SetCardinality(0);
-        return;
+    auto &morsel = local_state.morsel;
+    if (!global_state.ClaimMorsel(morsel)) {
+        return false;
+    }
+    local_state.fetcher->SetStream(bind_data.stream_names[morsel.stream_index]);
+    local_state.fetcher->SetCache(morsel.cache);
+    local_state.stream_index = morsel.stream_index;
+    local_state.batch_index = morsel.batch_index;
+    if (morsel.stream_index != local_state.limit_stream) {
+        local_state.limit_stream = morsel.stream_index;
+        local_state.stream_rows = 0;
+    }
+    uint64_t next_seq = morsel.start_seq;
+    bool more = true;
+    while (more) {
+        more = local_state.fetcher->Fetch(next_seq, morsel.end_seq, STANDARD_VECTOR_SIZE, local_state.messages);
+        keep_matching(local_state.messages);
+    }
+    return true;
+}
+
+// Complete an output chunk of `count` rows. In follow mode, a thread that has run out of
+// messages becomes the follower and waits for new ones instead of ending its scan.
+static void FinishChunk(ClientContext &context, const NatsScanBindData &bind_data, NatsScanGlobalState &global_state,
+                        NatsScanLocalState &local_state, DataChunk &output, idx_t count) {
+    if (count == 0 && bind_data.follow && (local_state.following || global_state.ClaimFollower())) {
+        local_state.following = true;
+        count = FollowStream(context, bind_data, global_state, local_state, output);
+    }
+    if (bind_data.max_rows > 0) {
+        count = global_state.TakeRows(count);
     }
 
+    if (count > 0) {
+        global_state.ReturnBatch(local_state.batch_index, local_state.returned_seq, false);
+    }
+
+    auto &stats = global_state.stats;
+    stats.rows += count;
+    if (local_state.skipped_filter > 0) {
+        stats.skipped_filter += local_state.skipped_filter;
+        local_state.skipped_filter = 0;
+    }
+    stats.decode_ns += local_state.decode_ns;
+    local_state.decode_ns = 0;
+
+    auto &projection = global_state.projection;
+    if (projection.subject_col != DConstants::INVALID_INDEX) {
+        local_state.subject_dictionary.Finish(output.data[projection.subject_col], count);
+    }
+    WriteConstantColumns(bind_data.stream_names[local_state.stream_index], projection, output);
+    output.SetCardinality(count);
+}
+
+// Main scan function - retrieves data from NATS
+static void NatsScanExecute(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+    auto &bind_data = data_p.bind_data->Cast<NatsScanBindData>();
+    auto &global_state = data_p.global_state->Cast<NatsScanGlobalState>();
+    auto &local_state = data_p.local_state->Cast<NatsScanLocalState>();
+
     idx_t count = 0;
     const idx_t max_rows = STANDARD_VECTOR_SIZE;
 
-    // Fetch messages one at a time up to max_rows
-    while (count < max_rows && global_state.current_seq <= global_state.end_seq) {
-        // Fetch message by sequence number
-        natsMsg *msg = nullptr;
-
-        // Use direct get to fetch message by sequence
-        jsDirectGetMsgOptions opts;
-        memset(&opts, 0, sizeof(opts));
-        opts.Sequence = global_state.current_seq;
+    // Payloads and header values are referenced in place; the chunk's vectors that point
+    // into the messages own them
+    auto &projection = global_state.projection;
+    if (projection.payload_col != DConstants::INVALID_INDEX || !projection.header_cols.empty()) {
+        auto message_buffer = make_buffer<NatsMessageBuffer>();
+        local_state.chunk_messages = message_buffer.get();
+        if (projection.payload_col != DConstants::INVALID_INDEX) {
+            StringVector::AddBuffer(output.data[projection.payload_col], message_buffer);
+        }
+        for (auto &header_col : projection.header_cols) {
+            StringVector::AddBuffer(output.data[header_col.first], message_buffer);
+        }
+    }
+    if (global_state.projection.subject_col != DConstants::INVALID_INDEX) {
+        local_state.subject_dictionary.Reset();
+    }
 
-        natsStatus s = js_DirectGetMsg(&msg, global_state.js,
-                                       bind_data.stream_name.c_str(), nullptr, &opts);
+    // The scan has returned max_rows rows, or this thread follows the stream for new messages
+    if (global_state.rows_left == 0 || local_state.following) {
+        FinishChunk(context, bind_data, global_state, local_state, output, 0);
+        return;
+    }
 
-        if (s == NATS_NOT_FOUND) {
-            // Message not found at this sequence, skip to next
-            global_state.current_seq++;
-            continue;
+    // Consumer and last mode: one pull per chunk from the shared fetcher. An empty chunk ends
+    // the scan for this thread, so keep pulling until a pull returns rows or the range is drained.
+    if (bind_data.mode != NatsScanMode::DIRECT) {
+        while (count == 0 && global_state.FetchShared(max_rows, local_state.messages, local_state.stream_index,
+                                                          local_state.batch_index)) {
+            uint64_t decode_start = NatsNowNanos();
+            for (auto &message : local_state.messages) {
+                if (!MessageMatches(bind_data, message)) {
+                    local_state.skipped_filter++;
+                    continue;
+                }
+                WriteMessageRow(bind_data, global_state.projection, local_state, message, output, count);
+                count++;
+            }
+            local_state.decode_ns += NatsNowNanos() - decode_start;
+            NatsDirectGetFetcher::DestroyMessages(local_state.messages);
+            global_state.ReturnBatch(local_state.batch_index, 0, true);
         }
+        FinishChunk(context, bind_data, global_state, local_state, output, count);
+        return;
+    }
 
-        if (s != NATS_OK) {
-            // Other error - throw exception
-            throw std::runtime_error(std::string("Failed to fetch message at sequence ") +
-                                   std::to_string(global_state.current_seq) + ": " + natsStatus_GetText(s));
+    // Reverse scans: write each morsel from its last matching message backward. A chunk never
+    // spans two morsels, so every emitted chunk carries exactly one batch index.
+    if (bind_data.reverse) {
+        auto &buffered = local_state.reverse_messages;
+        // Time spent writing rows is the loop's time minus the time spent reading morsels
+        uint64_t loop_start = NatsNowNanos();
+        uint64_t read_ns = 0;
+        while (count < max_rows) {
+            if (!local_state.has_morsel) {
+                if (count > 0) {
+                    break;
+                }
+                uint64_t read_start = NatsNowNanos();
+                bool read = ReadReverseMorsel(bind_data, global_state, local_state);
+                read_ns += NatsNowNanos() - read_start;
+                if (!read) {
+                    break;
+                }
+                local_state.has_morsel = true;
+            }
+            if (!buffered.empty()) {
+                WriteMessageRow(bind_data, global_state.projection, local_state, buffered.back(), output, count);
+                natsMsg_Destroy(buffered.back().msg);
+                buffered.pop_back();
+                local_state.stream_rows++;
+                count++;
+                continue;
+            }
+            local_state.has_morsel = false;
+            global_state.ReturnBatch(local_state.batch_index, 0, true);
+            if (bind_data.stream_limit > 0 && local_state.stream_rows >= bind_data.stream_limit) {
+                global_state.EndStream(local_state.stream_index);
+            }
         }
+        local_state.decode_ns += NatsNowNanos() - loop_start - read_ns;
+        FinishChunk(context, bind_data, global_state, local_state, output, count);
+        return;
+    }
 
-        // For direct get messages, extract basic message info
-        const char *subject = natsMsg_GetSubject(msg);
+    // Prefetching: write batches fetched by the background thread. A chunk never spans two
+    // morsels, so every emitted chunk carries exactly one batch index.
+    if (local_state.prefetcher) {
+        auto &batch = local_state.prefetch_batch;
+        // Time spent writing rows is the loop's time minus the time waiting for batches
+        uint64_t loop_start = NatsNowNanos();
+        uint64_t wait_ns = 0;
+        while (count < max_rows) {
+            if (local_state.prefetch_offset == batch.messages.size()) {
+                NatsDirectGetFetcher::DestroyMessages(batch.messages);
+                local_state.prefetch_offset = 0;
+                if (batch.end_of_morsel) {
+                    global_state.ReturnBatch(batch.batch_index, 0, true);
+                }
+                if (batch.end_of_morsel && count > 0) {
+                    // Keep the flag so the next chunk starts with a fresh batch
+                    break;
+                }
+                uint64_t wait_start = NatsNowNanos();
+                bool next = local_state.prefetcher->Next(batch);
+                wait_ns += NatsNowNanos() - wait_start;
+                if (!next) {
+                    break;
+                }
+                local_state.stream_index = batch.stream_index;
+                local_state.batch_index = batch.batch_index;
+                continue;
+            }
+            auto &message = batch.messages[local_state.prefetch_offset++];
+            if (!MessageMatches(bind_data, message)) {
+                local_state.skipped_filter++;
+                continue;
+            }
+            WriteMessageRow(bind_data, global_state.projection, local_state, message, output, count);
+            count++;
+        }
+        local_state.decode_ns += NatsNowNanos() - loop_start - wait_ns;
+        FinishChunk(context, bind_data, global_state, local_state, output, count);
+        return;
+    }
 
-        // Check if subject matches filter (if specified)
-        if (!bind_data.subject_filter.empty() &&
-            string(subject).find(bind_data.subject_filter) == string::npos) {
-            natsMsg_Destroy(msg);
-            global_state.current_seq++;
-            continue;
+    // Fetch messages in batches up to max_rows
+    while (count < max_rows) {
+        // Claim the next morsel once the current one is exhausted. A chunk never spans
+        // two morsels, so every emitted chunk carries exactly one batch index.
+        if (!local_state.has_morsel) {
+            if (count > 0) {
+                break;
+            }
+            auto &morsel = local_state.morsel;
+            if (!global_state.ClaimMorsel(morsel)) {
+                break;
+            }
+            local_state.fetcher->SetStream(bind_data.stream_names[morsel.stream_index]);
+            local_state.fetcher->SetCache(morsel.cache);
+            local_state.current_seq = morsel.start_seq;
+            local_state.stream_index = morsel.stream_index;
+            local_state.batch_index = morsel.batch_index;
+            local_state.has_morsel = true;
+            if (morsel.stream_index != local_state.limit_stream) {
+                local_state.limit_stream = morsel.stream_index;
+                local_state.stream_rows = 0;
+            }
         }
 
-        // Get message timestamp and convert from nanoseconds to microseconds
-        int64_t timestamp_us = natsMsg_GetTime(msg) / 1000;
+        // Fetch the next batch of messages from the morsel
+        local_state.has_morsel = local_state.fetcher->Fetch(local_state.current_seq, local_state.morsel.end_seq,
+                                                            max_rows - count, local_state.messages);
 
-        // Column 0: stream
-        output.SetValue(0, count, Value(bind_data.stream_name));
+        // The subject filter is applied by the server; subject lists and header filters are matched here
+        uint64_t decode_start = NatsNowNanos();
+        for (auto &message : local_state.messages) {
+            if (!MessageMatches(bind_data, message)) {
+                local_state.skipped_filter++;
+                continue;
+            }
+            if (bind_data.stream_limit > 0 && local_state.stream_rows >= bind_data.stream_limit) {
+                break;
+            }
+            WriteMessageRow(bind_data, global_state.projection, local_state, message, output, count);
+            local_state.stream_rows++;
+            count++;
+        }
+        local_state.decode_ns += NatsNowNanos() - decode_start;
 
-        // Column 1: subject
-        output.SetValue(1, count, Value(subject));
+        // Clean up
+        NatsDirectGetFetcher::DestroyMessages(local_state.messages);
+        if (bind_data.stream_limit > 0 && local_state.stream_rows >= bind_data.stream_limit) {
+            // The stream has returned every row the limit needs
+            global_state.EndStream(local_state.stream_index);
+            local_state.has_morsel = false;
+        }
+        if (!local_state.has_morsel) {
+            global_state.ReturnBatch(local_state.batch_index, 0, true);
+        }
+    }
 
-        // Column 2: seq
-        output.SetValue(2, count, Value::UBIGINT(global_state.current_seq));
+    FinishChunk(context, bind_data, global_state, local_state, output, count);
+}
 
-        // Column 3: ts_nats
-        output.SetValue(3, count, Value::TIMESTAMP(timestamp_t(timestamp_us)));
+// Range bounds extracted from pushed-down filters, in the same units as the bind data
+struct NatsScanFilterBounds {
+    uint64_t start_seq = 0;
+    uint64_t end_seq = UINT64_MAX;
+    int64_t start_time = 0;  // Nanoseconds since epoch, 0 means unbounded
+    int64_t end_time = 0;    // Nanoseconds since epoch, 0 means unbounded
+};
 
-        // Column 4: payload (raw bytes)
-        const char *data = natsMsg_GetData(msg);
-        int data_len = natsMsg_GetDataLength(msg);
+// Resolve an expression to the nats_scan column it reads. Monotonic casts of seq (to wider
+// numeric types) and of ts_nats (to TIMESTAMP WITH TIME ZONE) are looked through.
+static idx_t GetFilteredColumn(LogicalGet &get, Expression &expr, bool &through_tz_cast) {
+    Expression *current = &expr;
+    through_tz_cast = false;
+    if (current->GetExpressionClass() == ExpressionClass::BOUND_CAST) {
+        auto &cast = current->Cast<BoundCastExpression>();
+        if (cast.try_cast) {
+            return DConstants::INVALID_INDEX;
+        }
+        through_tz_cast = cast.return_type.id() == LogicalTypeId::TIMESTAMP_TZ;
+        if (!through_tz_cast && !cast.return_type.IsNumeric()) {
+            return DConstants::INVALID_INDEX;
+        }
+        current = cast.child.get();
+    }
+    if (current->GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF) {
+        return DConstants::INVALID_INDEX;
+    }
+    auto &colref = current->Cast<BoundColumnRefExpression>();
+    auto &column_ids = get.GetColumnIds();
+    if (colref.binding.table_index != get.table_index || colref.binding.column_index >= column_ids.size()) {
+        return DConstants::INVALID_INDEX;
+    }
+    auto column = column_ids[colref.binding.column_index].GetPrimaryIndex();
+    if (column == NATS_COL_SEQ && !through_tz_cast) {
+        return column;
+    }
+    if (column == NATS_COL_TS && (through_tz_cast || current == &expr)) {
+        return column;
+    }
+    return DConstants::INVALID_INDEX;
+}
 
-        // Use BLOB for protobuf OR when no extraction is specified (prevents UTF-8 validation errors)
-        // Use VARCHAR only when json_extract is specified (data is known to be valid JSON/UTF-8)
-        if (!bind_data.proto_fields.empty() || bind_data.json_fields.empty()) {
-            output.SetValue(4, count, Value::BLOB(const_data_ptr_cast(data), data_len));
-        } else {
-            string payload_str(data, data_len);
-            output.SetValue(4, count, Value(payload_str));
-        }
-
-        // Extract JSON fields if requested
-        if (!bind_data.json_fields.empty()) {
-            // Parse JSON payload
-            yyjson_doc *doc = yyjson_read(data, data_len, 0);
-
-            if (doc) {
-                yyjson_val *root = yyjson_doc_get_root(doc);
-
-                // Extract each requested field
-                for (size_t i = 0; i < bind_data.json_fields.size(); i++) {
-                    const char *field_name = bind_data.json_fields[i].c_str();
-                    yyjson_val *field_val = yyjson_obj_get(root, field_name);
-
-                    // Column index is 5 + i (after stream, subject, seq, ts_nats, payload)
-                    idx_t col_idx = 5 + i;
-
-                    if (field_val) {
-                        // Convert value to string based on type
-                        if (yyjson_is_str(field_val)) {
-                            const char *str_val = yyjson_get_str(field_val);
-                            output.SetValue(col_idx, count, Value(str_val));
-                        } else if (yyjson_is_num(field_val)) {
-                            // Convert number to string
-                            double num_val = yyjson_get_num(field_val);
-                            output.SetValue(col_idx, count, Value(std::to_string(num_val)));
-                        } else if (yyjson_is_bool(field_val)) {
-                            bool bool_val = yyjson_get_bool(field_val);
-                            output.SetValue(col_idx, count, Value(bool_val ? "true" : "false"));
-                        } else if (yyjson_is_null(field_val)) {
-                            output.SetValue(col_idx, count, Value());  // NULL
-                        } else {
-                            // For objects/arrays, convert to JSON string
-                            char *json_str = yyjson_val_write(field_val, 0, nullptr);
-                            if (json_str) {
-                                output.SetValue(col_idx, count, Value(json_str));
-                                free(json_str);
-                            } else {
-                                output.SetValue(col_idx, count, Value());  // NULL on error
-                            }
-                        }
-                    } else {
-                        // Field not found - set to NULL
-                        output.SetValue(col_idx, count, Value());
-                    }
-                }
+// Apply `seq <cmp> constant` to the bounds
+static void ApplySeqBound(NatsScanFilterBounds &bounds, ExpressionType cmp, const Value &constant) {
+    // Work in HUGEINT so that negative and fractional constants round conservatively
+    hugeint_t lower, upper;
+    if (constant.type().IsIntegral()) {
+        Value as_hugeint;
+        if (!constant.DefaultTryCastAs(LogicalType::HUGEINT, as_hugeint)) {
+            return;
+        }
+        lower = upper = as_hugeint.GetValue<hugeint_t>();
+    } else {
+        Value as_double;
+        if (!constant.DefaultTryCastAs(LogicalType::DOUBLE, as_double)) {
+            return;
+        }
+        double d = as_double.GetValue<double>();
+        if (!std::isfinite(d) || std::fabs(d) > 9.0e18) {
+            return;
+        }
+        lower = hugeint_t(static_cast<int64_t>(std::ceil(d)));
+        upper = hugeint_t(static_cast<int64_t>(std::floor(d)));
+        if (cmp == ExpressionType::COMPARE_GREATERTHAN && lower != upper) {
+            cmp = ExpressionType::COMPARE_GREATERTHANOREQUALTO;
+        } else if (cmp == ExpressionType::COMPARE_LESSTHAN && lower != upper) {
+            cmp = ExpressionType::COMPARE_LESSTHANOREQUALTO;
+        }
+    }
 
-                yyjson_doc_free(doc);
-            } else {
-                // JSON parsing failed - set all JSON fields to NULL
-                for (size_t i = 0; i < bind_data.json_fields.size(); i++) {
-                    idx_t col_idx = 5 + i;
-                    output.SetValue(col_idx, count, Value());
-                }
+    const hugeint_t max_seq(0, UINT64_MAX);
+    auto tighten_start = [&](hugeint_t value) {
+        if (value > max_seq) {
+            bounds.start_seq = UINT64_MAX;
+            bounds.end_seq = 0;
+        } else if (value > hugeint_t(0)) {
+            bounds.start_seq = MaxValue<uint64_t>(bounds.start_seq, Hugeint::Cast<uint64_t>(value));
+        }
+    };
+    auto tighten_end = [&](hugeint_t value) {
+        if (value < hugeint_t(0)) {
+            bounds.end_seq = 0;
+        } else if (value < max_seq) {
+            bounds.end_seq = MinValue<uint64_t>(bounds.end_seq, Hugeint::Cast<uint64_t>(value));
+        }
+    };
+
+    switch (cmp) {
+    case ExpressionType::COMPARE_EQUAL:
+        tighten_start(lower);
+        tighten_end(upper);
+        break;
+    case ExpressionType::COMPARE_GREATERTHAN:
+        tighten_start(upper + hugeint_t(1));
+        break;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+        tighten_start(lower);
+        break;
+    case ExpressionType::COMPARE_LESSTHAN:
+        tighten_end(lower - hugeint_t(1));
+        break;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+        tighten_end(upper);
+        break;
+    default:
+        break;
+    }
+}
+
+// Apply `ts_nats <cmp> constant` to the bounds. Bounds are only ever widened relative to
+// the predicate: DuckDB still evaluates the filter, the scan just skips what cannot match.
+static void ApplyTimeBound(ClientContext &context, NatsScanFilterBounds &bounds, ExpressionType cmp,
+                           const Value &constant, bool through_tz_cast) {
+    Value as_timestamp;
+    int64_t slack_us = 0;
+    if (through_tz_cast) {
+        // ts_nats was cast to TIMESTAMP WITH TIME ZONE. Map the constant back to a plain
+        // timestamp with the session's cast, and widen by an hour unless the session is in
+        // UTC, since the wall-clock mapping is ambiguous around DST transitions.
+        auto cast = BoundCastExpression::AddCastToType(context, make_uniq<BoundConstantExpression>(constant),
+                                                       LogicalType::TIMESTAMP);
+        if (!ExpressionExecutor::TryEvaluateScalar(context, *cast, as_timestamp)) {
+            return;
+        }
+        Value time_zone;
+        if (context.TryGetCurrentSetting("TimeZone", time_zone)) {
+            auto tz = StringUtil::Lower(time_zone.ToString());
+            if (tz != "utc" && tz != "etc/utc" && tz != "gmt" && tz != "etc/gmt") {
+                slack_us = Interval::MICROS_PER_HOUR;
             }
         }
+    } else if (!constant.DefaultTryCastAs(LogicalType::TIMESTAMP, as_timestamp)) {
+        return;
+    }
+    if (as_timestamp.IsNull()) {
+        return;
+    }
+    auto ts = as_timestamp.GetValue<timestamp_t>();
+    if (!Timestamp::IsFinite(ts)) {
+        return;
+    }
+    // Keep the nanosecond conversion below from overflowing
+    const int64_t max_us = NumericLimits<int64_t>::Maximum() / 1000 - Interval::MICROS_PER_HOUR - 1;
+    if (ts.value <= slack_us || ts.value >= max_us) {
+        return;
+    }
 
-        // Extract protobuf fields if requested
-        if (!bind_data.proto_fields.empty() && global_state.proto_prototype != nullptr) {
-            // Create a new message instance
-            Message* proto_message = global_state.proto_prototype->New();
+    // ts_nats is truncated to microseconds, so `ts_nats <= t` admits messages up to t + 1us (exclusive)
+    int64_t lower_ns = (ts.value - slack_us) * 1000;
+    int64_t upper_exclusive_ns = (ts.value + slack_us + 1) * 1000;
+    int64_t upper_ns = (ts.value + slack_us) * 1000;
+
+    auto tighten_start = [&](int64_t value) {
+        bounds.start_time = MaxValue<int64_t>(bounds.start_time, value);
+    };
+    auto tighten_end = [&](int64_t value) {
+        bounds.end_time = bounds.end_time == 0 ? value : MinValue<int64_t>(bounds.end_time, value);
+    };
+
+    // end_time is inclusive, so exclusive upper bounds end one nanosecond before them
+    switch (cmp) {
+    case ExpressionType::COMPARE_EQUAL:
+        tighten_start(lower_ns);
+        tighten_end(upper_exclusive_ns - 1);
+        break;
+    case ExpressionType::COMPARE_GREATERTHAN:
+        tighten_start(slack_us == 0 ? upper_exclusive_ns : lower_ns);
+        break;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+        tighten_start(lower_ns);
+        break;
+    case ExpressionType::COMPARE_LESSTHAN:
+        tighten_end(upper_ns - 1);
+        break;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+        tighten_end(upper_exclusive_ns - 1);
+        break;
+    default:
+        break;
+    }
+}
 
-            // Parse the protobuf message from the payload
-            bool parse_success = proto_message->ParseFromArray(data, data_len);
+// Apply `column <cmp> constant_expr` if it is a range predicate on seq or ts_nats
+static void ApplyComparisonBound(ClientContext &context, LogicalGet &get, NatsScanFilterBounds &bounds,
+                                 Expression &column_expr, ExpressionType cmp, Expression &constant_expr) {
+    if (!constant_expr.IsFoldable()) {
+        return;
+    }
+    bool through_tz_cast;
+    auto column = GetFilteredColumn(get, column_expr, through_tz_cast);
+    if (column == DConstants::INVALID_INDEX) {
+        return;
+    }
+    Value constant;
+    if (!ExpressionExecutor::TryEvaluateScalar(context, constant_expr, constant) || constant.IsNull()) {
+        return;
+    }
+    if (column == NATS_COL_SEQ) {
+        ApplySeqBound(bounds, cmp, constant);
+    } else {
+        ApplyTimeBound(context, bounds, cmp, constant, through_tz_cast);
+    }
+}
 
-            if (parse_success) {
-                // Extract each requested field
-                for (size_t i = 0; i < bind_data.proto_fields.size(); i++) {
-                    const string& field_path = bind_data.proto_fields[i];
+// Resolve an expression to the header_extract column it reads, as an index into header_fields
+static idx_t GetFilteredHeader(LogicalGet &get, const NatsScanBindData &bind_data, Expression &expr) {
+    if (expr.GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF) {
+        return DConstants::INVALID_INDEX;
+    }
+    auto &colref = expr.Cast<BoundColumnRefExpression>();
+    auto &column_ids = get.GetColumnIds();
+    if (colref.binding.table_index != get.table_index || colref.binding.column_index >= column_ids.size()) {
+        return DConstants::INVALID_INDEX;
+    }
+    auto column = column_ids[colref.binding.column_index].GetPrimaryIndex();
+    auto first_header = NATS_BASE_COLUMN_COUNT + bind_data.FieldCount();
+    if (column < first_header || column >= first_header + bind_data.header_fields.size()) {
+        return DConstants::INVALID_INDEX;
+    }
+    return column - first_header;
+}
 
-                    // Column index is 5 + i (after stream, subject, seq, ts_nats, payload)
-                    idx_t col_idx = 5 + i;
+// Add the VARCHAR constant of a header filter to values. Returns false if it is not one.
+static bool AddHeaderFilterValue(ClientContext &context, Expression &constant_expr, vector<string> &values) {
+    Value constant;
+    if (!constant_expr.IsFoldable() || !ExpressionExecutor::TryEvaluateScalar(context, constant_expr, constant) ||
+        constant.IsNull() || constant.type().id() != LogicalTypeId::VARCHAR) {
+        return false;
+    }
+    values.push_back(StringValue::Get(constant));
+    return true;
+}
 
-                    // Extract the value
-                    Value field_value = ExtractProtobufValue(proto_message, field_path, bind_data.proto_descriptor);
-                    output.SetValue(col_idx, count, field_value);
-                }
-            } else {
-                // Protobuf parsing failed - set all protobuf fields to NULL
-                for (size_t i = 0; i < bind_data.proto_fields.size(); i++) {
-                    idx_t col_idx = 5 + i;
-                    output.SetValue(col_idx, count, Value());
-                }
+// Turn `header = constant`, `header IN (constants)` and `header IS NOT NULL` on a
+// header_extract column into a header filter
+static void ApplyHeaderFilter(ClientContext &context, LogicalGet &get, NatsScanBindData &bind_data,
+                              Expression &filter) {
+    NatsHeaderFilter header_filter;
+    header_filter.header_index = DConstants::INVALID_INDEX;
+    if (filter.GetExpressionType() == ExpressionType::COMPARE_EQUAL) {
+        auto &comparison = filter.Cast<BoundComparisonExpression>();
+        header_filter.header_index = GetFilteredHeader(get, bind_data, *comparison.left);
+        auto constant = comparison.right.get();
+        if (header_filter.header_index == DConstants::INVALID_INDEX) {
+            header_filter.header_index = GetFilteredHeader(get, bind_data, *comparison.right);
+            constant = comparison.left.get();
+        }
+        if (header_filter.header_index == DConstants::INVALID_INDEX ||
+            !AddHeaderFilterValue(context, *constant, header_filter.values)) {
+            return;
+        }
+    } else if (filter.GetExpressionType() == ExpressionType::COMPARE_IN) {
+        auto &in = filter.Cast<BoundOperatorExpression>();
+        header_filter.header_index = GetFilteredHeader(get, bind_data, *in.children[0]);
+        if (header_filter.header_index == DConstants::INVALID_INDEX) {
+            return;
+        }
+        for (idx_t i = 1; i < in.children.size(); i++) {
+            if (!AddHeaderFilterValue(context, *in.children[i], header_filter.values)) {
+                return;
             }
+        }
+    } else if (filter.GetExpressionType() == ExpressionType::OPERATOR_IS_NOT_NULL) {
+        auto &is_not_null = filter.Cast<BoundOperatorExpression>();
+        header_filter.header_index = GetFilteredHeader(get, bind_data, *is_not_null.children[0]);
+        if (header_filter.header_index == DConstants::INVALID_INDEX) {
+            return;
+        }
+    } else {
+        return;
+    }
+    bind_data.header_filters.push_back(std::move(header_filter));
+}
 
-            // Clean up the message
-            delete proto_message;
+// Filter pushdown: turn range predicates on seq and ts_nats into scan bounds, and
+// predicates on header_extract columns into header filters that skip messages before
+// their payload is decoded. The filters stay in the plan, so this only narrows what is
+// fetched from the server and decoded.
+static void NatsScanPushdownComplexFilter(ClientContext &context, LogicalGet &get, FunctionData *bind_data_p,
+                                          vector<unique_ptr<Expression>> &filters) {
+    auto &bind_data = bind_data_p->Cast<NatsScanBindData>();
+    NatsScanFilterBounds bounds;
+
+    for (auto &filter : filters) {
+        ApplyHeaderFilter(context, get, bind_data, *filter);
+        if (filter->GetExpressionClass() == ExpressionClass::BOUND_COMPARISON) {
+            auto &comparison = filter->Cast<BoundComparisonExpression>();
+            ApplyComparisonBound(context, get, bounds, *comparison.left, comparison.GetExpressionType(),
+                                 *comparison.right);
+            ApplyComparisonBound(context, get, bounds, *comparison.right,
+                                 FlipComparisonExpression(comparison.GetExpressionType()), *comparison.left);
+        } else if (filter->GetExpressionClass() == ExpressionClass::BOUND_BETWEEN) {
+            auto &between = filter->Cast<BoundBetweenExpression>();
+            ApplyComparisonBound(context, get, bounds, *between.input,
+                                 between.lower_inclusive ? ExpressionType::COMPARE_GREATERTHANOREQUALTO
+                                                         : ExpressionType::COMPARE_GREATERTHAN,
+                                 *between.lower);
+            ApplyComparisonBound(context, get, bounds, *between.input,
+                                 between.upper_inclusive ? ExpressionType::COMPARE_LESSTHANOREQUALTO
+                                                         : ExpressionType::COMPARE_LESSTHAN,
+                                 *between.upper);
         }
+    }
 
-        // Clean up
-        natsMsg_Destroy(msg);
+    bind_data.start_seq = MaxValue<uint64_t>(bind_data.start_seq, bounds.start_seq);
+    if (bounds.start_time > 0) {
+        bind_data.start_time = MaxValue<int64_t>(bind_data.start_time, bounds.start_time);
+    }
 
-        count++;
-        global_state.current_seq++;
+    // In last mode an upper bound on seq or ts_nats filters the latest messages, while
+    // end_seq/end_time select the point in time of the snapshot, so they are not pushed down.
+    // Follow scans have no end, so upper bounds stay filters there as well.
+    if (bind_data.mode == NatsScanMode::LAST || bind_data.follow) {
+        return;
     }
+    bind_data.end_seq = MinValue<uint64_t>(bind_data.end_seq, bounds.end_seq);
+    if (bounds.end_time > 0) {
+        bind_data.end_time = bind_data.end_time == 0 ? bounds.end_time
+                                                     : MinValue<int64_t>(bind_data.end_time, bounds.end_time);
+    }
+}
 
-    // Mark as done if we've reached the end
-    if (global_state.current_seq > global_state.end_seq) {
-        global_state.done = true;
+// Top-N pushdown: an ORDER BY seq [DESC] LIMIT n directly over a nats_scan, with only
+// projections in between, scans each stream in that direction and stops after the first
+// n (plus offset) matching rows of each. The TOP_N stays in the plan and picks the rows of
+// all streams. Scans with a WHERE filter that stays in the plan, max_rows, follow or a
+// cursor are left alone, since they need to see more than the first rows of each stream.
+static void PushdownTopN(LogicalOperator &op) {
+    for (auto &child : op.children) {
+        PushdownTopN(*child);
+    }
+    if (op.type != LogicalOperatorType::LOGICAL_TOP_N) {
+        return;
+    }
+    auto &top_n = op.Cast<LogicalTopN>();
+    if (top_n.orders.empty() || top_n.limit == 0 || top_n.offset > UINT64_MAX - top_n.limit) {
+        return;
     }
 
-    output.SetCardinality(count);
+    // Follow the first order key through projections down to the scan
+    Expression *expr = top_n.orders[0].expression.get();
+    LogicalOperator *child = top_n.children[0].get();
+    while (child->type == LogicalOperatorType::LOGICAL_PROJECTION) {
+        if (expr->GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF) {
+            return;
+        }
+        auto &binding = expr->Cast<BoundColumnRefExpression>().binding;
+        auto &projection = child->Cast<LogicalProjection>();
+        if (binding.table_index != projection.table_index || binding.column_index >= projection.expressions.size()) {
+            return;
+        }
+        expr = projection.expressions[binding.column_index].get();
+        child = child->children[0].get();
+    }
+    if (child->type != LogicalOperatorType::LOGICAL_GET) {
+        return;
+    }
+    auto &get = child->Cast<LogicalGet>();
+    bool through_tz_cast;
+    if (get.function.name != "nats_scan" || !get.bind_data ||
+        GetFilteredColumn(get, *expr, through_tz_cast) != NATS_COL_SEQ) {
+        return;
+    }
+
+    auto &bind_data = get.bind_data->Cast<NatsScanBindData>();
+    if (bind_data.mode != NatsScanMode::DIRECT || bind_data.follow || !bind_data.cursor_name.empty() ||
+        bind_data.max_rows > 0) {
+        return;
+    }
+    bind_data.reverse = top_n.orders[0].type == OrderType::DESCENDING;
+    bind_data.stream_limit = top_n.limit + top_n.offset;
+}
+
+// A cursor counts a row as read once the scan returns it, so a LIMIT or ORDER BY ... LIMIT
+// above a cursor scan would move the cursor past rows the query threw away. Reject such
+// plans; aggregates read every row of their input, so a limit above one is harmless.
+static void CheckCursorLimits(LogicalOperator &op, bool under_limit) {
+    if (op.type == LogicalOperatorType::LOGICAL_LIMIT || op.type == LogicalOperatorType::LOGICAL_TOP_N) {
+        under_limit = true;
+    } else if (op.type == LogicalOperatorType::LOGICAL_AGGREGATE_AND_GROUP_BY) {
+        under_limit = false;
+    } else if (under_limit && op.type == LogicalOperatorType::LOGICAL_GET) {
+        auto &get = op.Cast<LogicalGet>();
+        if (get.function.name == "nats_scan" && get.bind_data &&
+            !get.bind_data->Cast<NatsScanBindData>().cursor_name.empty()) {
+            throw std::runtime_error("cursor cannot be combined with LIMIT: rows the limit discards would "
+                                     "count as read. Bound the scan with end_seq or a WHERE filter instead");
+        }
+    }
+    for (auto &child : op.children) {
+        CheckCursorLimits(*child, under_limit);
+    }
+}
+
+static void NatsScanOptimize(OptimizerExtensionInput &input, unique_ptr<LogicalOperator> &plan) {
+    CheckCursorLimits(*plan, false);
+    PushdownTopN(*plan);
+}
+
+// Scan direction and pushed-down limit, shown in EXPLAIN
+static InsertionOrderPreservingMap<string> NatsScanToString(TableFunctionToStringInput &input) {
+    InsertionOrderPreservingMap<string> result;
+    auto &bind_data = input.bind_data->Cast<NatsScanBindData>();
+    result["Direction"] = bind_data.reverse ? "reverse" : "forward";
+    if (bind_data.stream_limit > 0) {
+        result["Stream Limit"] = std::to_string(bind_data.stream_limit);
+    }
+    return result;
+}
+
+// Counters of the running scan, shown by EXPLAIN ANALYZE and in the profiler output
+static InsertionOrderPreservingMap<string> NatsScanDynamicToString(TableFunctionDynamicToStringInput &input) {
+    InsertionOrderPreservingMap<string> result;
+    if (!input.global_state) {
+        return result;
+    }
+    auto &stats = input.global_state->Cast<NatsScanGlobalState>().stats;
+    result["Round Trips"] = std::to_string(stats.round_trips);
+    result["Messages Received"] = std::to_string(stats.messages_received);
+    result["Bytes Received"] = std::to_string(stats.bytes_received);
+    if (stats.cached_messages > 0) {
+        result["Cached Messages"] = std::to_string(stats.cached_messages);
+    }
+    result["Skipped (Filter)"] = std::to_string(stats.skipped_filter);
+    result["Skipped (Gap)"] = std::to_string(stats.skipped_gap);
+    if (stats.resolve_probes > 0) {
+        result["Resolve Probes"] = std::to_string(stats.resolve_probes);
+    }
+    result["Fetch Time"] = StringUtil::Format("%.2f ms", double(stats.fetch_ns) / 1e6);
+    result["Decode Time"] = StringUtil::Format("%.2f ms", double(stats.decode_ns) / 1e6);
+    return result;
 }
 
 void NatsScanFunction::Register(ExtensionLoader &loader) {
-    TableFunction nats_scan("nats_scan", {LogicalType(LogicalTypeId::VARCHAR)}, NatsScanExecute, NatsScanBind,
+    TableFunction nats_scan("nats_scan", {LogicalType::ANY}, NatsScanExecute, NatsScanBind,
                             NatsScanInitGlobal, NatsScanInitLocal);
+    nats_scan.get_partition_data = NatsScanGetPartitionData;
+    nats_scan.cardinality = NatsScanCardinality;
+    nats_scan.table_scan_progress = NatsScanProgress;
+    nats_scan.projection_pushdown = true;
+    nats_scan.pushdown_complex_filter = NatsScanPushdownComplexFilter;
+    nats_scan.to_string = NatsScanToString;
+    nats_scan.dynamic_to_string = NatsScanDynamicToString;
 
     // Add optional parameters
-    nats_scan.named_parameters["subject"] = LogicalType(LogicalTypeId::VARCHAR);
+    nats_scan.named_parameters["subject"] = LogicalType::ANY;
     nats_scan.named_parameters["url"] = LogicalType(LogicalTypeId::VARCHAR);
     nats_scan.named_parameters["start_seq"] = LogicalType(LogicalTypeId::UBIGINT);
     nats_scan.named_parameters["end_seq"] = LogicalType(LogicalTypeId::UBIGINT);
     nats_scan.named_parameters["start_time"] = LogicalType(LogicalTypeId::TIMESTAMP);
     nats_scan.named_parameters["end_time"] = LogicalType(LogicalTypeId::TIMESTAMP);
-    nats_scan.named_parameters["json_extract"] = LogicalType::LIST(LogicalType(LogicalTypeId::VARCHAR));
+    nats_scan.named_parameters["json_extract"] = LogicalType::ANY;
+    nats_scan.named_parameters["json_auto"] = LogicalType(LogicalTypeId::BOOLEAN);
+    nats_scan.named_parameters["sample_size"] = LogicalType(LogicalTypeId::UBIGINT);
     nats_scan.named_parameters["proto_file"] = LogicalType(LogicalTypeId::VARCHAR);
     nats_scan.named_parameters["proto_message"] = LogicalType(LogicalTypeId::VARCHAR);
     nats_scan.named_parameters["proto_extract"] = LogicalType::LIST(LogicalType(LogicalTypeId::VARCHAR));
+    nats_scan.named_parameters["header_extract"] = LogicalType::LIST(LogicalType(LogicalTypeId::VARCHAR));
+    nats_scan.named_parameters["compression"] = LogicalType(LogicalTypeId::VARCHAR);
+    nats_scan.named_parameters["mode"] = LogicalType(LogicalTypeId::VARCHAR);
+    nats_scan.named_parameters["batch_size"] = LogicalType(LogicalTypeId::INTEGER);
+    nats_scan.named_parameters["max_bytes"] = LogicalType(LogicalTypeId::BIGINT);
+    nats_scan.named_parameters["prefetch_bytes"] = LogicalType(LogicalTypeId::BIGINT);
+    nats_scan.named_parameters["follow"] = LogicalType(LogicalTypeId::BOOLEAN);
+    nats_scan.named_parameters["max_wait"] = LogicalType(LogicalTypeId::INTERVAL);
+    nats_scan.named_parameters["idle_timeout"] = LogicalType(LogicalTypeId::INTERVAL);
+    nats_scan.named_parameters["max_rows"] = LogicalType(LogicalTypeId::UBIGINT);
+    nats_scan.named_parameters["cursor"] = LogicalType(LogicalTypeId::VARCHAR);
+    nats_scan.named_parameters["reverse"] = LogicalType(LogicalTypeId::BOOLEAN);
 
     // Register the function using the ExtensionLoader API
     loader.RegisterFunction(nats_scan);
+
+    // Push ORDER BY seq LIMIT n into the scan, and reject limits over cursor scans
+    OptimizerExtension top_n_pushdown;
+    top_n_pushdown.optimize_function = NatsScanOptimize;
+    DBConfig::GetConfig(loader.GetDatabaseInstance()).optimizer_extensions.push_back(std::move(top_n_pushdown));
 }
 
 } // namespace duckdb
@@ -0,0 +1,97 @@
+#include "nats_stats.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+
+namespace duckdb {
+
+static constexpr const char *NATS_SCAN_STATS_CACHE_KEY = "nats_js_scan_stats";
+
+NatsScanStatsRecord::NatsScanStatsRecord(const NatsScanStats &stats, string streams_p, string mode_p,
+                                         double elapsed_ms_p)
+    : streams(std::move(streams_p)), mode(std::move(mode_p)), rows(stats.rows), round_trips(stats.round_trips),
+      messages_received(stats.messages_received), bytes_received(stats.bytes_received),
+      cached_messages(stats.cached_messages), skipped_filter(stats.skipped_filter), skipped_gap(stats.skipped_gap),
+      resolve_probes(stats.resolve_probes), fetch_ms(double(stats.fetch_ns) / 1e6),
+      decode_ms(double(stats.decode_ns) / 1e6), elapsed_ms(elapsed_ms_p) {
+}
+
+shared_ptr<NatsScanStatsHistory> NatsScanStatsHistory::Get(ClientContext &context) {
+    return ObjectCache::GetObjectCache(context).GetOrCreate<NatsScanStatsHistory>(NATS_SCAN_STATS_CACHE_KEY);
+}
+
+void NatsScanStatsHistory::Add(NatsScanStatsRecord record) {
+    lock_guard<mutex> guard(lock);
+    record.scan_id = next_scan_id++;
+    records.push_back(std::move(record));
+    while (records.size() > NATS_SCAN_STATS_HISTORY) {
+        records.pop_front();
+    }
+}
+
+vector<NatsScanStatsRecord> NatsScanStatsHistory::GetRecords() {
+    lock_guard<mutex> guard(lock);
+    return vector<NatsScanStatsRecord>(records.begin(), records.end());
+}
+
+// nats_scan_stats(): one row per recently finished scan, oldest first
+struct NatsScanStatsState : public GlobalTableFunctionState {
+    vector<NatsScanStatsRecord> records;
+    idx_t offset = 0;
+};
+
+static unique_ptr<FunctionData> NatsScanStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                  vector<LogicalType> &return_types, vector<string> &names) {
+    names.emplace_back("scan_id");
+    return_types.emplace_back(LogicalType(LogicalTypeId::UBIGINT));
+    names.emplace_back("streams");
+    return_types.emplace_back(LogicalType(LogicalTypeId::VARCHAR));
+    names.emplace_back("mode");
+    return_types.emplace_back(LogicalType(LogicalTypeId::VARCHAR));
+    for (auto name : {"rows", "round_trips", "messages_received", "bytes_received", "cached_messages",
+                      "skipped_filter", "skipped_gap", "resolve_probes"}) {
+        names.emplace_back(name);
+        return_types.emplace_back(LogicalType(LogicalTypeId::UBIGINT));
+    }
+    for (auto name : {"fetch_ms", "decode_ms", "elapsed_ms"}) {
+        names.emplace_back(name);
+        return_types.emplace_back(LogicalType(LogicalTypeId::DOUBLE));
+    }
+    return nullptr;
+}
+
+static unique_ptr<GlobalTableFunctionState> NatsScanStatsInit(ClientContext &context, TableFunctionInitInput &input) {
+    auto state = make_uniq<NatsScanStatsState>();
+    state->records = NatsScanStatsHistory::Get(context)->GetRecords();
+    return state;
+}
+
+static void NatsScanStatsExecute(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+    auto &state = data_p.global_state->Cast<NatsScanStatsState>();
+    idx_t count = 0;
+    while (state.offset < state.records.size() && count < STANDARD_VECTOR_SIZE) {
+        auto &record = state.records[state.offset++];
+        output.SetValue(0, count, Value::UBIGINT(record.scan_id));
+        output.SetValue(1, count, Value(record.streams));
+        output.SetValue(2, count, Value(record.mode));
+        output.SetValue(3, count, Value::UBIGINT(record.rows));
+        output.SetValue(4, count, Value::UBIGINT(record.round_trips));
+        output.SetValue(5, count, Value::UBIGINT(record.messages_received));
+        output.SetValue(6, count, Value::UBIGINT(record.bytes_received));
+        output.SetValue(7, count, Value::UBIGINT(record.cached_messages));
+        output.SetValue(8, count, Value::UBIGINT(record.skipped_filter));
+        output.SetValue(9, count, Value::UBIGINT(record.skipped_gap));
+        output.SetValue(10, count, Value::UBIGINT(record.resolve_probes));
+        output.SetValue(11, count, Value::DOUBLE(record.fetch_ms));
+        output.SetValue(12, count, Value::DOUBLE(record.decode_ms));
+        output.SetValue(13, count, Value::DOUBLE(record.elapsed_ms));
+        count++;
+    }
+    output.SetCardinality(count);
+}
+
+void NatsScanStatsFunction::Register(ExtensionLoader &loader) {
+    TableFunction nats_scan_stats("nats_scan_stats", {}, NatsScanStatsExecute, NatsScanStatsBind, NatsScanStatsInit);
+    loader.RegisterFunction(nats_scan_stats);
+}
+
+} // namespace duckdb
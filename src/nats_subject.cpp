@@ -0,0 +1,151 @@
+#include "nats_subject.hpp"
+#include "duckdb/common/string_util.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace duckdb {
+
+NatsSubjectMatcher::NatsSubjectMatcher(const vector<string> &filters) {
+    nodes.emplace_back();
+    for (auto &filter : filters) {
+        idx_t node_index = 0;
+        for (auto &token : StringUtil::Split(filter, '.')) {
+            if (token == ">") {
+                nodes[node_index].match_rest = true;
+                node_index = DConstants::INVALID_INDEX;
+                break;
+            }
+            idx_t child;
+            if (token == "*") {
+                child = nodes[node_index].wildcard;
+                if (child == DConstants::INVALID_INDEX) {
+                    child = nodes.size();
+                    nodes[node_index].wildcard = child;
+                    nodes.emplace_back();
+                }
+            } else {
+                auto &literals = nodes[node_index].literals;
+                auto entry = std::lower_bound(literals.begin(), literals.end(), token,
+                                              [](const std::pair<string, idx_t> &literal, const string &value) {
+                                                  return literal.first < value;
+                                              });
+                if (entry != literals.end() && entry->first == token) {
+                    child = entry->second;
+                } else {
+                    child = nodes.size();
+                    literals.insert(entry, std::make_pair(token, child));
+                    // Inserting may reallocate the node vector, so add the child last
+                    nodes.emplace_back();
+                }
+            }
+            node_index = child;
+        }
+        if (node_index != DConstants::INVALID_INDEX) {
+            nodes[node_index].terminal = true;
+        }
+    }
+}
+
+idx_t NatsSubjectMatcher::FindLiteral(const Node &node, const char *token, idx_t length) const {
+    // Binary search over the sorted literal tokens, comparing in place
+    idx_t lo = 0;
+    idx_t hi = node.literals.size();
+    while (lo < hi) {
+        idx_t mid = lo + (hi - lo) / 2;
+        auto &literal = node.literals[mid].first;
+        int cmp = memcmp(literal.data(), token, MinValue<idx_t>(literal.size(), length));
+        if (cmp == 0) {
+            if (literal.size() == length) {
+                return node.literals[mid].second;
+            }
+            cmp = literal.size() < length ? -1 : 1;
+        }
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return DConstants::INVALID_INDEX;
+}
+
+bool NatsSubjectMatcher::MatchFrom(idx_t node_index, const char *subject, idx_t length, idx_t pos) const {
+    auto &node = nodes[node_index];
+    if (pos > length) {
+        // Every token of the subject has been consumed
+        return node.terminal;
+    }
+    if (node.match_rest) {
+        return true;
+    }
+    auto token_end = static_cast<const char *>(memchr(subject + pos, '.', length - pos));
+    idx_t end = token_end == nullptr ? length : idx_t(token_end - subject);
+
+    // A literal and a '*' child can both match the token, so try both
+    idx_t child = FindLiteral(node, subject + pos, end - pos);
+    if (child != DConstants::INVALID_INDEX && MatchFrom(child, subject, length, end + 1)) {
+        return true;
+    }
+    return node.wildcard != DConstants::INVALID_INDEX && MatchFrom(node.wildcard, subject, length, end + 1);
+}
+
+bool NatsSubjectMatcher::Matches(const char *subject, idx_t length) const {
+    if (length == 0) {
+        return false;
+    }
+    return MatchFrom(0, subject, length, 0);
+}
+
+string NatsSubjectMatcher::CoveringFilter(const vector<string> &filters) {
+    if (filters.empty()) {
+        return string();
+    }
+    vector<vector<string>> tokens;
+    for (auto &filter : filters) {
+        tokens.push_back(StringUtil::Split(filter, '.'));
+    }
+
+    vector<string> covering;
+    for (idx_t i = 0;; i++) {
+        bool all_ended = true;
+        bool any_ended = false;
+        bool any_rest = false;
+        for (auto &filter_tokens : tokens) {
+            if (filter_tokens.size() <= i) {
+                any_ended = true;
+            } else {
+                all_ended = false;
+                any_rest = any_rest || filter_tokens[i] == ">";
+            }
+        }
+        if (all_ended) {
+            break;
+        }
+        if (any_ended) {
+            // Subjects of different lengths only share a trailing '>' after their common
+            // tokens, which must leave at least one token for '>' to match
+            covering.back() = ">";
+            break;
+        }
+        if (any_rest) {
+            covering.emplace_back(">");
+            break;
+        }
+        // Keep the token if every filter has it, and generalize it to '*' otherwise
+        string token = tokens[0][i];
+        for (auto &filter_tokens : tokens) {
+            if (filter_tokens[i] != token) {
+                token = "*";
+                break;
+            }
+        }
+        covering.push_back(token);
+    }
+
+    if (covering.size() == 1 && covering[0] == ">") {
+        return string();
+    }
+    return StringUtil::Join(covering, ".");
+}
+
+} // namespace duckdb
@@ -4,6 +4,7 @@ Generate protobuf telemetry messages and publish to NATS JetStream.
 This creates test data for the protobuf extension functionality.
 """
 
+import argparse
 import sys
 import time
 import random
@@ -13,13 +14,26 @@ from datetime import datetime, timedelta
 sys.path.insert(0, 'test/proto')
 
 import telemetry_pb2
+from google.protobuf import descriptor_pb2
 from nats.aio.client import Client as NATS
 from nats.js import JetStreamContext
 import asyncio
 
 
-async def generate_and_publish():
-    """Generate protobuf messages and publish to NATS JetStream."""
+def write_descriptor_set(path="test/proto/telemetry.desc"):
+    """Write the schema as a binary FileDescriptorSet for the proto_file tests."""
+    descriptor_set = descriptor_pb2.FileDescriptorSet()
+    telemetry_pb2.DESCRIPTOR.CopyToProto(descriptor_set.file.add())
+    with open(path, "wb") as f:
+        f.write(descriptor_set.SerializeToString())
+    print(f"Wrote descriptor set to {path}")
+
+
+async def generate_and_publish(rounds=100):
+    """Generate protobuf messages and publish to NATS JetStream.
+
+    Each round publishes one message per device.
+    """
     
     # Connect to NATS
     nc = NATS()
@@ -43,7 +57,7 @@ async def generate_and_publish():
     base_time = datetime.now() - timedelta(hours=1)
     message_count = 0
     
-    for i in range(100):
+    for i in range(rounds):
         for device in devices:
             # Create telemetry message
             msg = telemetry_pb2.Telemetry()
@@ -67,6 +81,15 @@ async def generate_and_publish():
             msg.metrics.voltage = round(480.0 + random.uniform(-5, 5), 2)
             msg.metrics.current = round(msg.metrics.kva * 1000 / (msg.metrics.voltage * 1.732), 2)
             msg.metrics.frequency = round(60.0 + random.uniform(-0.1, 0.1), 2)
+
+            # Set repeated and map fields: three samples per 10 second interval
+            for offset_ms in (2500, 5000, 7500):
+                reading = msg.readings.add()
+                reading.offset_ms = offset_ms
+                reading.kw = round(base_kw + random.uniform(-0.2, 0.2), 3)
+            msg.tags.extend(["power", device["zone"]])
+            msg.labels["building"] = device["building"]
+            msg.labels["rack"] = device["rack"]
             
             # Serialize to binary
             binary_data = msg.SerializeToString()
@@ -102,6 +125,11 @@ async def generate_and_publish():
     example.metrics.voltage = 480.5
     example.metrics.current = 7.89
     example.metrics.frequency = 60.02
+    reading = example.readings.add()
+    reading.offset_ms = 2500
+    reading.kw = 5.241
+    example.tags.extend(["power", "dc1"])
+    example.labels["building"] = "North"
     
     print(example)
     
@@ -109,5 +137,11 @@ async def generate_and_publish():
 
 
 if __name__ == "__main__":
-    asyncio.run(generate_and_publish())
+    parser = argparse.ArgumentParser(description="Generate protobuf telemetry data")
+    parser.add_argument("--rounds", type=int, default=100,
+                        help="Messages per device (default 100)")
+    args = parser.parse_args()
+
+    write_descriptor_set()
+    asyncio.run(generate_and_publish(args.rounds))
 
@@ -170,6 +170,25 @@ TEST_FILES=(
     "test/sql/test_protobuf_errors.sql"
     "test/sql/test_payload_blob.sql"
     "test/sql/test_connection_errors.sql"
+    "test/sql/test_parallel_scan.sql"
+    "test/sql/test_consumer_mode.sql"
+    "test/sql/test_projection_pushdown.sql"
+    "test/sql/test_filter_pushdown.sql"
+    "test/sql/test_connection_pool.sql"
+    "test/sql/test_sequence_gaps.sql"
+    "test/sql/test_cardinality.sql"
+    "test/sql/test_metadata.sql"
+    "test/sql/test_last_per_subject.sql"
+    "test/sql/test_multi_stream.sql"
+    "test/sql/test_follow.sql"
+    "test/sql/test_cursor.sql"
+    "test/sql/test_segment_cache.sql"
+    "test/sql/test_headers.sql"
+    "test/sql/test_json_auto.sql"
+    "test/sql/test_compression.sql"
+    "test/sql/test_publish.sql"
+    "test/sql/test_reverse_scan.sql"
+    "test/sql/test_scan_stats.sql"
 )
 
 for test_file in "${TEST_FILES[@]}"; do
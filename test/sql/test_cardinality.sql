@@ -0,0 +1,77 @@
+-- Test suite for nats_scan cardinality estimates and progress reporting
+-- Prerequisites:
+--   1. NATS server running (docker-compose up -d)
+--   2. Test data published (python3 scripts/generate-telemetry.py,
+--      python3 test/proto/generate_protobuf_data.py)
+--
+-- Run with: duckdb -unsigned :memory: < test/sql/test_cardinality.sql
+
+LOAD 'build/release/nats_js.duckdb_extension';
+
+.print ========================================
+.print Test 1: Estimate for a full scan
+.print ========================================
+
+-- Expected: the nats_scan node shows ~N rows where N is the stream's message count
+SELECT COUNT(*) as actual_rows FROM nats_scan('telemetry_proto');
+EXPLAIN SELECT * FROM nats_scan('telemetry_proto');
+
+.print
+.print ========================================
+.print Test 2: Estimate for a sequence range
+.print ========================================
+
+-- Expected: ~100 rows
+EXPLAIN SELECT * FROM nats_scan('telemetry_proto', start_seq := 1, end_seq := 100);
+
+.print
+.print ========================================
+.print Test 3: Estimate narrowed by WHERE predicates
+.print ========================================
+
+-- Expected: ~50 rows
+EXPLAIN SELECT * FROM nats_scan('telemetry_proto') WHERE seq BETWEEN 51 AND 100;
+
+.print
+.print ========================================
+.print Test 4: Estimate scaled by the subject filter
+.print ========================================
+
+-- Expected: the estimate matches the actual count for the subject
+SELECT COUNT(*) as actual_rows FROM nats_scan('telemetry', subject := 'telemetry.dc1.power.pm5560.pm5560-001');
+EXPLAIN SELECT * FROM nats_scan('telemetry', subject := 'telemetry.dc1.power.pm5560.pm5560-001');
+
+.print
+.print ========================================
+.print Test 5: Estimate for a time range
+.print ========================================
+
+-- Expected: roughly half of the stream (the data covers about two hours)
+EXPLAIN SELECT * FROM nats_scan('telemetry', start_time := (current_timestamp - INTERVAL '1 hour')::TIMESTAMP);
+
+.print
+.print ========================================
+.print Test 6: Small stream is the join build side
+.print ========================================
+
+-- Expected: the hash join builds on the 100-row scan, not on the full stream
+EXPLAIN
+SELECT COUNT(*)
+FROM nats_scan('telemetry_proto') t
+JOIN nats_scan('telemetry_proto', start_seq := 1, end_seq := 100) s ON t.seq = s.seq;
+
+.print
+.print ========================================
+.print Test 7: Scans with the progress bar enabled
+.print ========================================
+
+SET enable_progress_bar = true;
+SET enable_progress_bar_print = false;
+
+SELECT COUNT(*) as total FROM nats_scan('telemetry');
+SELECT COUNT(*) as total FROM nats_scan('telemetry', mode := 'consumer');
+
+.print
+.print ========================================
+.print All cardinality tests completed
+.print ========================================
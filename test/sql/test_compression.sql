@@ -0,0 +1,80 @@
+-- Test suite for payload decompression (compression parameter)
+-- Prerequisites:
+--   1. NATS server running (docker-compose up -d)
+--   2. Streams created (scripts/setup-streams.sh)
+--   3. Test data published (python3 scripts/generate-telemetry.py), which publishes 100
+--      JSON events to the compressed stream: zstd with a Content-Encoding header, gzip and
+--      lz4 without headers, and every fourth event uncompressed
+--
+-- Run with: duckdb -unsigned :memory: < test/sql/test_compression.sql
+
+LOAD 'build/release/nats_js.duckdb_extension';
+
+.print ========================================
+.print Test 1: Compressed payloads are read as stored by default
+.print ========================================
+
+-- Expected: 75 payloads that are not JSON text
+SELECT COUNT(*) as compressed
+FROM nats_scan('compressed')
+WHERE NOT starts_with(payload::VARCHAR, '{');
+
+.print
+.print ========================================
+.print Test 2: Auto detection from headers and magic bytes
+.print ========================================
+
+-- Expected: 25 events per codec, all decoded
+SELECT codec, COUNT(*) as events, COUNT(event) as decoded
+FROM nats_scan('compressed', compression := 'auto', json_extract := {'event': 'BIGINT', 'codec': 'VARCHAR'})
+GROUP BY codec
+ORDER BY codec;
+
+.print
+.print ========================================
+.print Test 3: Decompressed payload column
+.print ========================================
+
+SELECT subject, payload
+FROM nats_scan('compressed', compression := 'auto', json_extract := ['event'])
+ORDER BY seq
+LIMIT 4;
+
+.print
+.print ========================================
+.print Test 4: Named codec with a subject filter
+.print ========================================
+
+-- Expected: 25
+SELECT COUNT(event) as gzip_events
+FROM nats_scan('compressed', subject := 'compressed.events.gzip', compression := 'gzip',
+               json_extract := {'event': 'BIGINT'});
+
+.print
+.print ========================================
+.print Test 5: Inferred schema of compressed payloads
+.print ========================================
+
+-- Expected: event BIGINT, codec VARCHAR and text VARCHAR after the base columns
+DESCRIBE SELECT * FROM nats_scan('compressed', compression := 'auto', json_auto := true);
+
+.print
+.print ========================================
+.print Test 6: Named codec on a payload it does not match
+.print Expected: Error message
+.print ========================================
+
+SELECT payload FROM nats_scan('compressed', subject := 'compressed.events.none', compression := 'zstd') LIMIT 1;
+
+.print
+.print ========================================
+.print Test 7: Invalid compression
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('compressed', compression := 'brotli');
+
+.print
+.print ========================================
+.print All compression tests completed
+.print ========================================
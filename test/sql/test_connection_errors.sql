@@ -134,7 +134,7 @@ SELECT
     COUNT(*) as filtered_count
 FROM nats_scan('telemetry_proto',
     url := 'nats://localhost:4222',
-    subject := 'pm5560',
+    subject := 'telemetry_proto.*.power.pm5560.>',
     start_seq := 10,
     end_seq := 100,
     proto_file := 'test/proto/telemetry.proto',
@@ -0,0 +1,63 @@
+-- Test suite for the connection pool and nats_pool_stats()
+-- Prerequisites:
+--   1. NATS server running (docker-compose up -d)
+--   2. Protobuf test data published (python3 test/proto/generate_protobuf_data.py)
+--
+-- Run with: duckdb -unsigned :memory: < test/sql/test_connection_pool.sql
+
+LOAD 'build/release/nats_js.duckdb_extension';
+
+.print ========================================
+.print Test 1: Pool is empty before the first scan
+.print ========================================
+
+-- Expected: 0 rows
+SELECT COUNT(*) as pooled_urls FROM nats_pool_stats();
+
+.print
+.print ========================================
+.print Test 2: First scan dials new connections
+.print ========================================
+
+SET threads = 1;
+
+SELECT COUNT(*) as total FROM nats_scan('telemetry_proto', start_seq := 1, end_seq := 10);
+
+-- Expected: misses > 0, active = 0, idle > 0
+SELECT url, hits, misses, active, idle FROM nats_pool_stats();
+
+.print
+.print ========================================
+.print Test 3: Repeated scans reuse pooled connections
+.print ========================================
+
+SELECT COUNT(*) as total FROM nats_scan('telemetry_proto', start_seq := 1, end_seq := 10);
+SELECT COUNT(*) as total FROM nats_scan('telemetry_proto', start_seq := 11, end_seq := 20);
+
+-- Expected: hits > 0 and misses unchanged from Test 2
+SELECT url, hits, misses, active, idle FROM nats_pool_stats();
+
+.print
+.print ========================================
+.print Test 4: Consumer mode uses the pool too
+.print ========================================
+
+SELECT COUNT(*) as total FROM nats_scan('telemetry_proto', mode := 'consumer', start_seq := 1, end_seq := 10);
+
+SELECT url, hits, misses, active, idle FROM nats_pool_stats();
+
+.print
+.print ========================================
+.print Test 5: Failed connections are not pooled
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('telemetry_proto', url := 'nats://localhost:9999');
+
+-- Expected: a row for nats://localhost:9999 with misses = 1, active = 0, idle = 0
+SELECT url, hits, misses, active, idle FROM nats_pool_stats() ORDER BY url;
+
+.print
+.print ========================================
+.print All connection pool tests completed
+.print ========================================
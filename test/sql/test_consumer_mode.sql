@@ -0,0 +1,82 @@
+-- Test suite for consumer read mode in nats_scan
+-- Prerequisites:
+--   1. NATS server running (docker-compose up -d)
+--   2. Protobuf test data published (python3 test/proto/generate_protobuf_data.py)
+--
+-- Run with: duckdb -unsigned :memory: < test/sql/test_consumer_mode.sql
+
+LOAD 'build/release/nats_js.duckdb_extension';
+
+.print ========================================
+.print Test 1: Consumer mode matches direct get mode
+.print ========================================
+
+-- Expected: identical counts and sequence bounds
+SELECT 'direct' as mode, COUNT(*) as total, MIN(seq) as first_seq, MAX(seq) as last_seq
+FROM nats_scan('telemetry_proto')
+UNION ALL
+SELECT 'consumer' as mode, COUNT(*) as total, MIN(seq) as first_seq, MAX(seq) as last_seq
+FROM nats_scan('telemetry_proto', mode := 'consumer');
+
+.print
+.print ========================================
+.print Test 2: Consumer mode with small pull batches
+.print ========================================
+
+SELECT COUNT(*) as total, COUNT(DISTINCT seq) as distinct_seqs
+FROM nats_scan('telemetry_proto', mode := 'consumer', batch_size := 50);
+
+.print
+.print ========================================
+.print Test 3: Consumer mode with a byte limit per pull
+.print ========================================
+
+SELECT COUNT(*) as total
+FROM nats_scan('telemetry_proto', mode := 'consumer', max_bytes := 4096);
+
+.print
+.print ========================================
+.print Test 4: Consumer mode with a sequence range
+.print ========================================
+
+-- Expected: 11 rows, seq 10 through 20
+SELECT seq, device_id
+FROM nats_scan('telemetry_proto',
+    mode := 'consumer',
+    proto_file := 'test/proto/telemetry.proto',
+    proto_message := 'Telemetry',
+    proto_extract := ['device_id'],
+    start_seq := 10,
+    end_seq := 20
+)
+ORDER BY seq;
+
+.print
+.print ========================================
+.print Test 5: Consumer mode with no matching messages
+.print ========================================
+
+-- Expected: 0, returned at once rather than after a pull request expires
+SELECT COUNT(*) as messages
+FROM nats_scan('telemetry_proto', mode := 'consumer', subject := 'telemetry_proto.nomatch.>');
+
+.print
+.print ========================================
+.print Test 6: Invalid mode
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('telemetry_proto', mode := 'push');
+
+.print
+.print ========================================
+.print Test 7: Invalid batch_size
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('telemetry_proto', mode := 'consumer', batch_size := 0);
+
+.print
+.print ========================================
+.print All consumer mode tests completed
+.print ========================================
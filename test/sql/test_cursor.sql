@@ -0,0 +1,178 @@
+-- Test suite for durable cursors (cursor := '...')
+-- Prerequisites:
+--   1. NATS server running (docker-compose up -d)
+--   2. Streams created (scripts/setup-streams.sh)
+--   3. Test data published (python3 scripts/generate-telemetry.py)
+--
+-- Cursor positions are kept in the duckdb_nats_cursors KV bucket and survive the test run.
+-- Remove the bucket before running the tests again:
+--   nats kv del duckdb_nats_cursors -f
+--
+-- Run with: duckdb -unsigned :memory: < test/sql/test_cursor.sql
+
+LOAD 'build/release/nats_js.duckdb_extension';
+
+.print ========================================
+.print Test 1: A new cursor reads the whole stream
+.print ========================================
+
+-- Expected: true
+SELECT
+    (SELECT COUNT(*) FROM nats_scan('telemetry', cursor := 'test_cursor_full')) =
+    (SELECT COUNT(*) FROM nats_scan('telemetry')) as counts_match;
+
+.print
+.print ========================================
+.print Test 2: The next read only returns new messages
+.print ========================================
+
+-- Expected: 0 (nothing was published since Test 1)
+SELECT COUNT(*) as messages FROM nats_scan('telemetry', cursor := 'test_cursor_full');
+
+.print
+.print ========================================
+.print Test 3: A cursor resumes after an earlier bounded read
+.print ========================================
+
+-- Expected: 100
+SELECT COUNT(*) as messages FROM nats_scan('telemetry', end_seq := 100, cursor := 'test_cursor_range');
+
+-- Expected: true (the second read starts at seq 101)
+SELECT
+    (SELECT MIN(seq) FROM nats_scan('telemetry', cursor := 'test_cursor_range')) = 101 as resumed;
+
+.print
+.print ========================================
+.print Test 4: ROLLBACK leaves the cursor where it was
+.print ========================================
+
+BEGIN;
+SELECT COUNT(*) as messages FROM nats_scan('telemetry', end_seq := 100, cursor := 'test_cursor_rollback');
+ROLLBACK;
+
+-- Expected: 100 (the rolled back read is not remembered)
+SELECT COUNT(*) as messages FROM nats_scan('telemetry', end_seq := 100, cursor := 'test_cursor_rollback');
+
+.print
+.print ========================================
+.print Test 5: Scans in one transaction continue from each other
+.print ========================================
+
+BEGIN;
+-- Expected: 50
+SELECT COUNT(*) as messages FROM nats_scan('telemetry', end_seq := 50, cursor := 'test_cursor_txn');
+-- Expected: 50 (seq 51 to 100)
+SELECT COUNT(*) as messages FROM nats_scan('telemetry', end_seq := 100, cursor := 'test_cursor_txn');
+COMMIT;
+
+-- Expected: 101
+SELECT MIN(seq) as first_seq FROM nats_scan('telemetry', end_seq := 200, cursor := 'test_cursor_txn');
+
+.print
+.print ========================================
+.print Test 6: Subject filters and several streams
+.print ========================================
+
+-- Expected: true
+SELECT
+    (SELECT COUNT(*) FROM nats_scan('telemetry', subject := 'telemetry.>', cursor := 'test_cursor_subject')) =
+    (SELECT COUNT(*) FROM nats_scan('telemetry', subject := 'telemetry.>')) as counts_match;
+
+-- Expected: one row per stream with its full message count, then no rows
+SELECT stream, COUNT(*) as messages
+FROM nats_scan(['telemetry', 'environmental'], cursor := 'test_cursor_streams')
+GROUP BY stream
+ORDER BY stream;
+
+SELECT stream, COUNT(*) as messages
+FROM nats_scan(['telemetry', 'environmental'], cursor := 'test_cursor_streams')
+GROUP BY stream
+ORDER BY stream;
+
+.print
+.print ========================================
+.print Test 7: Reusing a cursor with another subject
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('telemetry', subject := 'telemetry.*.power.>', cursor := 'test_cursor_subject');
+
+.print
+.print ========================================
+.print Test 8: Invalid cursor name
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('telemetry', cursor := 'etl job');
+
+.print
+.print ========================================
+.print Test 9: cursor with mode 'last'
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('telemetry', mode := 'last', cursor := 'test_cursor_last');
+
+.print
+.print ========================================
+.print Test 10: cursor with max_rows
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('telemetry', max_rows := 10, cursor := 'test_cursor_rows');
+
+.print
+.print ========================================
+.print Test 11: cursor with LIMIT
+.print Expected: Error message (three times)
+.print ========================================
+
+SELECT seq FROM nats_scan('telemetry', cursor := 'test_cursor_limit') LIMIT 10;
+
+SELECT seq FROM nats_scan('telemetry', cursor := 'test_cursor_limit') ORDER BY seq LIMIT 10;
+
+CREATE TEMP TABLE limited_rows AS
+SELECT seq, subject FROM nats_scan('telemetry', cursor := 'test_cursor_limit') LIMIT 1000;
+
+.print
+.print ========================================
+.print Test 12: A limit over an aggregate of a cursor scan is allowed
+.print ========================================
+
+-- Expected: the full message count (the rejected queries above did not move the cursor)
+SELECT COUNT(*) as messages FROM nats_scan('telemetry', cursor := 'test_cursor_limit') LIMIT 1;
+
+-- Expected: 0
+SELECT COUNT(*) as messages FROM nats_scan('telemetry', cursor := 'test_cursor_limit');
+
+.print
+.print ========================================
+.print Test 13: A ts_nats cutoff does not skip the boundary message
+.print ========================================
+
+SET VARIABLE cutoff = (SELECT ts_nats FROM nats_scan('telemetry', start_seq := 200, end_seq := 200));
+
+-- Expected: true (the run returns every message before the cutoff)
+SELECT
+    (SELECT COUNT(*) FROM nats_scan('telemetry', cursor := 'test_cursor_cutoff')
+     WHERE ts_nats < getvariable('cutoff')) =
+    (SELECT COUNT(*) FROM nats_scan('telemetry') WHERE ts_nats < getvariable('cutoff')) as counts_match;
+
+-- Expected: true (the next run starts at the first message at or after the cutoff)
+SELECT
+    (SELECT MIN(seq) FROM nats_scan('telemetry', cursor := 'test_cursor_cutoff')) =
+    (SELECT MIN(seq) FROM nats_scan('telemetry') WHERE ts_nats >= getvariable('cutoff')) as boundary_returned;
+
+.print
+.print ========================================
+.print Test 14: Subject filters with quotes and backslashes
+.print ========================================
+
+-- Expected: 0, then 0 again (the stored position reads back)
+SELECT COUNT(*) as messages FROM nats_scan('telemetry', subject := 'telemetry."quoted\', cursor := 'test_cursor_quoted');
+SELECT COUNT(*) as messages FROM nats_scan('telemetry', subject := 'telemetry."quoted\', cursor := 'test_cursor_quoted');
+
+.print
+.print ========================================
+.print All cursor tests completed
+.print ========================================
@@ -0,0 +1,94 @@
+-- Test suite for filter pushdown of seq and ts_nats predicates in nats_scan
+-- Prerequisites:
+--   1. NATS server running (docker-compose up -d)
+--   2. Protobuf test data published (python3 test/proto/generate_protobuf_data.py)
+--
+-- Run with: duckdb -unsigned :memory: < test/sql/test_filter_pushdown.sql
+
+LOAD 'build/release/nats_js.duckdb_extension';
+
+.print ========================================
+.print Test 1: seq BETWEEN matches start_seq/end_seq
+.print ========================================
+
+-- Expected: both rows report 11 messages from seq 10 to 20
+SELECT 'where' as source, COUNT(*) as total, MIN(seq) as first_seq, MAX(seq) as last_seq
+FROM nats_scan('telemetry_proto')
+WHERE seq BETWEEN 10 AND 20
+UNION ALL
+SELECT 'params' as source, COUNT(*) as total, MIN(seq) as first_seq, MAX(seq) as last_seq
+FROM nats_scan('telemetry_proto', start_seq := 10, end_seq := 20);
+
+.print
+.print ========================================
+.print Test 2: Strict comparisons on seq
+.print ========================================
+
+-- Expected: 9 messages, seq 11 through 19
+SELECT COUNT(*) as total, MIN(seq) as first_seq, MAX(seq) as last_seq
+FROM nats_scan('telemetry_proto')
+WHERE seq > 10 AND seq < 20;
+
+.print
+.print ========================================
+.print Test 3: seq equality
+.print ========================================
+
+SELECT seq, subject
+FROM nats_scan('telemetry_proto')
+WHERE seq = 42;
+
+.print
+.print ========================================
+.print Test 4: ts_nats window relative to now()
+.print ========================================
+
+SELECT COUNT(*) as recent_count
+FROM nats_scan('telemetry_proto')
+WHERE ts_nats >= now() - INTERVAL 2 HOURS;
+
+.print
+.print ========================================
+.print Test 5: ts_nats window bounded by subqueries
+.print ========================================
+
+CREATE TEMP TABLE window_bounds AS
+SELECT MIN(ts_nats) + INTERVAL 5 MINUTES as window_start,
+       MIN(ts_nats) + INTERVAL 10 MINUTES as window_end
+FROM nats_scan('telemetry_proto', start_seq := 1, end_seq := 1);
+
+-- Expected: the WHERE variant returns exactly the rows inside the window
+SELECT COUNT(*) as where_count
+FROM nats_scan('telemetry_proto')
+WHERE ts_nats >= (SELECT window_start FROM window_bounds)
+  AND ts_nats <= (SELECT window_end FROM window_bounds);
+
+-- Expected: a window wider than the stream returns every message
+SELECT COUNT(*) as wide_window_count
+FROM nats_scan('telemetry_proto')
+WHERE ts_nats BETWEEN TIMESTAMP '2000-01-01 00:00:00' AND TIMESTAMP '2100-01-01 00:00:00';
+
+.print
+.print ========================================
+.print Test 6: Pushdown combined with named parameters
+.print ========================================
+
+-- Expected: intersection of both ranges, seq 15 through 20
+SELECT COUNT(*) as total, MIN(seq) as first_seq, MAX(seq) as last_seq
+FROM nats_scan('telemetry_proto', start_seq := 10, end_seq := 20)
+WHERE seq >= 15;
+
+.print
+.print ========================================
+.print Test 7: Predicate that cannot match
+.print ========================================
+
+-- Expected: 0
+SELECT COUNT(*) as no_match
+FROM nats_scan('telemetry_proto')
+WHERE seq > 10 AND seq < 5;
+
+.print
+.print ========================================
+.print All filter pushdown tests completed
+.print ========================================
@@ -0,0 +1,103 @@
+-- Test suite for follow mode (follow := true)
+-- Prerequisites:
+--   1. NATS server running (docker-compose up -d)
+--   2. Streams created (scripts/setup-streams.sh)
+--   3. Test data published (python3 scripts/generate-telemetry.py)
+--
+-- No messages are published while these tests run, so every follow scan ends at its
+-- idle timeout or row limit after returning the stored messages.
+--
+-- Run with: duckdb -unsigned :memory: < test/sql/test_follow.sql
+
+LOAD 'build/release/nats_js.duckdb_extension';
+
+.print ========================================
+.print Test 1: Follow returns the stored messages, then ends when idle
+.print ========================================
+
+-- Expected: true
+SELECT
+    (SELECT COUNT(*) FROM nats_scan('telemetry', follow := true, idle_timeout := INTERVAL 1 SECOND)) =
+    (SELECT COUNT(*) FROM nats_scan('telemetry')) as counts_match;
+
+.print
+.print ========================================
+.print Test 2: max_rows ends the scan
+.print ========================================
+
+-- Expected: 100
+SELECT COUNT(*) as messages FROM nats_scan('telemetry', follow := true, max_rows := 100);
+
+-- Expected: 10 (max_rows also applies without follow)
+SELECT COUNT(*) as messages FROM nats_scan('telemetry', max_rows := 10);
+
+.print
+.print ========================================
+.print Test 3: Follow after the last message waits for new ones only
+.print ========================================
+
+-- Expected: 0
+SELECT COUNT(*) as messages
+FROM nats_scan('telemetry',
+    start_seq := 1000000000,
+    follow := true,
+    idle_timeout := INTERVAL 500 MILLISECONDS);
+
+.print
+.print ========================================
+.print Test 4: Subject filters and consumer mode
+.print ========================================
+
+-- Expected: true
+SELECT
+    (SELECT COUNT(*) FROM nats_scan('telemetry', subject := 'telemetry.dc1.power.pm5560.pm5560-001',
+                                    mode := 'consumer', follow := true, idle_timeout := INTERVAL 1 SECOND)) =
+    (SELECT COUNT(*) FROM nats_scan('telemetry', subject := 'telemetry.dc1.power.pm5560.pm5560-001'))
+    as counts_match;
+
+.print
+.print ========================================
+.print Test 5: Upper bounds in WHERE stay filters
+.print ========================================
+
+-- Expected: 10
+SELECT COUNT(*) as messages
+FROM nats_scan('telemetry', follow := true, idle_timeout := INTERVAL 1 SECOND)
+WHERE seq <= 10;
+
+.print
+.print ========================================
+.print Test 6: follow with end_seq
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('telemetry', follow := true, end_seq := 100);
+
+.print
+.print ========================================
+.print Test 7: follow with mode 'last'
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('telemetry', follow := true, mode := 'last');
+
+.print
+.print ========================================
+.print Test 8: follow with several streams
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan(['telemetry', 'environmental'], follow := true);
+
+.print
+.print ========================================
+.print Test 9: idle_timeout without follow
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('telemetry', idle_timeout := INTERVAL 1 SECOND);
+
+.print
+.print ========================================
+.print All follow tests completed
+.print ========================================
@@ -0,0 +1,103 @@
+-- Test suite for message headers (headers column and header_extract)
+-- Prerequisites:
+--   1. NATS server running (docker-compose up -d)
+--   2. Streams created (scripts/setup-streams.sh)
+--   3. Test data published (python3 scripts/generate-telemetry.py), which publishes 100
+--      events with Trace-Id, Routing-Key and Nats-Msg-Id headers to the events stream
+--
+-- Run with: duckdb -unsigned :memory: < test/sql/test_headers.sql
+
+LOAD 'build/release/nats_js.duckdb_extension';
+
+.print ========================================
+.print Test 1: headers column
+.print ========================================
+
+-- Expected: 3 headers per message, without the Nats-* headers of direct get responses
+SELECT seq, subject, cardinality(headers) as header_count, headers
+FROM nats_scan('events')
+ORDER BY seq
+LIMIT 3;
+
+-- Expected: 0
+SELECT COUNT(*) as server_headers
+FROM nats_scan('events')
+WHERE map_contains(headers, 'Nats-Stream') OR map_contains(headers, 'Nats-Sequence');
+
+.print
+.print ========================================
+.print Test 2: header_extract columns
+.print ========================================
+
+-- Expected: trace-0000/audit.eu, trace-0001/audit.us, trace-0002/audit.eu
+SELECT seq, Trace_Id, Routing_Key
+FROM nats_scan('events', header_extract := ['Trace-Id', 'Routing-Key'])
+ORDER BY seq
+LIMIT 3;
+
+-- Expected: 100 distinct message IDs
+SELECT COUNT(DISTINCT Nats_Msg_Id) as message_ids
+FROM nats_scan('events', header_extract := ['Nats-Msg-Id']);
+
+.print
+.print ========================================
+.print Test 3: Messages without headers
+.print ========================================
+
+-- Expected: all trace IDs NULL and all header maps empty
+SELECT
+    COUNT(*) as messages,
+    COUNT(Trace_Id) as trace_ids,
+    COUNT(*) FILTER (WHERE cardinality(headers) = 0) as empty_headers
+FROM nats_scan('telemetry', header_extract := ['Trace-Id']);
+
+.print
+.print ========================================
+.print Test 4: Filters on header columns
+.print ========================================
+
+-- Expected: 50
+SELECT COUNT(*) as messages
+FROM nats_scan('events', header_extract := ['Routing-Key'])
+WHERE Routing_Key = 'audit.eu';
+
+-- Expected: 100
+SELECT COUNT(*) as messages
+FROM nats_scan('events', header_extract := ['Routing-Key'])
+WHERE Routing_Key IN ('audit.eu', 'audit.us');
+
+-- Expected: 0 (no telemetry message has the header)
+SELECT COUNT(*) as messages
+FROM nats_scan('telemetry', header_extract := ['Trace-Id'])
+WHERE Trace_Id IS NOT NULL;
+
+-- Expected: 1 event, region eu
+SELECT event, region
+FROM nats_scan('events', header_extract := ['Trace-Id'], json_extract := {'event': 'BIGINT', 'region': 'VARCHAR'})
+WHERE Trace_Id = 'trace-0042';
+
+.print
+.print ========================================
+.print Test 5: Headers in consumer mode
+.print ========================================
+
+-- Expected: true
+SELECT
+    (SELECT COUNT(*) FROM nats_scan('events', mode := 'consumer', header_extract := ['Routing-Key'])
+     WHERE Routing_Key = 'audit.us') = 50 as counts_match;
+
+-- Expected: 3
+SELECT MAX(cardinality(headers)) as header_count FROM nats_scan('events', mode := 'consumer');
+
+.print
+.print ========================================
+.print Test 6: Empty header name
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('events', header_extract := ['']);
+
+.print
+.print ========================================
+.print All header tests completed
+.print ========================================
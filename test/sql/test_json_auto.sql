@@ -0,0 +1,123 @@
+-- Test suite for JSON schema inference (json_auto)
+-- Prerequisites:
+--   1. NATS server running (docker-compose up -d)
+--   2. Streams created (scripts/setup-streams.sh), including the published stream
+--   3. JSON test data published (python3 scripts/generate-telemetry.py --hours 2)
+--
+-- Run with: duckdb -unsigned :memory: < test/sql/test_json_auto.sql
+
+LOAD 'build/release/nats_js.duckdb_extension';
+
+.print ========================================
+.print Test 1: Inferred columns and types
+.print ========================================
+
+-- Expected: device_id VARCHAR, zone VARCHAR, timestamp TIMESTAMP, kw..frequency DOUBLE,
+-- meter STRUCT(serial BIGINT, capacity_kw BIGINT), after the six base columns
+DESCRIBE SELECT * FROM nats_scan('telemetry', json_auto := true);
+
+.print
+.print ========================================
+.print Test 2: Typed values without casts
+.print ========================================
+
+SELECT
+    device_id,
+    kw,
+    timestamp,
+    typeof(kw) as kw_type,
+    typeof(timestamp) as ts_type
+FROM nats_scan('telemetry', json_auto := true)
+WHERE kw > 50.0
+LIMIT 5;
+
+.print
+.print ========================================
+.print Test 3: Nested objects as STRUCT
+.print ========================================
+
+-- Expected: serials above 2^53 (9007199254740993 ... 9007199254740997), exact
+SELECT DISTINCT
+    meter.serial as serial,
+    meter.capacity_kw as capacity_kw
+FROM nats_scan('telemetry', json_auto := true)
+ORDER BY serial;
+
+.print
+.print ========================================
+.print Test 4: Same rows as json_extract
+.print ========================================
+
+-- Expected: 0
+SELECT COUNT(*) as mismatches
+FROM nats_scan('telemetry', json_auto := true) a
+JOIN nats_scan('telemetry', json_extract := {'kw': 'DOUBLE', 'zone': 'VARCHAR'}) b USING (seq)
+WHERE a.kw IS DISTINCT FROM b.kw OR a.zone IS DISTINCT FROM b.zone;
+
+.print
+.print ========================================
+.print Test 5: Schema follows the subject filter and range
+.print ========================================
+
+-- Expected: environmental readings columns (location, temp_c, temp_f, humidity), no kw
+DESCRIBE SELECT * FROM nats_scan('environmental', json_auto := true, sample_size := 10);
+
+SELECT location, temp_c, typeof(humidity) as humidity_type
+FROM nats_scan('environmental', json_auto := true, start_seq := 100, end_seq := 105);
+
+.print
+.print ========================================
+.print Test 6: Combined with header_extract
+.print ========================================
+
+-- Expected: event BIGINT and region VARCHAR, followed by the Trace_Id column
+SELECT event, region, Trace_Id
+FROM nats_scan('events', json_auto := true, header_extract := ['Trace-Id'])
+ORDER BY event
+LIMIT 3;
+
+.print
+.print ========================================
+.print Test 7: Keys that differ only in case
+.print ========================================
+
+SET VARIABLE before = (SELECT last_seq FROM nats_stream_info('published'));
+
+COPY (
+    SELECT 'published.json_auto_case' as subject,
+           CASE WHEN i % 2 = 0
+                THEN '{"Temp": ' || i || ', "meta": {"Unit": "C"}}'
+                ELSE '{"temp": ' || i || ', "meta": {"unit": "C"}}' END as payload
+    FROM range(10) t(i)
+) TO 'nats://localhost:4222' (FORMAT nats, STREAM 'published');
+
+-- Expected: one Temp column (the first spelling seen) and meta STRUCT(Unit VARCHAR)
+DESCRIBE SELECT * EXCLUDE (stream, subject, seq, ts_nats, payload, headers)
+FROM nats_scan('published', subject := 'published.json_auto_case', json_auto := true,
+    start_seq := getvariable('before') + 1);
+
+-- Expected: 10 rows, 0 NULL temperatures and units (both spellings decode)
+SELECT COUNT(*) as messages, COUNT(*) - COUNT(Temp) as null_temps, COUNT(*) - COUNT(meta.Unit) as null_units
+FROM nats_scan('published', subject := 'published.json_auto_case', json_auto := true,
+    start_seq := getvariable('before') + 1);
+
+.print
+.print ========================================
+.print Test 8: json_auto with json_extract
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('telemetry', json_auto := true, json_extract := ['kw']);
+
+.print
+.print ========================================
+.print Test 9: sample_size without json_auto
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('telemetry', sample_size := 10);
+
+.print
+.print ========================================
+.print All json_auto tests completed
+.print ========================================
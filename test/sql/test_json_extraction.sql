@@ -300,6 +300,115 @@ WHERE zone IN ('zone-a', 'zone-b')
   AND voltage::DOUBLE BETWEEN 475 AND 485
 LIMIT 20;
 
+.print
+.print ========================================
+.print Test 19: Typed extraction with native numeric columns
+.print ========================================
+
+SELECT
+    device_id,
+    kw,
+    voltage,
+    typeof(kw) as kw_type,
+    typeof(voltage) as voltage_type
+FROM nats_scan('telemetry',
+    json_extract := {'device_id': 'VARCHAR', 'kw': 'DOUBLE', 'voltage': 'DOUBLE'}
+)
+WHERE kw > 50.0
+LIMIT 5;
+
+.print
+.print ========================================
+.print Test 20: Nested dotted paths
+.print ========================================
+
+-- Expected: columns meter_serial (UBIGINT) and meter_capacity_kw (INTEGER)
+SELECT
+    device_id,
+    meter_serial,
+    meter_capacity_kw,
+    typeof(meter_serial) as serial_type
+FROM nats_scan('telemetry',
+    json_extract := {'device_id': 'VARCHAR', 'meter.serial': 'UBIGINT', 'meter.capacity_kw': 'INTEGER'}
+)
+LIMIT 5;
+
+.print
+.print ========================================
+.print Test 21: int64 values keep full precision
+.print ========================================
+
+-- Expected: serials above 2^53 (9007199254740993 ... 9007199254740997), exact in both forms
+SELECT DISTINCT
+    meter_serial as serial_typed
+FROM nats_scan('telemetry',
+    json_extract := {'meter.serial': 'BIGINT'}
+)
+ORDER BY serial_typed;
+
+SELECT DISTINCT
+    meter_serial as serial_text
+FROM nats_scan('telemetry',
+    json_extract := ['meter.serial']
+)
+ORDER BY serial_text;
+
+.print
+.print ========================================
+.print Test 22: JSON pointer paths
+.print ========================================
+
+SELECT
+    meter_serial,
+    meter_capacity_kw
+FROM nats_scan('telemetry',
+    json_extract := MAP {'/meter/serial': 'UBIGINT', '/meter/capacity_kw': 'DOUBLE'}
+)
+LIMIT 5;
+
+.print
+.print ========================================
+.print Test 23: Nested object returned as JSON text
+.print ========================================
+
+SELECT
+    meter
+FROM nats_scan('telemetry',
+    json_extract := ['meter']
+)
+LIMIT 3;
+
+.print
+.print ========================================
+.print Test 24: Typed timestamps and string-to-number conversion
+.print ========================================
+
+-- Expected: timestamp parsed from the ISO 8601 string; device_id does not convert to a number (NULL)
+SELECT
+    timestamp,
+    typeof(timestamp) as ts_type,
+    device_id
+FROM nats_scan('telemetry',
+    json_extract := {'timestamp': 'TIMESTAMP', 'device_id': 'BIGINT'}
+)
+LIMIT 3;
+
+.print
+.print ========================================
+.print Test 25: Unsupported json_extract type
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('telemetry', json_extract := {'kw': 'BLOB'});
+
+.print
+.print ========================================
+.print Test 26: Empty path segment
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('telemetry', json_extract := ['meter..serial']);
+
 .print
 .print ========================================
 .print All JSON extraction tests completed successfully!
@@ -0,0 +1,103 @@
+-- Test suite for last-per-subject scans (mode := 'last')
+-- Prerequisites:
+--   1. NATS server running (docker-compose up -d)
+--   2. Streams created (scripts/setup-streams.sh)
+--   3. Test data published (python3 scripts/generate-telemetry.py)
+--
+-- Run with: duckdb -unsigned :memory: < test/sql/test_last_per_subject.sql
+
+LOAD 'build/release/nats_js.duckdb_extension';
+
+.print ========================================
+.print Test 1: One row per subject
+.print ========================================
+
+-- Expected: rows = subjects = number of subjects in the stream
+SELECT
+    COUNT(*) as rows,
+    COUNT(DISTINCT subject) as subjects,
+    (SELECT COUNT(*) FROM nats_subject_counts('telemetry')) as stream_subjects
+FROM nats_scan('telemetry', mode := 'last');
+
+.print
+.print ========================================
+.print Test 2: Same rows as arg_max over the full history
+.print ========================================
+
+-- Expected: 0 mismatches
+SELECT COUNT(*) as mismatches
+FROM (
+    (SELECT subject, seq FROM nats_scan('telemetry', mode := 'last')
+     EXCEPT
+     SELECT subject, MAX(seq) FROM nats_scan('telemetry') GROUP BY subject)
+    UNION ALL
+    (SELECT subject, MAX(seq) FROM nats_scan('telemetry') GROUP BY subject
+     EXCEPT
+     SELECT subject, seq FROM nats_scan('telemetry', mode := 'last'))
+);
+
+.print
+.print ========================================
+.print Test 3: Subject filter
+.print ========================================
+
+-- Expected: 5 power meters
+SELECT subject, seq
+FROM nats_scan('telemetry', mode := 'last', subject := 'telemetry.dc1.power.>')
+ORDER BY subject;
+
+.print
+.print ========================================
+.print Test 4: Latest reading per device with JSON extraction
+.print ========================================
+
+SELECT device_id, zone, kw
+FROM nats_scan('telemetry', mode := 'last', subject := 'telemetry.dc1.power.>',
+    json_extract := ['device_id', 'zone', 'kw'])
+ORDER BY device_id;
+
+.print
+.print ========================================
+.print Test 5: Snapshot as of end_seq
+.print ========================================
+
+-- Expected: 0 mismatches
+SELECT COUNT(*) as mismatches
+FROM (
+    (SELECT subject, seq FROM nats_scan('telemetry', mode := 'last', end_seq := 100)
+     EXCEPT
+     SELECT subject, MAX(seq) FROM nats_scan('telemetry', end_seq := 100) GROUP BY subject)
+    UNION ALL
+    (SELECT subject, MAX(seq) FROM nats_scan('telemetry', end_seq := 100) GROUP BY subject
+     EXCEPT
+     SELECT subject, seq FROM nats_scan('telemetry', mode := 'last', end_seq := 100))
+);
+
+.print
+.print ========================================
+.print Test 6: WHERE seq filters the latest messages
+.print ========================================
+
+-- Expected: 0 rows (every subject's latest message is past seq 100)
+SELECT COUNT(*) as rows FROM nats_scan('telemetry', mode := 'last') WHERE seq <= 100;
+
+.print
+.print ========================================
+.print Test 7: start_seq drops subjects that went quiet
+.print ========================================
+
+-- Expected: 15 rows (5 sparse devices only reported at the start of the stream)
+SELECT COUNT(*) as rows FROM nats_scan('sparse', mode := 'last', start_seq := 18);
+
+.print
+.print ========================================
+.print Test 8: Invalid mode
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('telemetry', mode := 'latest');
+
+.print
+.print ========================================
+.print All last-per-subject tests completed
+.print ========================================
@@ -0,0 +1,91 @@
+-- Test suite for nats_stream_info() and nats_subject_counts()
+-- Prerequisites:
+--   1. NATS server running (docker-compose up -d)
+--   2. Streams created (scripts/setup-streams.sh)
+--   3. Test data published (python3 scripts/generate-telemetry.py)
+--
+-- Run with: duckdb -unsigned :memory: < test/sql/test_metadata.sql
+
+LOAD 'build/release/nats_js.duckdb_extension';
+
+.print ========================================
+.print Test 1: Stream state
+.print ========================================
+
+SELECT stream, messages, bytes > 0 as has_bytes, first_seq, last_seq, first_ts <= last_ts as ordered, num_subjects
+FROM nats_stream_info('telemetry');
+
+.print
+.print ========================================
+.print Test 2: Stream state matches a full scan
+.print ========================================
+
+-- Expected: true, true, true
+SELECT
+    i.messages = s.total as count_matches,
+    i.first_seq = s.first_seq as first_matches,
+    i.last_seq = s.last_seq as last_matches
+FROM nats_stream_info('telemetry') i,
+     (SELECT COUNT(*) as total, MIN(seq) as first_seq, MAX(seq) as last_seq FROM nats_scan('telemetry')) s;
+
+.print
+.print ========================================
+.print Test 3: Deleted sequences are reported
+.print ========================================
+
+-- Expected: 20 messages, 135 deleted, seq 1 to 155
+SELECT messages, num_deleted, first_seq, last_seq FROM nats_stream_info('sparse');
+
+.print
+.print ========================================
+.print Test 4: Counts for every subject
+.print ========================================
+
+SELECT subject, messages FROM nats_subject_counts('telemetry');
+
+.print
+.print ========================================
+.print Test 5: Counts for a wildcard filter
+.print ========================================
+
+SELECT subject, messages FROM nats_subject_counts('telemetry', 'telemetry.dc1.power.*.*');
+
+.print
+.print ========================================
+.print Test 6: Subject counts match a filtered scan
+.print ========================================
+
+-- Expected: true
+SELECT
+    (SELECT SUM(messages) FROM nats_subject_counts('environmental', 'environmental.dc1.sensors.temp.>'))
+    =
+    (SELECT COUNT(*) FROM nats_scan('environmental', subject := 'environmental.dc1.sensors.temp.>')) as counts_match;
+
+.print
+.print ========================================
+.print Test 7: Filter matching no subjects
+.print ========================================
+
+-- Expected: 0 rows
+SELECT COUNT(*) as subjects FROM nats_subject_counts('telemetry', 'telemetry.nonexistent.>');
+
+.print
+.print ========================================
+.print Test 8: Invalid subject filter
+.print Expected: Error message
+.print ========================================
+
+SELECT * FROM nats_subject_counts('telemetry', 'telemetry..power');
+
+.print
+.print ========================================
+.print Test 9: Nonexistent stream
+.print Expected: Error message
+.print ========================================
+
+SELECT * FROM nats_stream_info('no_such_stream');
+
+.print
+.print ========================================
+.print All metadata tests completed
+.print ========================================
@@ -0,0 +1,124 @@
+-- Test suite for scanning several streams in one nats_scan
+-- Prerequisites:
+--   1. NATS server running (docker-compose up -d)
+--   2. Streams created (scripts/setup-streams.sh)
+--   3. Test data published (python3 scripts/generate-telemetry.py)
+--
+-- Run with: duckdb -unsigned :memory: < test/sql/test_multi_stream.sql
+
+LOAD 'build/release/nats_js.duckdb_extension';
+
+.print ========================================
+.print Test 1: List of streams
+.print ========================================
+
+-- Expected: one row per stream, with the counts of the individual scans
+SELECT stream, COUNT(*) as messages
+FROM nats_scan(['telemetry', 'environmental'])
+GROUP BY stream
+ORDER BY stream;
+
+.print
+.print ========================================
+.print Test 2: List scan matches the individual scans
+.print ========================================
+
+-- Expected: true
+SELECT
+    (SELECT COUNT(*) FROM nats_scan(['telemetry', 'environmental'])) =
+    (SELECT COUNT(*) FROM nats_scan('telemetry')) + (SELECT COUNT(*) FROM nats_scan('environmental')) as counts_match;
+
+.print
+.print ========================================
+.print Test 3: Glob resolved from the stream list
+.print ========================================
+
+-- Expected: telemetry and telemetry_proto
+SELECT DISTINCT stream FROM nats_scan('telemetry*') ORDER BY stream;
+
+.print
+.print ========================================
+.print Test 4: Globs and names mixed, duplicates scanned once
+.print ========================================
+
+-- Expected: environmental, telemetry, telemetry_proto
+SELECT stream, COUNT(*) as messages
+FROM nats_scan(['telemetry*', 'environmental', 'telemetry'])
+GROUP BY stream
+ORDER BY stream;
+
+.print
+.print ========================================
+.print Test 5: Rows keep stream and sequence order
+.print ========================================
+
+-- Expected: 0 rows out of order
+SELECT COUNT(*) as out_of_order
+FROM (
+    SELECT stream, seq, LAG(stream) OVER () as prev_stream, LAG(seq) OVER () as prev_seq
+    FROM nats_scan(['telemetry', 'environmental'])
+)
+WHERE stream = prev_stream AND seq <= prev_seq;
+
+.print
+.print ========================================
+.print Test 6: Sequence bounds apply to each stream
+.print ========================================
+
+-- Expected: 10 rows per stream, seq 1 to 10
+SELECT stream, COUNT(*) as messages, MIN(seq) as first_seq, MAX(seq) as last_seq
+FROM nats_scan(['telemetry', 'environmental'], end_seq := 10)
+GROUP BY stream
+ORDER BY stream;
+
+.print
+.print ========================================
+.print Test 7: Parallel scan across streams
+.print ========================================
+
+SET threads = 4;
+
+-- Expected: true
+SELECT
+    (SELECT COUNT(*) FROM nats_scan(['telemetry', 'environmental'])) =
+    (SELECT COUNT(*) FROM nats_scan('telemetry')) + (SELECT COUNT(*) FROM nats_scan('environmental')) as counts_match;
+
+SET threads = 1;
+
+.print
+.print ========================================
+.print Test 8: Consumer and last mode across streams
+.print ========================================
+
+-- Expected: the counts of test 1
+SELECT stream, COUNT(*) as messages
+FROM nats_scan(['telemetry', 'environmental'], mode := 'consumer')
+GROUP BY stream
+ORDER BY stream;
+
+-- Expected: one row per subject of each stream
+SELECT stream, COUNT(*) as subjects
+FROM nats_scan(['telemetry', 'environmental'], mode := 'last')
+GROUP BY stream
+ORDER BY stream;
+
+.print
+.print ========================================
+.print Test 9: Glob without matches
+.print ========================================
+.print Expected: Error message
+
+SELECT COUNT(*) FROM nats_scan('no_such_stream_*');
+
+.print
+.print ========================================
+.print Test 10: Empty stream list
+.print ========================================
+.print Expected: Error message
+
+SELECT COUNT(*) FROM nats_scan([]::VARCHAR[]);
+
+.print
+.print ========================================
+.print All multi-stream tests completed
+.print ========================================
@@ -0,0 +1,130 @@
+-- Test suite for parallel scanning in nats_scan
+-- Prerequisites:
+--   1. NATS server running (docker-compose up -d)
+--   2. Protobuf test data published (python3 test/proto/generate_protobuf_data.py)
+--
+-- Run with: duckdb -unsigned :memory: < test/sql/test_parallel_scan.sql
+
+LOAD 'build/release/nats_js.duckdb_extension';
+
+.print ========================================
+.print Test 1: Single-threaded baseline
+.print ========================================
+
+SET threads = 1;
+
+CREATE TEMP TABLE single_threaded AS
+SELECT seq, subject, device_id
+FROM nats_scan('telemetry_proto',
+    proto_file := 'test/proto/telemetry.proto',
+    proto_message := 'Telemetry',
+    proto_extract := ['device_id']
+);
+
+SELECT COUNT(*) as total, MIN(seq) as first_seq, MAX(seq) as last_seq
+FROM single_threaded;
+
+.print
+.print ========================================
+.print Test 2: Multi-threaded scan returns the same rows
+.print ========================================
+
+SET threads = 8;
+
+CREATE TEMP TABLE multi_threaded AS
+SELECT seq, subject, device_id
+FROM nats_scan('telemetry_proto',
+    proto_file := 'test/proto/telemetry.proto',
+    proto_message := 'Telemetry',
+    proto_extract := ['device_id']
+);
+
+-- Expected: 0 rows in both directions
+SELECT COUNT(*) as missing_rows FROM (
+    SELECT * FROM single_threaded EXCEPT ALL SELECT * FROM multi_threaded
+);
+SELECT COUNT(*) as extra_rows FROM (
+    SELECT * FROM multi_threaded EXCEPT ALL SELECT * FROM single_threaded
+);
+
+.print
+.print ========================================
+.print Test 3: Insertion order is preserved across morsels
+.print ========================================
+
+-- Expected: 0 (every row has a larger seq than the row before it)
+SELECT COUNT(*) as out_of_order
+FROM (
+    SELECT seq, LAG(seq) OVER () as prev_seq
+    FROM nats_scan('telemetry_proto', start_seq := 1, end_seq := 5000)
+)
+WHERE prev_seq IS NOT NULL AND seq <= prev_seq;
+
+.print
+.print ========================================
+.print Test 4: Range smaller than one morsel
+.print ========================================
+
+SELECT COUNT(*) as small_range_count
+FROM nats_scan('telemetry_proto', start_seq := 10, end_seq := 19);
+
+.print
+.print ========================================
+.print Test 5: Range ending exactly on a morsel boundary
+.print ========================================
+
+SELECT COUNT(*) as boundary_count, MIN(seq) as first_seq, MAX(seq) as last_seq
+FROM nats_scan('telemetry_proto', start_seq := 1, end_seq := 2048);
+
+.print
+.print ========================================
+.print Test 6: Prefetching disabled returns the same rows
+.print ========================================
+
+SELECT COUNT(*) as mismatches
+FROM (
+    (SELECT seq, subject FROM nats_scan('telemetry')
+     EXCEPT
+     SELECT seq, subject FROM nats_scan('telemetry', prefetch_bytes := 0))
+    UNION ALL
+    (SELECT seq, subject FROM nats_scan('telemetry', prefetch_bytes := 0)
+     EXCEPT
+     SELECT seq, subject FROM nats_scan('telemetry'))
+);
+
+.print
+.print ========================================
+.print Test 7: Tiny prefetch limit keeps order and completeness
+.print ========================================
+
+-- A 1-byte limit allows only one queued batch at a time
+SELECT COUNT(*) as total, COUNT(DISTINCT seq) as distinct_seqs
+FROM nats_scan('telemetry', prefetch_bytes := 1);
+
+SELECT COUNT(*) as out_of_order
+FROM (
+    SELECT seq, LAG(seq) OVER () as prev_seq
+    FROM nats_scan('telemetry', prefetch_bytes := 1)
+)
+WHERE prev_seq IS NOT NULL AND seq <= prev_seq;
+
+.print
+.print ========================================
+.print Test 8: Early termination with LIMIT
+.print ========================================
+
+SELECT COUNT(*) as limited_count
+FROM (SELECT seq FROM nats_scan('telemetry') LIMIT 10);
+
+.print
+.print ========================================
+.print Test 9: Invalid prefetch_bytes
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('telemetry', prefetch_bytes := -1);
+
+.print
+.print ========================================
+.print All parallel scan tests completed
+.print ========================================
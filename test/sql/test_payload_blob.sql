@@ -56,6 +56,36 @@ SELECT
 FROM nats_scan('telemetry')
 WHERE seq = 1;
 
+.print
+.print ========================================
+.print Test 5: Payloads outlive the scan that produced them
+.print ========================================
+
+-- Payload columns reference the fetched messages; materializing and sorting them
+-- must keep every byte intact
+CREATE TABLE payload_copy AS
+SELECT seq, payload FROM nats_scan('telemetry') ORDER BY octet_length(payload) DESC, seq;
+
+-- Expected: 0 mismatches
+SELECT COUNT(*) as mismatches
+FROM payload_copy c
+JOIN nats_scan('telemetry', prefetch_bytes := 0) s USING (seq)
+WHERE md5(c.payload) <> md5(s.payload);
+
+DROP TABLE payload_copy;
+
+.print
+.print ========================================
+.print Test 6: Short and long payloads in the same chunk
+.print ========================================
+
+-- Payloads of 12 bytes or less are stored inline, longer ones reference the message
+SELECT
+    COUNT(*) FILTER (WHERE octet_length(payload) <= 12) as inline_payloads,
+    COUNT(*) FILTER (WHERE octet_length(payload) > 12) as referenced_payloads,
+    SUM(octet_length(payload)) as total_bytes
+FROM nats_scan('events');
+
 .print
 .print ========================================
 .print All payload BLOB tests completed!
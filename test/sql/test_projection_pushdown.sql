@@ -0,0 +1,70 @@
+-- Test suite for projection pushdown in nats_scan
+-- Prerequisites:
+--   1. NATS server running (docker-compose up -d)
+--   2. Protobuf test data published (python3 test/proto/generate_protobuf_data.py)
+--
+-- Run with: duckdb -unsigned :memory: < test/sql/test_projection_pushdown.sql
+
+LOAD 'build/release/nats_js.duckdb_extension';
+
+.print ========================================
+.print Test 1: COUNT(*) without selecting any column
+.print ========================================
+
+SELECT COUNT(*) as total
+FROM nats_scan('telemetry_proto',
+    proto_file := 'test/proto/telemetry.proto',
+    proto_message := 'Telemetry',
+    proto_extract := ['device_id', 'metrics.kw']
+);
+
+.print
+.print ========================================
+.print Test 2: Metadata-only columns
+.print ========================================
+
+SELECT seq, ts_nats
+FROM nats_scan('telemetry_proto', start_seq := 1, end_seq := 5)
+ORDER BY seq;
+
+.print
+.print ========================================
+.print Test 3: Subset of extracted fields in a different order
+.print ========================================
+
+SELECT metrics_kw, seq, device_id
+FROM nats_scan('telemetry_proto',
+    proto_file := 'test/proto/telemetry.proto',
+    proto_message := 'Telemetry',
+    proto_extract := ['device_id', 'location.zone', 'metrics.kw'],
+    start_seq := 1,
+    end_seq := 5
+)
+ORDER BY seq;
+
+.print
+.print ========================================
+.print Test 4: Filter on a field that is not selected
+.print ========================================
+
+SELECT COUNT(*) as dc1_count
+FROM nats_scan('telemetry_proto',
+    proto_file := 'test/proto/telemetry.proto',
+    proto_message := 'Telemetry',
+    proto_extract := ['device_id', 'location.zone']
+)
+WHERE location_zone = 'dc1';
+
+.print
+.print ========================================
+.print Test 5: Payload only when selected
+.print ========================================
+
+SELECT seq, octet_length(payload) as payload_size
+FROM nats_scan('telemetry_proto', start_seq := 1, end_seq := 5)
+ORDER BY seq;
+
+.print
+.print ========================================
+.print All projection pushdown tests completed
+.print ========================================
@@ -266,6 +266,130 @@ FROM nats_scan('telemetry_proto',
 GROUP BY location_zone
 ORDER BY location_zone;
 
+.print
+.print ========================================
+.print Test 15: Precompiled FileDescriptorSet schema
+.print ========================================
+
+-- telemetry.desc is written by generate_protobuf_data.py; results match the .proto schema
+SELECT
+    location_zone,
+    COUNT(*) as message_count,
+    ROUND(AVG(metrics_kw), 2) as avg_kw
+FROM nats_scan('telemetry_proto',
+    proto_file := 'test/proto/telemetry.desc',
+    proto_message := 'Telemetry',
+    proto_extract := ['location.zone', 'metrics.kw']
+)
+GROUP BY location_zone
+ORDER BY location_zone;
+
+.print
+.print ========================================
+.print Test 16: Fully qualified message type name
+.print ========================================
+
+SELECT
+    device_id,
+    location_zone
+FROM nats_scan('telemetry_proto',
+    proto_file := 'test/proto/telemetry.proto',
+    proto_message := 'telemetry.Telemetry',
+    proto_extract := ['device_id', 'location.zone']
+)
+LIMIT 5;
+
+.print
+.print ========================================
+.print Test 17: Repeated binds reuse the cached schema
+.print ========================================
+
+SELECT COUNT(*) as first_bind
+FROM nats_scan('telemetry_proto',
+    proto_file := 'test/proto/telemetry.proto',
+    proto_message := 'Telemetry',
+    proto_extract := ['device_id']
+);
+
+SELECT COUNT(*) as second_bind
+FROM nats_scan('telemetry_proto',
+    proto_file := 'test/proto/telemetry.proto',
+    proto_message := 'Telemetry',
+    proto_extract := ['device_id']
+);
+
+.print
+.print ========================================
+.print Test 18: Repeated message field as a LIST of STRUCT
+.print ========================================
+
+SELECT
+    device_id,
+    len(readings) as reading_count,
+    readings[1].offset_ms as first_offset_ms,
+    typeof(readings) as readings_type
+FROM nats_scan('telemetry_proto',
+    proto_file := 'test/proto/telemetry.proto',
+    proto_message := 'Telemetry',
+    proto_extract := ['device_id', 'readings']
+)
+LIMIT 5;
+
+.print
+.print ========================================
+.print Test 19: Unnest repeated readings
+.print ========================================
+
+SELECT
+    device_id,
+    COUNT(*) as readings,
+    ROUND(AVG(r.kw), 3) as avg_kw
+FROM (
+    SELECT device_id, UNNEST(readings) as r
+    FROM nats_scan('telemetry_proto',
+        proto_file := 'test/proto/telemetry.proto',
+        proto_message := 'Telemetry',
+        proto_extract := ['device_id', 'readings']
+    )
+)
+GROUP BY device_id
+ORDER BY device_id;
+
+.print
+.print ========================================
+.print Test 20: Nested message as a STRUCT
+.print ========================================
+
+SELECT
+    device_id,
+    location.zone as zone,
+    location.building as building,
+    typeof(location) as location_type
+FROM nats_scan('telemetry_proto',
+    proto_file := 'test/proto/telemetry.proto',
+    proto_message := 'Telemetry',
+    proto_extract := ['device_id', 'location']
+)
+LIMIT 5;
+
+.print
+.print ========================================
+.print Test 21: Repeated scalar and map fields
+.print ========================================
+
+SELECT
+    device_id,
+    tags,
+    labels['rack'] as rack,
+    typeof(tags) as tags_type,
+    typeof(labels) as labels_type
+FROM nats_scan('telemetry_proto',
+    proto_file := 'test/proto/telemetry.proto',
+    proto_message := 'Telemetry',
+    proto_extract := ['device_id', 'tags', 'labels']
+)
+LIMIT 5;
+
 .print
 .print ========================================
 .print All tests completed successfully!
@@ -100,6 +100,42 @@ SELECT * FROM nats_scan('telemetry_proto',
     proto_extract := ['device_id']
 ) LIMIT 1;
 
+.print
+.print ========================================
+.print Test 9: File that is not a FileDescriptorSet
+.print Expected: Error message
+.print ========================================
+
+SELECT * FROM nats_scan('telemetry_proto',
+    proto_file := 'test/proto/check_stream.py',
+    proto_message := 'Telemetry',
+    proto_extract := ['device_id']
+) LIMIT 1;
+
+.print
+.print ========================================
+.print Test 10: Missing descriptor set file
+.print Expected: Error message
+.print ========================================
+
+SELECT * FROM nats_scan('telemetry_proto',
+    proto_file := 'test/proto/nonexistent.desc',
+    proto_message := 'Telemetry',
+    proto_extract := ['device_id']
+) LIMIT 1;
+
+.print
+.print ========================================
+.print Test 11: Navigating into a repeated field
+.print Expected: Error message
+.print ========================================
+
+SELECT * FROM nats_scan('telemetry_proto',
+    proto_file := 'test/proto/telemetry.proto',
+    proto_message := 'Telemetry',
+    proto_extract := ['readings.kw']
+) LIMIT 1;
+
 .print
 .print ========================================
 .print Error handling tests completed!
@@ -0,0 +1,148 @@
+-- Test suite for publishing with COPY ... TO (FORMAT nats)
+-- Prerequisites:
+--   1. NATS server running (docker-compose up -d)
+--   2. Streams created (scripts/setup-streams.sh), including the published stream
+--
+-- Each test publishes to its own subject under published.> and checks only the messages
+-- after the stream's last sequence before the COPY, so the suite can be run repeatedly.
+--
+-- Run with: duckdb -unsigned :memory: < test/sql/test_publish.sql
+
+LOAD 'build/release/nats_js.duckdb_extension';
+
+.print ========================================
+.print Test 1: Publish 10000 rows with per-row subjects
+.print ========================================
+
+SET VARIABLE before = (SELECT last_seq FROM nats_stream_info('published'));
+
+COPY (
+    SELECT 'published.bulk.' || (i % 4) as subject,
+           '{"i": ' || i || '}' as payload
+    FROM range(10000) t(i)
+) TO 'nats://localhost:4222' (FORMAT nats, STREAM 'published');
+
+-- Expected: 10000 messages, 2500 per subject
+SELECT subject, COUNT(*) as messages
+FROM nats_scan('published', start_seq := getvariable('before') + 1)
+WHERE subject LIKE 'published.bulk.%'
+GROUP BY subject
+ORDER BY subject;
+
+.print
+.print ========================================
+.print Test 2: Rows are published in order
+.print ========================================
+
+-- Expected: true (sequence order matches row order)
+SELECT bool_and(i = seq - getvariable('before') - 1) as in_order
+FROM (
+    SELECT seq, json_extract(payload::VARCHAR, '$.i')::BIGINT as i
+    FROM nats_scan('published', start_seq := getvariable('before') + 1)
+    WHERE subject LIKE 'published.bulk.%'
+);
+
+.print
+.print ========================================
+.print Test 3: Fixed subject and BLOB payloads
+.print ========================================
+
+SET VARIABLE before = (SELECT last_seq FROM nats_stream_info('published'));
+
+COPY (
+    SELECT ('\xDE\xAD' || i::VARCHAR)::BLOB as body
+    FROM range(100) t(i)
+) TO 'nats://localhost:4222' (FORMAT nats, SUBJECT 'published.fixed', PAYLOAD_COLUMN 'body');
+
+-- Expected: 100 messages on published.fixed, starting with the raw bytes
+SELECT COUNT(*) as messages, bool_and(payload[1:2] = '\xDE\xAD'::BLOB) as raw_bytes
+FROM nats_scan('published', start_seq := getvariable('before') + 1, subject := 'published.fixed');
+
+.print
+.print ========================================
+.print Test 4: Headers round trip
+.print ========================================
+
+SET VARIABLE before = (SELECT last_seq FROM nats_stream_info('published'));
+
+COPY (
+    SELECT 'published.headers' as subject,
+           'event ' || i as payload,
+           MAP {'Event-Id': [i::VARCHAR], 'Tag': ['a', 'b']} as hdrs
+    FROM range(10) t(i)
+) TO 'nats://localhost:4222' (FORMAT nats, HEADERS_COLUMN 'hdrs');
+
+-- Expected: 10 messages, each with its Event-Id and both Tag values
+SELECT COUNT(*) as messages,
+       bool_and(header_extract(headers, 'Event-Id') = regexp_extract(payload::VARCHAR, '\d+')) as ids_match,
+       bool_and(len(headers['Tag']) = 2) as multi_value
+FROM nats_scan('published', start_seq := getvariable('before') + 1, subject := 'published.headers');
+
+.print
+.print ========================================
+.print Test 5: Parallel publishing without insertion order
+.print ========================================
+
+SET preserve_insertion_order = false;
+SET VARIABLE before = (SELECT last_seq FROM nats_stream_info('published'));
+
+COPY (
+    SELECT 'published.parallel' as subject, i::VARCHAR as payload
+    FROM range(10000) t(i)
+) TO 'nats://localhost:4222' (FORMAT nats, MAX_PENDING 1024);
+
+-- Expected: 10000 messages, 10000 distinct payloads
+SELECT COUNT(*) as messages, COUNT(DISTINCT payload) as distinct_payloads
+FROM nats_scan('published', start_seq := getvariable('before') + 1, subject := 'published.parallel');
+
+SET preserve_insertion_order = true;
+
+.print
+.print ========================================
+.print Test 6: STREAM that does not store the subject
+.print Expected: Error message
+.print ========================================
+
+COPY (SELECT 'published.wrong' as subject, 'x' as payload)
+TO 'nats://localhost:4222' (FORMAT nats, STREAM 'telemetry');
+
+.print
+.print ========================================
+.print Test 7: NULL subject
+.print Expected: Error message
+.print ========================================
+
+COPY (SELECT NULL::VARCHAR as subject, 'x' as payload)
+TO 'nats://localhost:4222' (FORMAT nats);
+
+.print
+.print ========================================
+.print Test 8: Missing payload column
+.print Expected: Error message
+.print ========================================
+
+COPY (SELECT 'published.missing' as subject, 'x' as body)
+TO 'nats://localhost:4222' (FORMAT nats);
+
+.print
+.print ========================================
+.print Test 9: Payload column of the wrong type
+.print Expected: Error message
+.print ========================================
+
+COPY (SELECT 'published.type' as subject, 42 as payload)
+TO 'nats://localhost:4222' (FORMAT nats);
+
+.print
+.print ========================================
+.print Test 10: Unknown option
+.print Expected: Error message
+.print ========================================
+
+COPY (SELECT 'published.option' as subject, 'x' as payload)
+TO 'nats://localhost:4222' (FORMAT nats, BATCH_SIZE 10);
+
+.print
+.print ========================================
+.print All publish tests completed
+.print ========================================
@@ -0,0 +1,114 @@
+-- Test suite for reverse scans and ORDER BY seq LIMIT pushdown
+-- Prerequisites:
+--   1. NATS server running (docker-compose up -d)
+--   2. Streams created (scripts/setup-streams.sh)
+--   3. Test data published (python3 scripts/generate-telemetry.py)
+--
+-- Run with: duckdb -unsigned :memory: < test/sql/test_reverse_scan.sql
+
+LOAD 'build/release/nats_js.duckdb_extension';
+
+.print ========================================
+.print Test 1: reverse := true returns newest messages first
+.print ========================================
+
+-- Expected: the last 5 sequences of the stream, in descending order
+SELECT seq
+FROM nats_scan('telemetry', reverse := true)
+LIMIT 5;
+
+.print
+.print ========================================
+.print Test 2: Reverse scan returns every message once
+.print ========================================
+
+-- Expected: true, true
+SELECT
+    (SELECT COUNT(*) FROM nats_scan('telemetry', reverse := true)) =
+    (SELECT COUNT(*) FROM nats_scan('telemetry')) as counts_match,
+    (SELECT bool_and(prev IS NULL OR seq < prev) FROM (
+        SELECT seq, lag(seq) OVER () as prev
+        FROM nats_scan('telemetry', reverse := true)
+    )) as descending;
+
+.print
+.print ========================================
+.print Test 3: ORDER BY seq DESC LIMIT matches a full scan
+.print ========================================
+
+-- Expected: true
+SELECT
+    (SELECT list(seq ORDER BY seq DESC) FROM (SELECT seq FROM nats_scan('telemetry') ORDER BY seq DESC LIMIT 100)) =
+    (SELECT list(seq ORDER BY seq DESC) FROM (SELECT seq FROM nats_scan('telemetry') ORDER BY seq + 0 DESC LIMIT 100))
+    as same_rows;
+
+.print
+.print ========================================
+.print Test 4: ORDER BY seq LIMIT OFFSET matches a full scan
+.print ========================================
+
+-- Expected: true
+SELECT
+    (SELECT list(seq ORDER BY seq) FROM (SELECT seq FROM nats_scan('telemetry') ORDER BY seq LIMIT 10 OFFSET 2500)) =
+    (SELECT list(seq ORDER BY seq) FROM (SELECT seq FROM nats_scan('telemetry') ORDER BY seq + 0 LIMIT 10 OFFSET 2500))
+    as same_rows;
+
+.print
+.print ========================================
+.print Test 5: Pushdown in EXPLAIN
+.print ========================================
+
+-- Expected: Direction: reverse and Stream Limit: 100 on the NATS_SCAN operator
+EXPLAIN SELECT * FROM nats_scan('telemetry') ORDER BY seq DESC LIMIT 100;
+
+-- Expected: Direction: forward, no Stream Limit (the payload filter stays in the plan)
+EXPLAIN SELECT * FROM nats_scan('telemetry') WHERE payload::VARCHAR LIKE '%kw%' ORDER BY seq DESC LIMIT 100;
+
+.print
+.print ========================================
+.print Test 6: Latest messages of one subject
+.print ========================================
+
+-- Expected: 20 rows, all on the subject, newest first
+SELECT seq, subject, ts_nats
+FROM nats_scan('telemetry', subject := 'telemetry.dc1.power.pm5560.pm5560-001')
+ORDER BY seq DESC
+LIMIT 20;
+
+-- Expected: true
+SELECT
+    (SELECT max(seq) FROM nats_scan('telemetry', subject := 'telemetry.dc1.power.pm5560.pm5560-001')) =
+    (SELECT seq FROM nats_scan('telemetry', subject := 'telemetry.dc1.power.pm5560.pm5560-001')
+     ORDER BY seq DESC LIMIT 1) as newest_matches;
+
+.print
+.print ========================================
+.print Test 7: Top-N over several streams
+.print ========================================
+
+-- Expected: the 10 highest sequences over both streams, with their streams
+SELECT stream, seq
+FROM nats_scan(['telemetry', 'environmental'])
+ORDER BY seq DESC, stream
+LIMIT 10;
+
+.print
+.print ========================================
+.print Test 8: reverse with consumer mode
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('telemetry', mode := 'consumer', reverse := true);
+
+.print
+.print ========================================
+.print Test 9: reverse with follow
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('telemetry', follow := true, reverse := true);
+
+.print
+.print ========================================
+.print All reverse scan tests completed
+.print ========================================
@@ -0,0 +1,123 @@
+-- Test suite for scan counters (nats_scan_stats() and EXPLAIN ANALYZE)
+-- Prerequisites:
+--   1. NATS server running (docker-compose up -d)
+--   2. Streams created (scripts/setup-streams.sh)
+--   3. Test data published (python3 scripts/generate-telemetry.py)
+--
+-- A scan's counters are recorded when the scan finishes, so each test reads
+-- nats_scan_stats() in the statement after its scan.
+--
+-- Run with: duckdb -unsigned :memory: < test/sql/test_scan_stats.sql
+
+LOAD 'build/release/nats_js.duckdb_extension';
+
+.print ========================================
+.print Test 1: nats_scan_stats() is empty before any scan
+.print ========================================
+
+-- Expected: 0
+SELECT COUNT(*) as scans FROM nats_scan_stats();
+
+.print
+.print ========================================
+.print Test 2: Counters of a full scan
+.print ========================================
+
+SELECT COUNT(*) as messages, SUM(octet_length(payload)) as bytes FROM nats_scan('telemetry');
+
+-- Expected: scan_id 1 on telemetry in direct mode, rows and bytes_received matching Test 2,
+-- at least one round trip and no skipped messages
+SELECT scan_id, streams, mode, rows, bytes_received, round_trips > 0 as has_round_trips,
+    messages_received = rows as all_received, skipped_filter, skipped_gap
+FROM nats_scan_stats();
+
+-- Expected: true
+SELECT fetch_ms > 0 AND decode_ms >= 0 AND elapsed_ms > 0 as timed
+FROM nats_scan_stats()
+ORDER BY scan_id DESC
+LIMIT 1;
+
+.print
+.print ========================================
+.print Test 3: Batched direct gets need few round trips
+.print ========================================
+
+SELECT COUNT(*) as messages FROM nats_scan('telemetry', end_seq := 500);
+
+-- Expected: true (one round trip per batch of messages, not per message)
+SELECT round_trips < rows as batched
+FROM nats_scan_stats()
+ORDER BY scan_id DESC
+LIMIT 1;
+
+.print
+.print ========================================
+.print Test 4: Messages skipped by header filters
+.print ========================================
+
+SELECT COUNT(*) as messages
+FROM nats_scan('events', header_extract := ['Routing-Key'])
+WHERE Routing_Key = 'audit.eu';
+
+-- Expected: 50 rows, every other received message skipped by the filter
+SELECT rows, skipped_filter > 0 as skipped, rows + skipped_filter = messages_received as accounted
+FROM nats_scan_stats()
+ORDER BY scan_id DESC
+LIMIT 1;
+
+.print
+.print ========================================
+.print Test 5: Sequences skipped by gaps
+.print ========================================
+
+SELECT COUNT(*) as messages FROM nats_scan('sparse');
+
+-- Expected: 20 rows, 135 sequences skipped (deleted messages between seq 1 and 155)
+SELECT rows, skipped_gap
+FROM nats_scan_stats()
+ORDER BY scan_id DESC
+LIMIT 1;
+
+.print
+.print ========================================
+.print Test 6: Timestamp resolution probes
+.print ========================================
+
+SELECT COUNT(*) as messages
+FROM nats_scan('telemetry',
+    start_time := (current_timestamp - INTERVAL '30 minutes')::TIMESTAMP
+);
+
+-- Expected: at least one probe, counted as a round trip
+SELECT resolve_probes > 0 as probed, round_trips >= resolve_probes as counted
+FROM nats_scan_stats()
+ORDER BY scan_id DESC
+LIMIT 1;
+
+.print
+.print ========================================
+.print Test 7: Consumer and last modes
+.print ========================================
+
+SELECT COUNT(*) as messages FROM nats_scan('telemetry', mode := 'consumer', end_seq := 500);
+SELECT COUNT(*) as subjects FROM nats_scan('telemetry', mode := 'last');
+
+-- Expected: last and consumer, each with rows and round trips
+SELECT mode, rows > 0 as has_rows, round_trips > 0 as has_round_trips
+FROM nats_scan_stats()
+ORDER BY scan_id DESC
+LIMIT 2;
+
+.print
+.print ========================================
+.print Test 8: Counters in EXPLAIN ANALYZE
+.print ========================================
+
+-- Expected: Round Trips, Messages Received, Bytes Received, Skipped (Filter), Skipped (Gap),
+-- Fetch Time and Decode Time on the NATS_SCAN operator
+EXPLAIN ANALYZE SELECT COUNT(*) FROM nats_scan('sparse');
+
+.print
+.print ========================================
+.print All scan stats tests completed
+.print ========================================
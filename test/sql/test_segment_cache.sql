@@ -0,0 +1,101 @@
+-- Test suite for the local segment cache (nats_cache_directory)
+-- Prerequisites:
+--   1. NATS server running (docker-compose up -d)
+--   2. Streams created (scripts/setup-streams.sh)
+--   3. Test data published (python3 scripts/generate-telemetry.py)
+--
+-- Segments are written to /tmp/duckdb_nats_cache_test and kept after the run; every
+-- test passes whether or not the directory already holds segments from an earlier run.
+--
+-- Run with: duckdb -unsigned :memory: < test/sql/test_segment_cache.sql
+
+LOAD 'build/release/nats_js.duckdb_extension';
+
+-- Reference results read from the server without a cache
+CREATE TEMP TABLE uncached AS
+SELECT seq, subject, ts_nats, payload FROM nats_scan('telemetry');
+
+.print ========================================
+.print Test 1: A cached scan returns the same rows
+.print ========================================
+
+SET nats_cache_directory = '/tmp/duckdb_nats_cache_test';
+
+-- Expected: true
+SELECT
+    (SELECT COUNT(*) FROM nats_scan('telemetry')) = (SELECT COUNT(*) FROM uncached) as counts_match;
+
+.print
+.print ========================================
+.print Test 2: A repeated scan reads the cached segments
+.print ========================================
+
+-- Expected: 0 (no row differs from the uncached scan)
+SELECT COUNT(*) as differences FROM (
+    (SELECT seq, subject, ts_nats, payload FROM nats_scan('telemetry')
+     EXCEPT SELECT * FROM uncached)
+    UNION ALL
+    (SELECT * FROM uncached
+     EXCEPT SELECT seq, subject, ts_nats, payload FROM nats_scan('telemetry'))
+);
+
+-- Expected: true (segment files were written)
+SELECT COUNT(*) > 0 as has_segments FROM glob('/tmp/duckdb_nats_cache_test/*/*/*.seg');
+
+.print
+.print ========================================
+.print Test 3: Subject filters are cached separately
+.print ========================================
+
+-- Expected: true
+SELECT
+    (SELECT COUNT(*) FROM nats_scan('telemetry', subject := 'telemetry.*.power.>')) =
+    (SELECT COUNT(*) FROM uncached WHERE subject LIKE 'telemetry.%.power.%') as counts_match;
+
+-- Expected: true (run again from the cache)
+SELECT
+    (SELECT COUNT(*) FROM nats_scan('telemetry', subject := 'telemetry.*.power.>')) =
+    (SELECT COUNT(*) FROM uncached WHERE subject LIKE 'telemetry.%.power.%') as counts_match;
+
+.print
+.print ========================================
+.print Test 4: Partly cached ranges
+.print ========================================
+
+-- A small range of a stream not scanned yet, then a larger one around it
+-- Expected: 100
+SELECT COUNT(*) as messages FROM nats_scan('environmental', start_seq := 101, end_seq := 200);
+
+-- Expected: 300
+SELECT COUNT(*) as messages FROM nats_scan('environmental', end_seq := 300);
+
+-- Expected: 300, seq 1 to 300 without gaps (synchronous fetching)
+SELECT COUNT(*) as messages, MIN(seq) as first_seq, MAX(seq) as last_seq, COUNT(DISTINCT seq) as distinct_seqs
+FROM nats_scan('environmental', end_seq := 300, prefetch_bytes := 0);
+
+.print
+.print ========================================
+.print Test 5: Extracted JSON fields from the cache
+.print ========================================
+
+-- Expected: true
+SELECT
+    (SELECT COUNT(device_id) FROM nats_scan('telemetry', json_extract := ['device_id'])) =
+    (SELECT COUNT(*) FROM uncached WHERE json_extract_string(payload::VARCHAR, '$.device_id') IS NOT NULL)
+    as counts_match;
+
+.print
+.print ========================================
+.print Test 6: An empty directory setting disables the cache
+.print ========================================
+
+SET nats_cache_directory = '';
+
+-- Expected: true
+SELECT
+    (SELECT COUNT(*) FROM nats_scan('telemetry')) = (SELECT COUNT(*) FROM uncached) as counts_match;
+
+.print
+.print ========================================
+.print All segment cache tests completed
+.print ========================================
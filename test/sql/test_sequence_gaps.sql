@@ -0,0 +1,95 @@
+-- Test suite for scanning streams with deleted sequences
+-- Prerequisites:
+--   1. NATS server running (docker-compose up -d)
+--   2. Streams created (scripts/setup-streams.sh)
+--   3. Test data published (python3 scripts/generate-telemetry.py)
+--
+-- The sparse stream keeps one message per subject. 20 devices report in round 0,
+-- 15 of them report 9 more times, so only 20 of 155 sequences are live:
+-- seq 1, 5, 9, 13, 17 (round 0) and seq 141-155 (round 9).
+--
+-- Run with: duckdb -unsigned :memory: < test/sql/test_sequence_gaps.sql
+
+LOAD 'build/release/nats_js.duckdb_extension';
+
+.print ========================================
+.print Test 1: Only live messages are returned
+.print ========================================
+
+-- Expected: 20 messages, 20 subjects, seq 1 to 155
+SELECT COUNT(*) as total, COUNT(DISTINCT subject) as subjects, MIN(seq) as first_seq, MAX(seq) as last_seq
+FROM nats_scan('sparse');
+
+.print
+.print ========================================
+.print Test 2: Live messages before the gap
+.print ========================================
+
+-- Expected: seq 1, 5, 9, 13, 17
+SELECT seq, subject
+FROM nats_scan('sparse', end_seq := 140)
+ORDER BY seq;
+
+.print
+.print ========================================
+.print Test 3: Range starting inside a gap
+.print ========================================
+
+-- Expected: 15 messages, seq 141 to 155
+SELECT COUNT(*) as total, MIN(seq) as first_seq, MAX(seq) as last_seq
+FROM nats_scan('sparse', start_seq := 18);
+
+.print
+.print ========================================
+.print Test 4: Range entirely inside a gap
+.print ========================================
+
+-- Expected: 0 messages
+SELECT COUNT(*) as total
+FROM nats_scan('sparse', start_seq := 18, end_seq := 140);
+
+.print
+.print ========================================
+.print Test 5: Subject filter across the gap
+.print ========================================
+
+-- Expected: seq 1 (device 0 reported once in round 0)
+SELECT seq, subject, round
+FROM nats_scan('sparse', subject := 'sparse.device.0', json_extract := ['round']);
+
+-- Expected: seq 141 (device 1 reported in every round, the latest is round 9)
+SELECT seq, subject, round
+FROM nats_scan('sparse', subject := 'sparse.device.1', json_extract := ['round']);
+
+.print
+.print ========================================
+.print Test 6: Parallel scan over the gaps
+.print ========================================
+
+SET threads = 4;
+
+-- Expected: 20 messages, no duplicates
+SELECT COUNT(*) as total, COUNT(DISTINCT seq) as distinct_seqs
+FROM nats_scan('sparse');
+
+.print
+.print ========================================
+.print Test 7: Consumer mode matches direct get mode
+.print ========================================
+
+-- Expected: identical rows
+SELECT COUNT(*) as mismatches
+FROM (
+    (SELECT seq, subject FROM nats_scan('sparse')
+     EXCEPT
+     SELECT seq, subject FROM nats_scan('sparse', mode := 'consumer'))
+    UNION ALL
+    (SELECT seq, subject FROM nats_scan('sparse', mode := 'consumer')
+     EXCEPT
+     SELECT seq, subject FROM nats_scan('sparse'))
+);
+
+.print
+.print ========================================
+.print All sequence gap tests completed successfully!
+.print ========================================
@@ -195,7 +195,7 @@ FROM nats_scan('telemetry_proto',
     proto_file := 'test/proto/telemetry.proto',
     proto_message := 'Telemetry',
     proto_extract := ['device_id'],
-    subject := 'pm5560',
+    subject := 'telemetry_proto.*.power.pm5560.>',
     start_seq := 1,
     end_seq := 100
 )
@@ -3,6 +3,10 @@
 --   1. NATS server running (docker-compose up -d)
 --   2. Test data published with various subject patterns
 --
+-- Subject filters use NATS subject semantics: '*' matches exactly one token and
+-- '>' matches one or more trailing tokens. Filtering happens on the server; lists
+-- of filters are also matched on the client.
+--
 -- Run with: duckdb -unsigned :memory: < test/sql/test_subject_filtering.sql
 
 LOAD 'build/release/nats_js.duckdb_extension';
@@ -26,7 +30,7 @@ LIMIT 10;
 
 .print
 .print ========================================
-.print Test 2: Partial subject match (substring)
+.print Test 2: Single-token wildcard (*)
 .print ========================================
 
 SELECT DISTINCT
@@ -36,7 +40,7 @@ FROM nats_scan('telemetry_proto',
     proto_file := 'test/proto/telemetry.proto',
     proto_message := 'Telemetry',
     proto_extract := ['device_id'],
-    subject := 'zone-a'
+    subject := 'telemetry_proto.dc1.power.pm5560.*'
 )
 GROUP BY subject
 ORDER BY subject;
@@ -54,7 +58,7 @@ FROM nats_scan('telemetry_proto',
     proto_file := 'test/proto/telemetry.proto',
     proto_message := 'Telemetry',
     proto_extract := ['device_id'],
-    subject := 'pm5560'
+    subject := 'telemetry_proto.*.power.pm5560.>'
 )
 GROUP BY subject, device_id
 ORDER BY subject, device_id
@@ -86,7 +90,7 @@ FROM nats_scan('telemetry_proto',
     proto_file := 'test/proto/telemetry.proto',
     proto_message := 'Telemetry',
     proto_extract := ['device_id'],
-    subject := 'pm5560',
+    subject := 'telemetry_proto.*.power.pm5560.*',
     start_seq := 1,
     end_seq := 100
 )
@@ -106,7 +110,7 @@ FROM nats_scan('telemetry_proto',
     proto_file := 'test/proto/telemetry.proto',
     proto_message := 'Telemetry',
     proto_extract := ['device_id'],
-    subject := 'pm5560-001',
+    subject := 'telemetry_proto.*.power.pm5560.pm5560-001',
     start_time := (current_timestamp - INTERVAL '3 hours')::TIMESTAMP,
     end_time := (current_timestamp - INTERVAL '2 hours')::TIMESTAMP
 );
@@ -161,7 +165,7 @@ FROM nats_scan('telemetry_proto',
     proto_file := 'test/proto/telemetry.proto',
     proto_message := 'Telemetry',
     proto_extract := ['device_id', 'location.zone', 'metrics.kw'],
-    subject := 'dc1'
+    subject := 'telemetry_proto.dc1.>'
 )
 LIMIT 10;
 
@@ -177,7 +181,7 @@ SELECT
     temp_c::DOUBLE as temp_c
 FROM nats_scan('environmental',
     json_extract := ['device_id', 'location', 'temp_c'],
-    subject := 'temp'
+    subject := 'environmental.*.sensors.temp.>'
 )
 LIMIT 10;
 
@@ -196,7 +200,7 @@ FROM nats_scan('telemetry_proto',
     proto_file := 'test/proto/telemetry.proto',
     proto_message := 'Telemetry',
     proto_extract := ['metrics.kw'],
-    subject := 'pm5560'
+    subject := 'telemetry_proto.*.power.pm5560.>'
 )
 GROUP BY subject
 ORDER BY subject;
@@ -214,9 +218,112 @@ FROM nats_scan('telemetry_proto',
     proto_file := 'test/proto/telemetry.proto',
     proto_message := 'Telemetry',
     proto_extract := ['device_id'],
-    subject := 'power'
+    subject := 'telemetry_proto.*.power.>'
 );
 
+.print
+.print ========================================
+.print Test 13: Substrings are not wildcards
+.print ========================================
+
+-- Expected: 0 (no subject is exactly 'pm5560')
+SELECT COUNT(*) as substring_count
+FROM nats_scan('telemetry_proto', subject := 'pm5560');
+
+.print
+.print ========================================
+.print Test 14: '>' must be the last token
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('telemetry_proto', subject := 'telemetry_proto.>.power');
+
+.print
+.print ========================================
+.print Test 15: Wildcards must be whole tokens
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('telemetry_proto', subject := 'telemetry_proto.dc*.power.>');
+
+.print
+.print ========================================
+.print Test 16: List of subject filters
+.print ========================================
+
+-- Expected: pm5560-001 and pm5560-003 only, with the counts of the single-filter scans
+SELECT subject, COUNT(*) as messages
+FROM nats_scan('telemetry', subject := ['telemetry.dc1.power.pm5560.pm5560-001',
+                                        'telemetry.dc1.power.pm5560.pm5560-003'])
+GROUP BY subject
+ORDER BY subject;
+
+-- Expected: true
+SELECT
+    (SELECT COUNT(*) FROM nats_scan('telemetry', subject := ['telemetry.dc1.power.pm5560.pm5560-001',
+                                                             'telemetry.dc1.power.pm5560.pm5560-003'])) =
+    (SELECT COUNT(*) FROM nats_scan('telemetry', subject := 'telemetry.dc1.power.pm5560.pm5560-001')) +
+    (SELECT COUNT(*) FROM nats_scan('telemetry', subject := 'telemetry.dc1.power.pm5560.pm5560-003')) as counts_match;
+
+.print
+.print ========================================
+.print Test 17: Overlapping filters return each message once
+.print ========================================
+
+-- Expected: true
+SELECT
+    (SELECT COUNT(*) FROM nats_scan('telemetry', subject := ['telemetry.dc1.power.pm5560.pm5560-001',
+                                                             'telemetry.*.power.>'])) =
+    (SELECT COUNT(*) FROM nats_scan('telemetry', subject := 'telemetry.*.power.>')) as counts_match;
+
+.print
+.print ========================================
+.print Test 18: Filters of different shapes
+.print ========================================
+
+-- Expected: true (matched on the client against the whole list)
+SELECT
+    (SELECT COUNT(*) FROM nats_scan('telemetry', subject := ['telemetry.dc1.power.pm5560.pm5560-002',
+                                                             'telemetry.dc1.*.pm5560.pm5560-004',
+                                                             'telemetry.dc2.>'])) =
+    (SELECT COUNT(*) FROM nats_scan('telemetry', subject := 'telemetry.dc1.power.pm5560.pm5560-002')) +
+    (SELECT COUNT(*) FROM nats_scan('telemetry', subject := 'telemetry.dc1.power.pm5560.pm5560-004')) +
+    (SELECT COUNT(*) FROM nats_scan('telemetry', subject := 'telemetry.dc2.>')) as counts_match;
+
+-- Expected: true
+SELECT
+    (SELECT COUNT(*) FROM nats_scan('telemetry', subject := ['telemetry.dc1.power.pm5560.pm5560-005'],
+                                    mode := 'consumer')) =
+    (SELECT COUNT(*) FROM nats_scan('telemetry', subject := 'telemetry.dc1.power.pm5560.pm5560-005'))
+    as consumer_matches;
+
+.print
+.print ========================================
+.print Test 19: Subject column matches the per-subject counts
+.print ========================================
+
+-- Expected: 0 rows
+SELECT s.subject, s.messages, c.messages
+FROM (SELECT subject, COUNT(*) as messages FROM nats_scan('telemetry') GROUP BY subject) s
+FULL OUTER JOIN nats_subject_counts('telemetry') c ON s.subject = c.subject
+WHERE s.messages IS DISTINCT FROM c.messages;
+
+.print
+.print ========================================
+.print Test 20: Empty subject list
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('telemetry', subject := []::VARCHAR[]);
+
+.print
+.print ========================================
+.print Test 21: Invalid filter in a subject list
+.print Expected: Error message
+.print ========================================
+
+SELECT COUNT(*) FROM nats_scan('telemetry', subject := ['telemetry.>', 'telemetry.>.power']);
+
 .print
 .print ========================================
 .print All subject filtering tests completed successfully!
@@ -188,7 +188,7 @@ SELECT
 FROM nats_scan('telemetry',
     start_time := (current_timestamp - INTERVAL '3 hours')::TIMESTAMP,
     end_time := (current_timestamp - INTERVAL '2 hours')::TIMESTAMP,
-    subject := 'zone-a',
+    subject := 'telemetry.*.power.>',
     proto_file := 'test/proto/telemetry.proto',
     proto_message := 'Telemetry',
     proto_extract := ['device_id']
@@ -263,6 +263,18 @@ FROM nats_scan('telemetry',
     proto_extract := ['device_id']
 );
 
+.print
+.print ========================================
+.print Test 16: Resolved start matches the first message at or after start_time
+.print ========================================
+
+SELECT
+    (SELECT MIN(seq) FROM nats_scan('telemetry',
+        start_time := (current_timestamp - INTERVAL '90 minutes')::TIMESTAMP))
+    =
+    (SELECT MIN(seq) FROM nats_scan('telemetry')
+     WHERE ts_nats >= (current_timestamp - INTERVAL '90 minutes')::TIMESTAMP) as start_matches;
+
 .print
 .print ========================================
 .print All timestamp query tests completed successfully!